@@ -0,0 +1,159 @@
+#pragma once
+#include "circuit_component.h"
+#include "sequential_components.h"
+
+// Bus pins are drawn larger than single lines and labelled with their width
+void DrawComponentPins(wxDC& dc, const CircuitComponent& component);
+
+// Base class for combinational components working on whole bus values
+class BusComponent : public CircuitComponent {
+protected:
+    int width;
+
+    virtual void CreatePins() = 0;
+
+public:
+    static const int MIN_WIDTH = 1;
+    static const int MAX_WIDTH = 64;
+    static const int DEFAULT_WIDTH = 8;
+
+    BusComponent(const wxPoint& pos, const wxSize& sz, ComponentType t, int bits);
+
+    int GetDataWidth() const override { return width; }
+    void SetDataWidth(int bits) override;
+    virtual void ComputeOutputs() = 0;
+
+protected:
+    void DrawPins(wxDC& dc) const;
+};
+
+// Bus Splitter - fans a bus out into single lines, line 0 at the top
+class BusSplitter : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusSplitter(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// Bus Joiner - gathers single lines into a bus, line 0 at the top
+class BusJoiner : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusJoiner(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Adder - adds two buses plus carry in
+class BusAdder : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusAdder(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Multiplexer 4-to-1
+class BusMultiplexer4to1 : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusMultiplexer4to1(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Magnitude Comparator
+class BusComparator : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusComparator(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Subtractor - computes A - B - borrow in
+class BusSubtractor : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusSubtractor(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Multiplier - unsigned product split into low and high words
+class BusMultiplier : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusMultiplier(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Barrel Shifter - shifts left, or right logically or arithmetically
+class BusShifter : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    BusShifter(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+
+    // Width of the shift amount bus for a given data width
+    static int GetShiftWidth(int bits);
+};
+
+// N-bit ALU - operation selected by a 3-bit opcode bus
+class BusALU : public BusComponent {
+protected:
+    void CreatePins() override;
+
+public:
+    enum Opcode {
+        OP_ADD = 0,
+        OP_SUB = 1,
+        OP_AND = 2,
+        OP_OR = 3,
+        OP_XOR = 4,
+        OP_SHL = 5,
+        OP_SHR = 6,
+        OP_SLT = 7      // Signed less than, Y is 1 or 0
+    };
+
+    BusALU(const wxPoint& pos, int bits = DEFAULT_WIDTH);
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+};
+
+// N-bit Register - loads the D bus on the clock edge
+class BusRegister : public SequentialComponent {
+private:
+    int width;
+    BusValue stored;
+
+    void CreatePins();
+
+public:
+    BusRegister(const wxPoint& pos, int bits = BusComponent::DEFAULT_WIDTH);
+
+    void Draw(wxDC& dc) override;
+    void UpdateOnClock() override;
+    int GetDataWidth() const override { return width; }
+    void SetDataWidth(int bits) override;
+    BusValue GetOutput() const { return stored; }
+};
@@ -2,6 +2,12 @@
 #include <wx/wx.h>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include "../core/component_pool.h"
+
+class MemoryImage;
 
 // Enumeration for logic values
 enum class LogicValue {
@@ -56,26 +62,113 @@ enum class ComponentType {
     LED_MATRIX_8X8,
     LCD_DISPLAY,
     HEX_DISPLAY,
-    BINARY_DISPLAY
+    BINARY_DISPLAY,
+    // User-defined components
+    SUBCIRCUIT,
+    // Bus components
+    BUS_SPLITTER,
+    BUS_JOINER,
+    BUS_ADDER,
+    BUS_MULTIPLEXER_4TO1,
+    BUS_REGISTER,
+    BUS_COMPARATOR,
+    BUS_SUBTRACTOR,
+    BUS_MULTIPLIER,
+    BUS_SHIFTER,
+    BUS_ALU,
+    // Memory components
+    RAM,
+    ROM
+};
+
+// Value of a bus of up to 64 lines, bit i is line i
+struct BusValue {
+    uint64_t bits;
+    uint64_t undefined;     // Lines whose value is unknown
 };
 
-// Connection points (pins) for components
+// Mask of the lines used by a bus of the given width
+inline uint64_t BusMask(int width) {
+    return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+// Rise and fall times of a component's outputs in the timed simulation mode,
+// in abstract time units
+struct PropagationDelay {
+    uint32_t rise;
+    uint32_t fall;
+};
+
+// Connection points (pins) for components. Pins wider than one line carry
+// their value in bus instead of value. The simulator keeps its own dense
+// net values and only writes pins back for display and for blocks that
+// compute on their pins. Geometry stays out of the way: the offset is
+// relative to the component and becomes a canvas point only through
+// CircuitComponent::GetPinPosition.
 struct Pin {
-    wxPoint position;
     LogicValue value;
     bool isInput;
     bool isConnected;
+    int width;
+    BusValue bus;
+    wxPoint offset;
 
-    Pin(const wxPoint& pos, bool input)
-        : position(pos), value(LogicValue::UNDEFINED), isInput(input), isConnected(false) {}
+    Pin(const wxPoint& pinOffset, bool input, int busWidth = 1)
+        : value(LogicValue::UNDEFINED), isInput(input), isConnected(false),
+          width(busWidth), bus{ 0, BusMask(busWidth) }, offset(pinOffset) {}
 };
 
+typedef std::vector<Pin, PoolAllocator<Pin, ComponentPool::Region::PINS>> PinList;
+
+// Value of a pin as a bus; pins of one line carry it in value
+inline BusValue ReadBus(const Pin& pin) {
+    if (pin.width > 1) return pin.bus;
+    BusValue value = { pin.value == LogicValue::HIGH ? uint64_t(1) : 0,
+                       pin.value == LogicValue::UNDEFINED ? uint64_t(1) : 0 };
+    return value;
+}
+
+inline void WriteBus(Pin& pin, const BusValue& value) {
+    if (pin.width > 1) {
+        pin.bus = value;
+    } else {
+        pin.value = (value.undefined & 1) ? LogicValue::UNDEFINED
+                  : (value.bits & 1) ? LogicValue::HIGH : LogicValue::LOW;
+    }
+}
+
+// Placement of a component's layout on the canvas. Components lay out
+// their body and pins unrotated at unit scale; the transform scales that
+// layout, turns it clockwise by the rotation and shifts it so the turned
+// body's bounding box starts at the component position again. Layout
+// points are taken relative to the position.
+struct ComponentTransform {
+    double xx, xy;      // Canvas x of a layout point is dx + xx * x + xy * y
+    double yx, yy;
+    double dx, dy;
+
+    wxPoint Apply(const wxPoint& layout) const {
+        return wxPoint(static_cast<int>(std::lround(dx + xx * layout.x + xy * layout.y)),
+                       static_cast<int>(std::lround(dy + yx * layout.x + yy * layout.y)));
+    }
+};
+
+// Identifies a component for as long as it exists, across undo and redo,
+// saving and loading. The canvas hands IDs out; 0 means none yet.
+typedef uint32_t ComponentId;
+const ComponentId NO_COMPONENT_ID = 0;
+
+// Finds a placed component by ID; nullptr if it is not placed at the moment
+class CircuitComponent;
+typedef std::function<const CircuitComponent*(ComponentId)> ComponentLookup;
+
 // Base class for all circuit components
 class CircuitComponent {
 protected:
+    ComponentId id;
     wxPoint position;
     wxSize size;
-    std::vector<Pin> pins;
+    PinList pins;
     bool selected;
     ComponentType type;
 
@@ -84,20 +177,44 @@ protected:
     double scaleX;      // X-axis scale factor
     double scaleY;      // Y-axis scale factor
 
+    // Cached from position, size, rotation and scale by UpdateTransform
+    ComponentTransform transform;
+
+    // Overrides the type's default delay when customDelay is set
+    PropagationDelay delay;
+    bool customDelay;
+
+    // Call whenever the position, size, rotation or scale changes
+    void UpdateTransform();
+
 public:
     CircuitComponent(const wxPoint& pos, const wxSize& sz, ComponentType t);
     virtual ~CircuitComponent() {}
 
+    // Components live in the component pool, grouped by size
+    static void* operator new(size_t bytes) { return ComponentPool::Current()->Allocate(bytes); }
+    static void operator delete(void* block, size_t bytes) { ComponentPool::Free(block, bytes); }
+
     virtual void Draw(wxDC& dc) = 0;
     virtual void Move(const wxPoint& offset);
     virtual bool Contains(const wxPoint& pt) const;
     virtual Pin* GetPinAt(const wxPoint& pt);
 
+    // Canvas position of one of this component's pins
+    wxPoint GetPinPosition(const Pin& pin) const { return transform.Apply(pin.offset); }
+
+    // Position of a pin in the untransformed layout, where Draw works; the
+    // canvas applies the transform to the device context around Draw
+    wxPoint GetPinLayoutPosition(const Pin& pin) const { return position + pin.offset; }
+
+    ComponentId GetId() const { return id; }
+    void SetId(ComponentId newId) { id = newId; }
+
     void Select(bool sel) { selected = sel; }
     bool IsSelected() const { return selected; }
     ComponentType GetType() const { return type; }
-    const std::vector<Pin>& GetPins() const { return pins; }
-    std::vector<Pin>& GetPins() { return pins; }
+    const PinList& GetPins() const { return pins; }
+    PinList& GetPins() { return pins; }
     wxPoint GetPosition() const { return position; }
     wxSize GetSize() const { return size; }
 
@@ -112,4 +229,34 @@ public:
 
     // Get effective size after transformations
     virtual wxSize GetEffectiveSize() const;
+
+    // Canvas rectangle covered by the transformed body
+    wxRect GetBounds() const { return wxRect(position, GetEffectiveSize()); }
+
+    const ComponentTransform& GetTransform() const { return transform; }
+    bool IsTransformed() const { return rotation != 0.0 || scaleX != 1.0 || scaleY != 1.0; }
+
+    // Bus width of width-parametric components, 0 for fixed-width ones.
+    // Setting it recreates the pins, so only do it before wiring.
+    virtual int GetDataWidth() const { return 0; }
+    virtual void SetDataWidth(int bits) {}
+
+    // Contents and address width of RAM and ROM, nullptr and 0 for other
+    // components. Setting the address width recreates the pins as well.
+    virtual MemoryImage* GetMemory() { return nullptr; }
+    virtual const MemoryImage* GetMemory() const { return nullptr; }
+    virtual int GetAddressWidth() const { return 0; }
+    virtual void SetAddressWidth(int bits) {}
+
+    // Input count of gates with a configurable number of inputs, 0 for
+    // other components. Setting it recreates the pins as well.
+    virtual int GetInputCount() const { return 0; }
+    virtual void SetInputCount(int count) {}
+
+    // Propagation delay used by the timed simulation mode
+    PropagationDelay GetDelay() const { return customDelay ? delay : GetDefaultDelay(type); }
+    void SetDelay(const PropagationDelay& newDelay) { delay = newDelay; customDelay = true; }
+    void ResetDelay() { customDelay = false; }
+    bool HasCustomDelay() const { return customDelay; }
+    static PropagationDelay GetDefaultDelay(ComponentType type);
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <memory>
+#include "circuit_component.h"
+
+// Creates components by type without depending on the canvas, so documents,
+// the command line and the simulator can all build circuits
+class ComponentFactory {
+public:
+    // Returns nullptr for types that have no implementation and for
+    // subcircuits, which need a definition
+    static CircuitComponent* Create(ComponentType type, const wxPoint& pos);
+
+    // New component of the same type with the same ID, transform, label and
+    // state; the canvas gives it a new ID if the original is still placed
+    static std::unique_ptr<CircuitComponent> Clone(const CircuitComponent* component);
+
+    // Copy a whole circuit, reconnecting wires to the copied pins
+    static void CloneCircuit(const std::vector<std::unique_ptr<CircuitComponent>>& source,
+                             std::vector<std::unique_ptr<CircuitComponent>>& target);
+
+    // Stable names used in saved files
+    static wxString GetTypeName(ComponentType type);
+    static bool GetTypeFromName(const wxString& name, ComponentType& type);
+};
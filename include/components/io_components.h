@@ -5,17 +5,28 @@
 class InputSwitch : public CircuitComponent {
 private:
     bool state;
+    wxString label; // Name used by test vectors and truth tables
 
 public:
     InputSwitch(const wxPoint& pos);
     void Draw(wxDC& dc) override;
     void Toggle();
+    void SetState(bool on);
     LogicValue GetValue() const;
+
+    void SetLabel(const wxString& lbl) { label = lbl; }
+    const wxString& GetLabel() const { return label; }
 };
 
 // Output LED component
 class OutputLED : public CircuitComponent {
+private:
+    wxString label; // Name used by test vectors and truth tables
+
 public:
     OutputLED(const wxPoint& pos);
     void Draw(wxDC& dc) override;
+
+    void SetLabel(const wxString& lbl) { label = lbl; }
+    const wxString& GetLabel() const { return label; }
 };
\ No newline at end of file
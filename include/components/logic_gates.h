@@ -2,13 +2,29 @@
 #include "circuit_component.h"
 #include <string>
 
-// Base class for logic gates
+// Base class for logic gates. All gates but NOT take MIN_INPUTS to
+// MAX_INPUTS inputs, spread along the left edge, and the output pin
+// always comes last.
 class LogicGate : public CircuitComponent {
 protected:
     std::string label;
+    int inputCount;
+
+    void CreatePins();
+
+    // Input values packed one bit per input, input i in bit i
+    BusValue ReadInputs() const;
 
 public:
-    LogicGate(const wxPoint& pos, const wxSize& sz, ComponentType t, const std::string& lbl);
+    static const int MIN_INPUTS = 2;
+    static const int MAX_INPUTS = 64;
+    static const int DEFAULT_INPUTS = 2;
+
+    LogicGate(const wxPoint& pos, const wxSize& sz, ComponentType t, const std::string& lbl,
+              int inputs = DEFAULT_INPUTS);
+
+    int GetInputCount() const override { return inputCount; }
+    void SetInputCount(int count) override;
     virtual LogicValue Evaluate() = 0;
 };
 
@@ -32,6 +48,8 @@ public:
 class NotGate : public LogicGate {
 public:
     NotGate(const wxPoint& pos);
+    int GetInputCount() const override { return 0; }
+    void SetInputCount(int count) override {}
     void Draw(wxDC& dc) override;
     LogicValue Evaluate() override;
 };
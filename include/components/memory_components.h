@@ -0,0 +1,49 @@
+#pragma once
+#include "bus_components.h"
+#include "sequential_components.h"
+#include "../core/memory_image.h"
+
+// RAM - writes D to the addressed word on the clock edge while WE is high.
+// Q always shows the addressed word.
+class RAM : public SequentialComponent {
+private:
+    MemoryImage memory;
+
+    void CreatePins();
+
+public:
+    RAM(const wxPoint& pos, int addressBits = MemoryImage::DEFAULT_ADDRESS_WIDTH,
+        int dataBits = BusComponent::DEFAULT_WIDTH);
+
+    void Draw(wxDC& dc) override;
+    void UpdateOnClock() override;
+
+    int GetDataWidth() const override { return memory.GetDataWidth(); }
+    void SetDataWidth(int bits) override;
+    int GetAddressWidth() const override { return memory.GetAddressWidth(); }
+    void SetAddressWidth(int bits) override;
+    MemoryImage* GetMemory() override { return &memory; }
+    const MemoryImage* GetMemory() const override { return &memory; }
+};
+
+// ROM - Q shows the addressed word of contents loaded from a file
+class ROM : public BusComponent {
+private:
+    MemoryImage memory;
+
+protected:
+    void CreatePins() override;
+
+public:
+    ROM(const wxPoint& pos, int addressBits = MemoryImage::DEFAULT_ADDRESS_WIDTH,
+        int dataBits = DEFAULT_WIDTH);
+
+    void Draw(wxDC& dc) override;
+    void ComputeOutputs() override;
+
+    void SetDataWidth(int bits) override;
+    int GetAddressWidth() const override { return memory.GetAddressWidth(); }
+    void SetAddressWidth(int bits) override;
+    MemoryImage* GetMemory() override { return &memory; }
+    const MemoryImage* GetMemory() const override { return &memory; }
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include "circuit_component.h"
+#include <vector>
+#include <memory>
+
+class InputSwitch;
+class OutputLED;
+
+// A saved circuit used as a component. Its input switches become the input
+// pins and its output LEDs the output pins, each ordered top to bottom.
+// One definition is shared by every instance; the components inside are
+// never drawn or edited through an instance, only flattened by the netlist.
+class SubcircuitDefinition {
+private:
+    wxString name;
+    wxString filepath;
+    std::vector<std::unique_ptr<CircuitComponent>> components;
+    std::vector<const InputSwitch*> inputPorts;
+    std::vector<const OutputLED*> outputPorts;
+
+public:
+    SubcircuitDefinition(const wxString& definitionName, const wxString& path,
+                         std::vector<std::unique_ptr<CircuitComponent>> circuit);
+
+    const wxString& GetName() const { return name; }
+    const wxString& GetFilePath() const { return filepath; }
+    const std::vector<std::unique_ptr<CircuitComponent>>& GetComponents() const { return components; }
+
+    size_t GetInputCount() const { return inputPorts.size(); }
+    size_t GetOutputCount() const { return outputPorts.size(); }
+    const InputSwitch* GetInputPort(size_t index) const { return inputPorts[index]; }
+    const OutputLED* GetOutputPort(size_t index) const { return outputPorts[index]; }
+    wxString GetInputName(size_t index) const;
+    wxString GetOutputName(size_t index) const;
+};
+
+// Instance of a shared definition
+class SubcircuitComponent : public CircuitComponent {
+private:
+    std::shared_ptr<const SubcircuitDefinition> definition;
+
+public:
+    SubcircuitComponent(const wxPoint& pos, std::shared_ptr<const SubcircuitDefinition> def);
+
+    void Draw(wxDC& dc) override;
+
+    const std::shared_ptr<const SubcircuitDefinition>& GetDefinition() const { return definition; }
+};
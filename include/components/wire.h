@@ -2,16 +2,20 @@
 #include "circuit_component.h"
 #include <vector>
 
+// Route of a wire, its end pins first and last once connected
+typedef std::vector<wxPoint, PoolAllocator<wxPoint>> WireRoute;
+
 // Wire for connecting components
 class Wire : public CircuitComponent {
 private:
     Pin* startPin;
     Pin* endPin;
-    std::vector<wxPoint> points;
+    WireRoute points;
 
 public:
-    Wire(Pin* start);
-    void SetEndPin(Pin* end);
+    // Pins do not know where they are, so their canvas positions come along
+    Wire(Pin* start, const wxPoint& startPosition);
+    void SetEndPin(Pin* end, const wxPoint& endPosition);
     void AddPoint(const wxPoint& pt);
     void Draw(wxDC& dc) override;
     bool Contains(const wxPoint& pt) const override;
@@ -19,4 +23,5 @@ public:
 
     Pin* GetStartPin() const { return startPin; }
     Pin* GetEndPin() const { return endPin; }
+    const WireRoute& GetPoints() const { return points; }
 };
\ No newline at end of file
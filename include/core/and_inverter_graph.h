@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// And-inverter graph with structural hashing. Node 0 is constant false and
+// every other node is an input or a two-input AND. Edges are literals:
+// twice the node index, plus one when the edge is complemented. Asking for
+// an AND that already exists returns the existing node, and trivial cases
+// (constants, equal or opposite fanins) never create one, so identical
+// logic built twice collapses into the same literal.
+class AndInverterGraph {
+public:
+    static const uint32_t FALSE_LITERAL = 0;
+    static const uint32_t TRUE_LITERAL = 1;
+    static const uint32_t NO_FANIN = 0xFFFFFFFF;
+
+    struct Node {
+        uint32_t fanin0;    // Smaller literal; NO_FANIN for inputs and the constant
+        uint32_t fanin1;
+    };
+
+    static uint32_t Not(uint32_t literal) { return literal ^ 1; }
+    static uint32_t NodeOf(uint32_t literal) { return literal >> 1; }
+    static bool IsComplemented(uint32_t literal) { return (literal & 1) != 0; }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<uint32_t> inputs;                   // Input nodes in creation order
+    std::unordered_map<uint64_t, uint32_t> strash;  // Fanin pair to AND node
+
+public:
+    AndInverterGraph();
+    void Clear();
+
+    uint32_t AddInput();    // Literal of a new input
+    uint32_t And(uint32_t a, uint32_t b);
+    uint32_t Or(uint32_t a, uint32_t b) { return Not(And(Not(a), Not(b))); }
+    uint32_t Xor(uint32_t a, uint32_t b);
+    uint32_t Mux(uint32_t select, uint32_t whenHigh, uint32_t whenLow);
+
+    size_t GetNodeCount() const { return nodes.size(); }
+    size_t GetAndCount() const { return nodes.size() - inputs.size() - 1; }
+    const Node& GetNode(size_t index) const { return nodes[index]; }
+    bool IsAnd(size_t index) const { return nodes[index].fanin0 != NO_FANIN; }
+    const std::vector<uint32_t>& GetInputs() const { return inputs; }
+};
@@ -9,14 +9,23 @@
 class CircuitCanvas;
 class Wire;
 
+// End of a wire in the saved form: a component and the number of its pin.
+// Files number components in file order, undo records use their IDs.
+struct PinLocation {
+    long component;
+    long pin;
+};
+
 // Circuit document class for managing circuit data and file operations
 class CircuitDocument {
 private:
     wxString filename;
     wxString title;
     bool modified;
+    ComponentPool::Owner pool;  // Holds the components, so it goes last
     std::vector<std::unique_ptr<CircuitComponent>> components;
     std::map<wxString, wxString> properties;
+    wxString lastError;
 
 public:
     CircuitDocument();
@@ -26,6 +35,7 @@ public:
     bool LoadFromFile(const wxString& filepath);
     bool SaveToFile(const wxString& filepath);
     bool SaveAs(const wxString& filepath);
+    const wxString& GetLastError() const { return lastError; }
 
     // Document properties
     const wxString& GetFilename() const { return filename; }
@@ -38,6 +48,7 @@ public:
     void RemoveComponent(CircuitComponent* component);
     void ClearComponents();
     const std::vector<std::unique_ptr<CircuitComponent>>& GetComponents() const { return components; }
+    std::vector<std::unique_ptr<CircuitComponent>> ReleaseComponents();
 
     // Document operations
     void NewDocument();
@@ -51,15 +62,34 @@ public:
     wxString SerializeToJSON() const;
     bool DeserializeFromJSON(const wxString& jsonData);
 
+    // Single lines of the saved form, shared with the undo history. Memory
+    // lines name the file the contents came from; readers that keep the
+    // contents themselves pass loadContents = false.
+    static wxString SerializeComponent(const CircuitComponent& component);
+    static std::unique_ptr<CircuitComponent> DeserializeComponent(const wxString& line, wxString& error,
+                                                                  bool loadContents = true);
+    static wxString SerializeWire(const Wire& wire, const PinLocation& from, const PinLocation& to);
+    static bool ReadWireEnds(const wxString& line, PinLocation& from, PinLocation& to);
+    // The wire between two pins already found from its ends
+    static std::unique_ptr<Wire> DeserializeWire(const wxString& line, Pin* startPin, const wxPoint& startPos,
+                                                 Pin* endPin, const wxPoint& endPos);
+
     // Canvas integration
     void LoadToCanvas(CircuitCanvas* canvas);
     void SaveFromCanvas(CircuitCanvas* canvas);
 
 private:
     // Helper functions for JSON serialization
-    std::unique_ptr<CircuitComponent> CreateComponentFromType(ComponentType type, const wxPoint& pos) const;
+    static std::unique_ptr<CircuitComponent> CreateComponentFromType(ComponentType type, const wxPoint& pos);
     wxString LogicValueToString(LogicValue value) const;
     LogicValue LogicValueFromString(const wxString& str) const;
+
+    // Field helpers for the line based reader
+    static wxString EscapeString(const wxString& str);
+    static wxString ReadStringField(const wxString& line, const wxString& key);
+    static double ReadNumberField(const wxString& line, const wxString& key, double defaultValue = 0.0);
+    static std::vector<long> ReadNumberArray(const wxString& line, const wxString& key);
+    static Pin* GetPinAt(const std::vector<CircuitComponent*>& placed, long component, long pin);
 };
 
 // Document manager for handling multiple documents and recent files
@@ -0,0 +1,382 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <cstdint>
+#include "../components/circuit_component.h"
+
+class SubcircuitComponent;
+class SubcircuitDefinition;
+class SubcircuitModel;
+class NetlistCompiler;
+
+// Compiled, UI-independent form of a circuit used for headless simulation.
+// Pins joined by wires are merged into nets whose values live in one dense
+// array. Components become nodes that read and drive net indices, ordered by
+// logic level. Settling is event driven, so only the fan-out of nets that
+// actually changed is re-evaluated between two input vectors.
+//
+// Subcircuit instances are flattened: the components of their shared
+// definition become nodes of this netlist, with the instance pins merged
+// into the nets of the definition's switches and LEDs. Instances of pure
+// combinational definitions are instead evaluated as single nodes backed by
+// a per-definition model that memoizes outputs by input vector.
+//
+// Nets wired to bus pins are up to 64 lines wide and hold one packed
+// BusValue, so a bus moves through the netlist as a single event.
+//
+// An optional optimization pass after compiling folds gates with constant
+// outputs, replaces buffers and double inversions by their inputs, merges
+// gates computing the same function of the same nets and drops gates whose
+// outputs nobody reads. Removed gates stay in the node list with their pins
+// mapped to the equivalent nets, so pin lookups and displays still work.
+//
+// In timed mode outputs change only after their component's rise or fall
+// delay. Pending changes wait on a timing wheel with one slot per time unit;
+// changes further ahead than one turn of the wheel wait in a far list that
+// is swept into the wheel as time reaches them. Delays are transport
+// delays, so short pulses and glitches propagate instead of being filtered.
+class CircuitNetlist {
+public:
+    // How a node is evaluated
+    enum class NodeOp : uint8_t {
+        SOURCE,         // Input switches and clocks, driven from outside
+        SINK,           // LEDs and displays, never evaluated
+        AND,
+        OR,
+        NOT,
+        NAND,
+        NOR,
+        XOR,
+        XNOR,
+        ARITHMETIC,     // ArithmeticComponent::ComputeOutputs
+        DECODER_3TO8,
+        BCD_TO_7SEGMENT,
+        PRIORITY_ENCODER_8TO3,
+        SEQUENTIAL,     // SequentialComponent::UpdateOnClock
+        BUS,            // BusComponent::ComputeOutputs
+        SUBCIRCUIT,     // Instance boundary, only shows the values of its pins
+        SUBCIRCUIT_MODEL, // Whole instance evaluated through its definition's model
+        REMOVED         // Gate taken out by the optimizer, never evaluated
+    };
+
+    struct Node {
+        CircuitComponent* component;
+        NodeOp op;
+        uint32_t level;
+        uint32_t firstInput;    // Range in inputNets
+        uint32_t inputCount;
+        uint32_t firstOutput;   // Range in outputNets
+        uint32_t outputCount;
+        uint32_t instance;      // Subcircuit instance it was flattened from, 0 for the top level
+        uint32_t model;         // Index in models for SUBCIRCUIT_MODEL nodes
+        PropagationDelay delay; // Used in timed mode
+    };
+
+    // Flattened subcircuit instance; instance 0 is the top level circuit
+    struct Instance {
+        uint32_t parent;
+        const SubcircuitComponent* component;
+    };
+
+    // Condition checked whenever its net changes while settling
+    struct Watchpoint {
+        enum class Kind : uint8_t {
+            CHANGES,
+            GOES_HIGH,  // Single lines only
+            GOES_LOW,   // Single lines only
+            EQUALS
+        };
+        uint32_t net;
+        Kind kind;
+        BusValue value;     // For EQUALS
+        uint32_t tag;       // Caller's id, reported with the hit
+    };
+
+    // Gates taken out by the last optimization pass
+    struct OptimizationStats {
+        size_t constantGates;   // Output folded to a constant
+        size_t bufferGates;     // Buffers and double inversions, replaced by their input
+        size_t mergedGates;     // Same function of the same nets as another gate
+        size_t deadGates;       // Output read by nothing
+
+        size_t Total() const { return constantGates + bufferGates + mergedGates + deadGates; }
+    };
+
+    static const uint32_t NO_NET = 0xFFFFFFFF;
+    static const uint32_t NO_MODEL = 0xFFFFFFFF;
+    static const uint32_t WHEEL_SLOTS = 1024;   // Power of two
+
+    // Values of one net in 64 independent simulations, one per bit lane
+    struct LaneWord {
+        uint64_t high;
+        uint64_t undefined;
+    };
+
+    // Pin held at a value in some lanes of a parallel pass, used to inject
+    // faults. Input forces are seen by their own node only.
+    struct LaneForce {
+        uint32_t node;
+        uint32_t pin;       // Input or output index of the node
+        bool output;
+        uint64_t lanes;     // Lanes the force applies to
+        uint64_t high;      // Value in those lanes
+    };
+
+private:
+    std::vector<Node> nodes;
+    std::unordered_map<const CircuitComponent*, uint32_t> nodeIndex;    // First node of each component
+    std::vector<uint32_t> inputNets;    // Net read by each input pin, in pin order
+    std::vector<uint32_t> outputNets;   // Net driven by each output pin, in pin order
+    std::vector<LogicValue> netValues;
+    std::vector<uint8_t> netWidths;
+    std::vector<BusValue> busValues;    // Values of bus nets, empty without buses
+    bool hasBuses;
+    size_t widthConflicts;              // Nets joining pins of different widths
+
+    // Instances, and the copies of stateful components each instance needs
+    // because the definitions themselves are shared
+    std::vector<Instance> instances;
+    std::vector<std::unique_ptr<CircuitComponent>> instanceState;
+
+    // Models of combinational definitions. They survive rebuilds so their
+    // caches stay warm while the circuit is edited.
+    std::vector<std::unique_ptr<SubcircuitModel>> models;
+    std::unordered_map<const SubcircuitDefinition*, uint32_t> modelIndex;
+    std::set<const SubcircuitDefinition*> flattenedDefinitions;  // Checked this build and not eligible
+    bool cachingEnabled;
+    size_t cacheEntries;
+    size_t maxTableInputs;
+
+    // Optimization pass, and the nets it added to hold folded constants
+    bool optimizing;
+    OptimizationStats optimizationStats;
+    std::vector<std::pair<uint32_t, LogicValue>> constantNets;
+
+    // Nodes reading each net (CSR layout)
+    std::vector<uint32_t> fanoutOffsets;
+    std::vector<uint32_t> fanoutNodes;
+
+    // Evaluated nodes sorted by level, then operation and input count, for full passes
+    std::vector<uint32_t> levelOrder;
+    bool hasLoops;
+
+    // Full parallel passes run the level order in batches of gates with the
+    // same operation and input count, each through a kernel specialized for
+    // both. Other nodes form batches of one without a kernel.
+    typedef void (*GateKernel)(const uint32_t* nets, uint32_t count, uint32_t arity, LaneWord* words);
+    struct GateBatch {
+        GateKernel kernel;
+        uint32_t arity;     // Inputs per gate
+        uint32_t count;
+        uint32_t first;     // Offset in batchNets, or the node of a batch without a kernel
+    };
+    std::vector<GateBatch> gateBatches;
+    std::vector<uint32_t> batchNets;    // Each gate's input nets followed by its output net
+
+    // Generated native code for full parallel passes, built in the background
+    bool nativeCode;
+    std::unique_ptr<NetlistCompiler> compiler;
+
+    // Named inputs and outputs
+    std::vector<uint32_t> inputNodes;   // InputSwitch nodes
+    std::vector<uint32_t> outputNodes;  // OutputLED nodes
+    std::vector<uint32_t> clockNets;    // Driven by clock generators, also inside subcircuits
+
+    // Watchpoints, looked up only when a net with its flag set changes
+    std::vector<Watchpoint> watchpoints;
+    std::vector<uint8_t> netWatched;
+    std::vector<uint32_t> watchpointHits;   // Tags of the watchpoints that fired
+
+    // Parallel passes with forced pins
+    std::vector<uint32_t> nodeForces;   // First force of each node plus one, 0 for none
+    std::vector<std::pair<uint32_t, LaneWord>> forcedInputs;   // Net words to restore after one node
+    std::vector<std::pair<uint32_t, LaneWord>> laneChanges;    // Net words to restore after the pass
+
+    // Output change waiting for its delay in timed mode
+    struct TimedEvent {
+        uint64_t time;
+        uint32_t net;
+        LogicValue value;
+        BusValue bus;       // Value of bus nets
+    };
+
+    // Timing wheel; projected values are what the nets will hold once every
+    // pending change has happened, so unchanged outputs schedule nothing
+    bool timed;
+    uint64_t currentTime;
+    std::vector<std::vector<TimedEvent>> wheel;
+    std::vector<TimedEvent> wheelScratch;
+    std::vector<TimedEvent> farEvents;
+    size_t wheelCount;
+    std::vector<LogicValue> projectedValues;
+    std::vector<BusValue> projectedBus;
+
+    // Nets changing more than once in one settle
+    std::vector<uint32_t> netChangeStamp;
+    uint32_t settleStamp;
+    size_t glitchCount;
+
+    // Event queue, one bucket per level
+    std::vector<std::vector<uint32_t>> levelQueues;
+    std::vector<uint32_t> levelScratch;
+    std::vector<uint8_t> queued;
+    size_t pendingCount;
+    size_t scanLevel;
+    size_t evaluationLimit;
+    bool oscillating;
+
+public:
+    CircuitNetlist();
+    ~CircuitNetlist();
+
+    // Evaluate instances of combinational definitions through memoizing
+    // models with an LRU of cacheEntries input vectors per definition.
+    // Definitions with up to maxTableInputs inputs get a full lookup table
+    // at compile time. Takes effect on the next Build and is skipped in
+    // timed mode, which needs the delays of the gates inside.
+    void SetSubcircuitCaching(bool enabled, size_t cacheEntries = 4096, size_t maxTableInputs = 16);
+    bool IsSubcircuitCachingEnabled() const { return cachingEnabled; }
+    size_t GetModelCount() const { return models.size(); }
+    const SubcircuitModel& GetModel(size_t index) const { return *models[index]; }
+
+    // Run the optimization pass after compiling. Takes effect on the next
+    // Build and is skipped in timed mode, where every gate has a delay.
+    void SetOptimization(bool enabled) { optimizing = enabled; }
+    bool IsOptimizationEnabled() const { return optimizing; }
+    const OptimizationStats& GetOptimizationStats() const { return optimizationStats; }
+
+    // Compile the editor model. Component pointers are kept for evaluating
+    // blocks without a native kernel, so the components and the subcircuit
+    // definitions they use must outlive the netlist.
+    void Build(const std::vector<std::unique_ptr<CircuitComponent>>& components);
+    void Clear();
+
+    size_t GetNodeCount() const { return nodes.size(); }
+    size_t GetNetCount() const { return netValues.size(); }
+    const Node& GetNode(size_t index) const { return nodes[index]; }
+    int FindNode(const CircuitComponent* component) const;
+    size_t GetInstanceCount() const { return instances.size(); }
+    const Instance& GetInstance(size_t index) const { return instances[index]; }
+    const std::vector<uint32_t>& GetLevelOrder() const { return levelOrder; }  // Evaluated nodes by level
+    static bool IsGate(NodeOp op) { return op >= NodeOp::AND && op <= NodeOp::XNOR; }
+    bool HasLoops() const { return hasLoops; }
+    wxString DescribeNode(size_t node) const;   // Type and label, for reports
+
+    // Net access
+    LogicValue GetNetValue(size_t net) const { return netValues[net]; }
+    void SetNetValue(size_t net, LogicValue value);
+    int GetNetWidth(size_t net) const { return netWidths[net]; }
+    BusValue GetBusValue(size_t net) const { return busValues[net]; }
+    void SetBusValue(size_t net, BusValue value);
+    BusValue ReadNet(size_t net) const;     // Any net as a bus, single lines in bit 0
+    bool HasBuses() const { return hasBuses; }
+    size_t GetWidthConflictCount() const { return widthConflicts; }
+    uint32_t GetInputNet(size_t node, size_t input) const;
+    uint32_t GetOutputNet(size_t node, size_t output) const;
+    uint32_t FindPinNet(const CircuitComponent* component, size_t pinIndex) const;  // Top level components only
+
+    // Named switches and LEDs
+    const std::vector<uint32_t>& GetInputNodes() const { return inputNodes; }
+    const std::vector<uint32_t>& GetOutputNodes() const { return outputNodes; }
+    int FindInput(const wxString& label) const;
+    int FindOutput(const wxString& label) const;
+    void SetInputValue(size_t node, LogicValue value);
+    LogicValue GetOutputValue(size_t node) const;
+    const std::vector<uint32_t>& GetClockNets() const { return clockNets; }
+
+    // Watchpoints are dropped by Build since nets are renumbered
+    void AddWatchpoint(const Watchpoint& watchpoint);
+    void ClearWatchpoints();
+    bool HasWatchpointHits() const { return !watchpointHits.empty(); }
+    const std::vector<uint32_t>& GetWatchpointHits() const { return watchpointHits; }
+    void ClearWatchpointHits() { watchpointHits.clear(); }
+
+    // Simulation
+    void Reset();       // Undefine all nets, take sources from the components and evaluate everything
+    void UpdateSources(); // Take changed switch and source values from the components
+    bool Settle();      // Returns false if the circuit did not stabilize
+    bool IsOscillating() const { return oscillating; }
+
+    // Timed mode; takes effect on the next Build, which then flattens
+    // subcircuits and skips optimization. Settle then advances time until
+    // no change is pending.
+    void SetTimedMode(bool enabled);
+    bool IsTimedMode() const { return timed; }
+    uint64_t GetTime() const { return currentTime; }
+    size_t GetGlitchCount() const { return glitchCount; }  // Extra net transitions in the last timed settle
+    void WriteBack() const; // Copy net values into the components' pins for display
+
+    // Bit-parallel simulation of combinational circuits. The caller sets the
+    // words of the input switch nets after ResetParallel, then one pass in
+    // level order computes every other net for all 64 lanes. Lanes are
+    // single lines, so circuits with buses are not supported.
+    bool IsCombinational() const;
+    void ResetParallel(std::vector<LaneWord>& words) const;
+    void EvaluateParallel(std::vector<LaneWord>& words);
+
+    // Run full passes as straight-line native code once the system compiler
+    // has built it, interpreting until then. Takes effect on the next Build;
+    // circuits NetlistCompiler cannot handle are always interpreted.
+    void SetNativeCode(bool enabled) { nativeCode = enabled; }
+    bool IsNativeCodeEnabled() const { return nativeCode; }
+    bool IsNativeCodeReady() const;
+    bool WaitForNativeCode(wxString& error);   // Blocks until built; false with the reason if it was not
+
+    // A single node of a pass, for tabulating what a block computes
+    void EvaluateNodeParallel(size_t node, std::vector<LaneWord>& words) { EvaluateNodeParallel(nodes[node], words); }
+
+    // Pins forced in some lanes on top of a finished pass. Only the fan-out
+    // cones of the forced pins are evaluated, through the settle queue, so
+    // no settle may be pending. Forces must be grouped by node; sink inputs
+    // are not evaluated, so forcing them has no effect. RestoreParallel
+    // puts back the words of the finished pass.
+    void EvaluateParallel(std::vector<LaneWord>& words, const std::vector<LaneForce>& forces);
+    void RestoreParallel(std::vector<LaneWord>& words);
+
+private:
+    // Pin numbering while building
+    struct PlacedComponent {
+        CircuitComponent* component;
+        uint32_t instance;
+        uint32_t firstPin;
+        uint32_t model;
+    };
+    uint32_t Flatten(const std::vector<std::unique_ptr<CircuitComponent>>& components, uint32_t instance,
+                     const SubcircuitDefinition* definition, std::vector<PlacedComponent>& placed,
+                     std::vector<std::pair<uint32_t, uint32_t>>& joins, uint32_t pinCount,
+                     std::vector<uint32_t>& portPins);
+    uint32_t FindModel(const std::shared_ptr<const SubcircuitDefinition>& definition);
+    void BuildFanout();
+    void BuildBatches();
+    static GateKernel SelectGateKernel(NodeOp op, uint32_t arity);
+    void Optimize();
+    uint32_t AddConstantNet(LogicValue value);
+
+    void DriveNet(uint32_t net, LogicValue value);
+    void DriveBus(uint32_t net, BusValue value);
+    void DriveOutput(const Node& node, uint32_t net, LogicValue value);
+    void DriveOutputBus(const Node& node, uint32_t net, BusValue value);
+    void ScheduleEvent(const TimedEvent& event);
+    bool AdvanceTime();
+    void ApplyEvent(const TimedEvent& event);
+    void ClearTimedEvents();
+    bool EvaluateQueued(size_t& evaluations);
+    void CheckWatchpoints(uint32_t net);
+    void ScheduleFanout(uint32_t net);
+    void Schedule(uint32_t node);
+    void Evaluate(uint32_t node);
+    void EvaluateBlock(const Node& node);
+    void EvaluateNodeParallel(const Node& node, std::vector<LaneWord>& words);
+    void EvaluateForcedNode(uint32_t node, std::vector<LaneWord>& words, const std::vector<LaneForce>& forces);
+    static void ForceLanes(LaneWord& word, const LaneForce& force);
+    void EvaluateBlockParallel(const Node& node, std::vector<LaneWord>& words);
+    void EvaluateModelParallel(const Node& node, std::vector<LaneWord>& words);
+    void ComputeLevels();
+    static NodeOp ClassifyComponent(CircuitComponent* component);
+    static bool IsEvaluated(NodeOp op) {
+        return op != NodeOp::SOURCE && op != NodeOp::SINK && op != NodeOp::SUBCIRCUIT && op != NodeOp::REMOVED;
+    }
+};
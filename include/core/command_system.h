@@ -2,13 +2,41 @@
 #include <wx/wx.h>
 #include <memory>
 #include <vector>
-#include <stack>
+#include <deque>
 #include "../components/circuit_component.h"
 
 // Forward declaration
 class CircuitCanvas;
+class MemoryImage;
 
-// Base command interface
+// Components a command has taken off the canvas, kept in their saved form
+// rather than as live objects. Wires attached to a taken component go with
+// it and record both ends as component ID and pin number, so putting them
+// back reconnects them to whatever components carry those IDs by then.
+class ComponentRecords {
+private:
+    struct Record {
+        size_t index;       // Canvas index, restores the drawing order
+        bool isWire;
+        wxString line;
+        std::shared_ptr<const MemoryImage> memory;  // Contents as run; the line only names their file
+    };
+
+    std::vector<Record> records;
+
+public:
+    // Takes the components with the given IDs, and the wires on their pins, off the canvas
+    void Take(CircuitCanvas* canvas, const std::vector<ComponentId>& ids);
+
+    // Puts everything back where it was; records that no longer load are dropped
+    void Restore(CircuitCanvas* canvas);
+
+    bool IsEmpty() const { return records.empty(); }
+    size_t GetMemoryUsage() const;
+};
+
+// Base command interface. Commands refer to components on the canvas by
+// ID, so they stay valid whatever else was added or removed in between.
 class Command {
 public:
     virtual ~Command() = default;
@@ -17,13 +45,18 @@ public:
     virtual bool CanMerge(const Command* other) const { return false; }
     virtual void MergeWith(Command* other) {}
     virtual wxString GetDescription() const = 0;
+
+    // Estimated bytes the command holds on to, counted against the history budget
+    virtual size_t GetMemoryUsage() const = 0;
 };
 
 // Command for adding a component
 class AddComponentCommand : public Command {
 private:
     CircuitCanvas* canvas;
-    std::unique_ptr<CircuitComponent> component;
+    std::unique_ptr<CircuitComponent> component;    // Until first added
+    ComponentRecords undone;                        // Once undone
+    ComponentId componentId;
     bool executed;
 
 public:
@@ -33,14 +66,15 @@ public:
     void Execute() override;
     void Undo() override;
     wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
 };
 
 // Command for removing a component
 class RemoveComponentCommand : public Command {
 private:
     CircuitCanvas* canvas;
-    std::unique_ptr<CircuitComponent> component;
-    size_t originalIndex;
+    ComponentId componentId;
+    ComponentRecords removed;
     bool executed;
 
 public:
@@ -50,17 +84,19 @@ public:
     void Execute() override;
     void Undo() override;
     wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
 };
 
 // Command for moving a component
 class MoveComponentCommand : public Command {
 private:
-    CircuitComponent* component;
+    CircuitCanvas* canvas;
+    ComponentId componentId;
     wxPoint oldPosition;
     wxPoint newPosition;
 
 public:
-    MoveComponentCommand(CircuitComponent* comp, const wxPoint& oldPos, const wxPoint& newPos);
+    MoveComponentCommand(CircuitCanvas* canvas, CircuitComponent* comp, const wxPoint& oldPos, const wxPoint& newPos);
     ~MoveComponentCommand() override = default;
 
     void Execute() override;
@@ -68,17 +104,73 @@ public:
     bool CanMerge(const Command* other) const override;
     void MergeWith(Command* other) override;
     wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
+};
+
+// Command for moving several components by the same offset
+class MoveComponentsCommand : public Command {
+private:
+    CircuitCanvas* canvas;
+    std::vector<ComponentId> componentIds;
+    wxPoint offset;
+    bool executed;
+
+public:
+    // The components have already been dragged by the offset
+    MoveComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps, const wxPoint& offset);
+    ~MoveComponentsCommand() override = default;
+
+    void Execute() override;
+    void Undo() override;
+    wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
+};
+
+// Command for turning several components, each about its own position
+class RotateComponentsCommand : public Command {
+private:
+    CircuitCanvas* canvas;
+    std::vector<ComponentId> componentIds;
+    double degrees;
+
+public:
+    RotateComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps, double degrees);
+    ~RotateComponentsCommand() override = default;
+
+    void Execute() override;
+    void Undo() override;
+    wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
+};
+
+// Command for removing several components in one pass over the canvas
+class RemoveComponentsCommand : public Command {
+private:
+    CircuitCanvas* canvas;
+    std::vector<ComponentId> componentIds;
+    ComponentRecords removed;
+    bool executed;
+
+public:
+    RemoveComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps);
+    ~RemoveComponentsCommand() override = default;
+
+    void Execute() override;
+    void Undo() override;
+    wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
 };
 
 // Command for selecting/deselecting components
 class SelectionCommand : public Command {
 private:
-    std::vector<CircuitComponent*> components;
+    CircuitCanvas* canvas;
+    std::vector<ComponentId> componentIds;
     std::vector<bool> oldStates;
     std::vector<bool> newStates;
 
 public:
-    SelectionCommand(const std::vector<CircuitComponent*>& comps,
+    SelectionCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps,
                     const std::vector<bool>& oldSel,
                     const std::vector<bool>& newSel);
     ~SelectionCommand() override = default;
@@ -86,6 +178,7 @@ public:
     void Execute() override;
     void Undo() override;
     wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
 };
 
 // Composite command for multiple operations
@@ -102,18 +195,31 @@ public:
     void Execute() override;
     void Undo() override;
     wxString GetDescription() const override;
+    size_t GetMemoryUsage() const override;
 };
 
-// Command manager for undo/redo functionality
+// Command manager for undo/redo functionality. The history is bounded by
+// the memory its commands hold instead of by their number: moves and
+// rotations cost a few dozen bytes, so thousands of them fit, while the
+// oldest entries go once deleted components add up to the budget.
 class CommandManager {
 private:
-    std::vector<std::unique_ptr<Command>> undoStack;
-    std::vector<std::unique_ptr<Command>> redoStack;
-    size_t maxUndoLevels;
+    // A command with its footprint as of when it was stacked
+    struct HistoryEntry {
+        std::unique_ptr<Command> command;
+        size_t memoryUsage;
+    };
+
+    std::deque<HistoryEntry> undoStack;
+    std::deque<HistoryEntry> redoStack;
+    size_t memoryBudget;
+    size_t memoryUsage;     // Both stacks together
     bool isExecuting;
 
 public:
-    CommandManager(size_t maxLevels = 50);
+    static const size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+    CommandManager(size_t budget = DEFAULT_MEMORY_BUDGET);
     ~CommandManager() = default;
 
     // Command execution
@@ -127,6 +233,9 @@ public:
     void Clear();
     size_t GetUndoCount() const { return undoStack.size(); }
     size_t GetRedoCount() const { return redoStack.size(); }
+    size_t GetMemoryUsage() const { return memoryUsage; }
+    size_t GetMemoryBudget() const { return memoryBudget; }
+    void SetMemoryBudget(size_t budget);
 
     // Command descriptions for UI
     wxString GetUndoDescription() const;
@@ -138,7 +247,10 @@ public:
     void AbortTransaction();
 
 private:
-    void LimitUndoStack();
+    void Push(std::deque<HistoryEntry>& stack, std::unique_ptr<Command> command);
+    std::unique_ptr<Command> Pop(std::deque<HistoryEntry>& stack);
+    void ClearRedo();
+    void LimitMemory();
     std::unique_ptr<CompositeCommand> currentTransaction;
 };
 
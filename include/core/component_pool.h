@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Arena behind the components of one document, their pins and wire routes.
+// Blocks are rounded up to GRANULE bytes and carved out of SLAB_SIZE slabs;
+// freed blocks are recycled through free lists per size. Each component
+// class gets slabs of its own size, so components of one class lie next to
+// each other. Pins have separate slabs and are carved in creation order
+// whatever their count, so the pins of a document form a few long arrays
+// and the pins of each component are one range in them. Blocks larger than
+// MAX_POOLED go to the global heap.
+//
+// Components come from the pool made current on the calling thread with a
+// Scope, otherwise from the process-wide default pool; the pins and routes
+// of a component keep using the pool that was current when it was made. A
+// block always goes back to the pool it came from, which it finds in the
+// header of its slab.
+// A document's pool gives back all of its slabs in one step when the
+// document is cleared or closed and its last block has been freed, so the
+// peak of one document is not kept for the next.
+class ComponentPool {
+public:
+    static const size_t GRANULE = 16;
+    static const size_t MAX_POOLED = 1024;
+    static const size_t SLAB_SIZE = 64 * 1024;
+
+    enum class Region {
+        OBJECTS,
+        PINS
+    };
+
+    // Makes a pool the current one of this thread while it exists
+    class Scope {
+        ComponentPool* previous;
+
+    public:
+        explicit Scope(ComponentPool* pool);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Owners close their pool instead of deleting it; the pool lives on
+    // until blocks that outlived the owner have been freed
+    struct Closer {
+        void operator()(ComponentPool* pool) const { pool->Close(); }
+    };
+    typedef std::unique_ptr<ComponentPool, Closer> Owner;
+
+    static Owner Create();
+    static ComponentPool* Default();
+    static ComponentPool* Current();
+
+    void* Allocate(size_t bytes, Region region = Region::OBJECTS);
+    static void Free(void* block, size_t bytes);
+
+    // Gives back every slab at once if no block is in use any more. Called
+    // by owners that have just destroyed all of their components.
+    void ReleaseIfUnused();
+
+    size_t GetBlockCount() const;   // Blocks in use
+    size_t GetSlabCount() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Start of every slab, so a block finds its pool from its address
+    struct SlabHeader {
+        ComponentPool* pool;
+        SlabHeader* next;
+        Region region;
+    };
+
+    // Unused tail of the newest slab a block size or the pins are carved from
+    struct Carver {
+        char* cursor;
+        char* end;
+    };
+
+    struct SizeClass {
+        FreeBlock* freeList;
+        FreeBlock* pinFreeList;
+        Carver carver;
+    };
+
+    static const size_t CLASS_COUNT = MAX_POOLED / GRANULE;
+    static const size_t HEADER_SIZE = (sizeof(SlabHeader) + GRANULE - 1) / GRANULE * GRANULE;
+
+    // Guards everything below; allocation is nearly always on the UI thread
+    mutable std::atomic_flag lock;
+    SizeClass classes[CLASS_COUNT];
+    Carver pinCarver;
+    SlabHeader* slabs;
+    size_t slabCount;
+    size_t blockCount;
+    bool closed;
+
+    ComponentPool();
+    ~ComponentPool();
+    ComponentPool(const ComponentPool&) = delete;
+    ComponentPool& operator=(const ComponentPool&) = delete;
+
+    void* AllocateBlock(size_t blockSize, Region region);
+    bool FreeBlockTo(void* block, size_t blockSize, Region region);  // True once a closed pool is unused
+    char* AddSlab(Region region);
+    void ReleaseSlabs();
+    void Close();
+};
+
+// Standard allocator for containers owned by components. It stays with the
+// pool that was current when the container was made; copies made elsewhere
+// take the pool current there.
+template <typename T, ComponentPool::Region R = ComponentPool::Region::OBJECTS>
+class PoolAllocator {
+    template <typename U, ComponentPool::Region S>
+    friend class PoolAllocator;
+
+    ComponentPool* pool;
+
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef PoolAllocator<U, R> other;
+    };
+
+    PoolAllocator() : pool(ComponentPool::Current()) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U, R>& other) : pool(other.pool) {}
+
+    PoolAllocator select_on_container_copy_construction() const { return PoolAllocator(); }
+
+    T* allocate(size_t count) { return static_cast<T*>(pool->Allocate(count * sizeof(T), R)); }
+    void deallocate(T* block, size_t count) { ComponentPool::Free(block, count * sizeof(T)); }
+
+    // Blocks go back to their own pool, so any two allocators can free each other's
+    template <typename U>
+    bool operator==(const PoolAllocator<U, R>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U, R>&) const { return false; }
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+#include "and_inverter_graph.h"
+
+// Checks whether two combinational circuits compute the same function.
+// Input switches and output LEDs are matched by label, so both circuits
+// need the same labels and no duplicates. Circuits with few inputs are
+// simulated exhaustively with the bit-parallel evaluator. Larger ones
+// get random vectors first, which finds most differences quickly. If
+// none is found, both circuits are built into one and-inverter graph over
+// shared inputs. Structural hashing already merges logic the circuits
+// share, and each remaining output pair is proven equal or different by
+// the SAT solver.
+//
+// Undefined values follow the simulator: floating nets read as undefined,
+// and an output that is undefined in one circuit but not the other is a
+// difference. Blocks without gates of their own (adders, decoders,
+// subcircuit models) are tabulated into the graph when they have up to
+// MAX_TABLE_INPUTS variable inputs.
+class EquivalenceChecker {
+public:
+    static const size_t EXHAUSTIVE_INPUTS = 20;
+    static const size_t RANDOM_PASSES = 256;        // 64 vectors each
+    static const size_t MAX_TABLE_INPUTS = 12;
+    static const size_t CONFLICT_LIMIT = 200000;    // Per output
+
+    enum class Verdict {
+        EQUIVALENT,
+        DIFFERENT,
+        UNKNOWN         // Random vectors agreed but no proof was found
+    };
+
+    enum class Method {
+        EXHAUSTIVE,
+        RANDOM,
+        SAT
+    };
+
+    // An output that differs on the counterexample
+    struct Mismatch {
+        wxString output;
+        LogicValue first;
+        LogicValue second;
+    };
+
+private:
+    // Value of a net in the graph; undefined nets are constant X
+    struct Signal {
+        uint32_t literal;
+        bool undefined;
+    };
+
+    std::vector<wxString> inputNames;
+    std::vector<wxString> outputNames;
+    Verdict verdict;
+    Method method;
+    std::vector<uint8_t> counterexample;    // Input values by inputNames, for DIFFERENT
+    std::vector<Mismatch> mismatches;
+    size_t andCount;                        // Graph size, when one was built
+    wxString unknownReason;
+    wxString lastError;
+
+    // Matched ports of both circuits, in inputNames and outputNames order
+    std::vector<uint32_t> inputNets[2];
+    std::vector<uint32_t> outputNets[2];
+    std::vector<CircuitNetlist::LaneWord> words[2];
+
+public:
+    EquivalenceChecker();
+
+    // Fails on sequential circuits, buses and labels that do not match
+    bool Check(CircuitNetlist& first, CircuitNetlist& second);
+
+    Verdict GetVerdict() const { return verdict; }
+    Method GetMethod() const { return method; }
+    const std::vector<Mismatch>& GetMismatches() const { return mismatches; }
+    const wxString& GetLastError() const { return lastError; }
+
+    wxString Format() const;
+
+private:
+    bool MatchPorts(CircuitNetlist* netlists[2]);
+    uint64_t SimulatePass(CircuitNetlist* netlists[2], const std::vector<uint64_t>& patterns);
+    void RecordCounterexample(CircuitNetlist* netlists[2], const std::vector<uint64_t>& patterns, unsigned lane);
+    bool BuildGraph(CircuitNetlist& netlist, int side, AndInverterGraph& graph,
+                    const std::vector<uint32_t>& inputLiterals, std::vector<Signal>& outputs);
+    uint32_t TableToGraph(AndInverterGraph& graph, const std::vector<uint8_t>& table, size_t begin,
+                          const std::vector<uint32_t>& literals, size_t variable);
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+#include "test_vector_runner.h"
+
+// Stuck-at fault simulation of a combinational circuit against a test vector
+// set. Every pin of every evaluated component, every switch output and every
+// LED input gets a stuck-at-0 and a stuck-at-1 fault. Faults are simulated
+// 63 at a time in the lanes of the netlist's bit-parallel evaluator, with
+// lane 0 holding the fault-free circuit; each pass only evaluates the
+// fan-out cones of its faults on top of one fault-free pass per vector.
+// A vector detects a fault when some output LED differs from the fault-free
+// value in the fault's lane. Detected faults are dropped, so each vector
+// only simulates the faults still missed. Output columns of the vector file
+// are ignored.
+class FaultSimulator {
+public:
+    static const size_t NOT_DETECTED = ~size_t(0);
+    static const size_t FAULTS_PER_PASS = 63;
+
+    struct Fault {
+        uint32_t node;
+        uint32_t pin;           // Input or output index of the node
+        bool output;
+        bool stuckHigh;
+        size_t detectedBy;      // Row of the first vector that detected it, NOT_DETECTED if none
+    };
+
+private:
+    std::vector<Fault> faults;
+    size_t detectedCount;
+    size_t vectorsRun;
+    size_t usefulVectors;       // Vectors that detected at least one new fault
+    wxString lastError;
+
+public:
+    FaultSimulator();
+
+    // Fails on sequential circuits, feedback loops, buses and vector
+    // columns that name no switch or LED
+    bool Run(CircuitNetlist& netlist, const TestVectorRunner& vectors);
+    void Clear();
+
+    const std::vector<Fault>& GetFaults() const { return faults; }
+    size_t GetDetectedCount() const { return detectedCount; }
+    double GetCoverage() const;     // Percent of faults detected
+    const wxString& GetLastError() const { return lastError; }
+
+    // Coverage summary followed by up to maxLines undetected faults
+    wxString Format(const CircuitNetlist& netlist, size_t maxLines = 20) const;
+    static wxString DescribeFault(const CircuitNetlist& netlist, const Fault& fault);
+
+private:
+    void EnumerateFaults(const CircuitNetlist& netlist);
+};
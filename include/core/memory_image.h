@@ -0,0 +1,95 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Read-only view of a whole file mapped into memory
+class MappedFile {
+private:
+    const uint8_t* data;
+    size_t size;
+#ifdef __WXMSW__
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const wxString& filepath);
+    const uint8_t* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+private:
+    void Close();
+};
+
+// Contents of a RAM or ROM: 2^addressWidth words of dataWidth bits, stored
+// little endian in one flat byte array with (dataWidth + 7) / 8 bytes per
+// word. Large binary images are mapped from their file instead of copied;
+// the first write copies a mapped image into the array.
+//
+// Hex files hold whitespace separated words in hexadecimal. "n*word"
+// repeats a word n times, "address:" continues at the given word address
+// and '#' starts a comment. A leading "v2.0 raw" line is accepted and
+// written, so images can be exchanged with Logisim. Any other file is read
+// as raw binary words.
+class MemoryImage {
+public:
+    static const int MIN_ADDRESS_WIDTH = 1;
+    static const int MAX_ADDRESS_WIDTH = 24;
+    static const int DEFAULT_ADDRESS_WIDTH = 8;
+    static const size_t MAP_THRESHOLD = 1 << 20;  // Binary images from this size on are mapped
+
+    enum class Format {
+        AUTO,       // Hex for .hex and .txt files, binary otherwise
+        HEX,
+        BINARY
+    };
+
+private:
+    int addressWidth;
+    int dataWidth;
+    size_t wordBytes;
+    std::vector<uint8_t> bytes;             // Empty while mapped
+    std::shared_ptr<const MappedFile> mapping;  // Shared by copies of the image
+    wxString sourcePath;                    // File the contents were loaded from
+    wxString lastError;
+
+public:
+    MemoryImage(int addressBits, int dataBits);
+
+    int GetAddressWidth() const { return addressWidth; }
+    int GetDataWidth() const { return dataWidth; }
+    size_t GetWordCount() const { return size_t(1) << addressWidth; }
+    bool IsMapped() const { return mapping != nullptr; }
+    const wxString& GetSourcePath() const { return sourcePath; }
+    const wxString& GetLastError() const { return lastError; }
+
+    // Addresses wrap at the word count; unmapped words of a short image read 0
+    uint64_t Read(uint64_t address) const;
+    void Write(uint64_t address, uint64_t value);
+
+    // Zero-filled at the new size, any loaded file is forgotten
+    void Resize(int addressBits, int dataBits);
+    void Clear();
+
+    bool LoadFromFile(const wxString& filepath, Format format = Format::AUTO);
+    bool SaveToFile(const wxString& filepath, Format format = Format::AUTO);
+
+private:
+    const uint8_t* GetBytes() const;
+    size_t GetByteCount() const;
+    void Unmap();
+    bool LoadHex(const wxString& filepath);
+    bool LoadBinary(const wxString& filepath);
+    bool SaveHex(const wxString& filepath);
+    bool SaveBinary(const wxString& filepath);
+    static Format ResolveFormat(const wxString& filepath, Format format);
+};
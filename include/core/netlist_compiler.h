@@ -0,0 +1,74 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/dynlib.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "circuit_netlist.h"
+
+// Native code for the bit-parallel evaluator. The gates of a combinational
+// netlist are written out in level order as one straight-line C++ function
+// over the lane words, built into a shared library by the system compiler
+// on a worker thread and loaded. The thread is joined before the compiler
+// or its next build goes away, so the files and the library never outlive
+// it. Until the library is ready, and for good if building it fails, the
+// netlist keeps interpreting. Only netlists of gates, switches and sinks
+// without buses or loops can be compiled; a compiled function belongs to
+// the exact netlist it was generated from.
+class NetlistCompiler {
+public:
+    typedef void (*EvaluateFunction)(CircuitNetlist::LaneWord* words);
+
+    enum class State {
+        COMPILING,
+        READY,
+        FAILED
+    };
+
+private:
+    // Filled in by the worker thread; only the state may be read before it is joined
+    struct Job {
+        std::atomic<State> state;
+        wxString source;
+        wxString command;
+        wxString basePath;      // Temporary file reserving the name of the others
+        wxString sourcePath;
+        wxString libraryPath;
+        wxDynamicLibrary library;
+        EvaluateFunction function;
+        wxString error;
+
+        Job() : state(State::COMPILING), function(nullptr) {}
+        ~Job();
+        void Run();
+    };
+
+    std::unique_ptr<Job> job;
+    std::thread worker;
+
+    void Join();
+
+public:
+    NetlistCompiler() {}
+    ~NetlistCompiler();
+    NetlistCompiler(const NetlistCompiler&) = delete;
+    NetlistCompiler& operator=(const NetlistCompiler&) = delete;
+
+    static bool CanCompile(const CircuitNetlist& netlist);
+    static wxString GenerateSource(const CircuitNetlist& netlist);
+
+    // Compiler invocation; {source} and {library} are replaced by the paths
+    static wxString GetDefaultCommand();
+
+    // Starts building in the background; false if the netlist cannot be compiled
+    bool Start(const CircuitNetlist& netlist, const wxString& command = GetDefaultCommand());
+
+    State GetState() const { return job ? job->state.load() : State::FAILED; }
+    State Wait();                   // Blocks until building has finished
+    bool IsReady() const { return GetState() == State::READY; }
+    wxString GetLastError() const;  // Why building failed
+
+    // Only once ready, with words laid out as by ResetParallel
+    void Evaluate(std::vector<CircuitNetlist::LaneWord>& words) const { job->function(words.data()); }
+};
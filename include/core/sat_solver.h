@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Small CDCL satisfiability solver for the equivalence checker's miters.
+// Variables are numbered from 0; a literal is twice its variable plus one
+// when negated. Propagation uses two watched literals per clause, conflicts
+// are analyzed to the first unique implication point, decisions follow
+// variable activity with saved phases and restarts follow the Luby series.
+// Learnt clauses are never deleted, so Solve takes a conflict limit.
+class SatSolver {
+public:
+    enum class Result {
+        SATISFIABLE,
+        UNSATISFIABLE,
+        UNKNOWN         // Conflict limit reached
+    };
+
+    static uint32_t MakeLiteral(uint32_t variable, bool negated) { return variable * 2 + (negated ? 1 : 0); }
+    static uint32_t Negate(uint32_t literal) { return literal ^ 1; }
+
+private:
+    static const uint32_t NO_CLAUSE = 0xFFFFFFFF;
+    static const uint8_t VALUE_FALSE = 0;
+    static const uint8_t VALUE_TRUE = 1;
+    static const uint8_t VALUE_UNASSIGNED = 2;
+
+    std::vector<std::vector<uint32_t>> clauses;
+    std::vector<std::vector<uint32_t>> watches;    // Clauses watching each literal
+    std::vector<uint8_t> values;                   // Per variable
+    std::vector<uint8_t> savedPhases;
+    std::vector<uint32_t> levels;                  // Decision level of each assignment
+    std::vector<uint32_t> reasons;                 // Clause that implied it, NO_CLAUSE for decisions
+    std::vector<uint32_t> trail;
+    std::vector<uint32_t> trailLimits;             // Trail size at each decision
+    size_t propagated;
+    bool inconsistent;                             // An empty clause was added
+
+    // Decision order: binary max-heap of variables by activity
+    std::vector<double> activity;
+    double activityIncrement;
+    std::vector<uint32_t> heap;
+    std::vector<uint32_t> heapIndex;               // Position in heap, NO_CLAUSE when absent
+
+    std::vector<uint8_t> seen;                     // Scratch for conflict analysis
+    size_t conflicts;
+
+public:
+    SatSolver();
+
+    uint32_t NewVariable();
+    size_t GetVariableCount() const { return values.size(); }
+    void AddClause(std::vector<uint32_t> literals);
+
+    Result Solve(size_t conflictLimit);
+    bool GetValue(uint32_t variable) const { return values[variable] == VALUE_TRUE; }  // After SATISFIABLE
+    size_t GetConflictCount() const { return conflicts; }
+
+private:
+    uint8_t LiteralValue(uint32_t literal) const;
+    uint32_t DecisionLevel() const { return static_cast<uint32_t>(trailLimits.size()); }
+    void Assign(uint32_t literal, uint32_t reason);
+    uint32_t Propagate();
+    void Analyze(uint32_t conflict, std::vector<uint32_t>& learnt, uint32_t& backtrackLevel);
+    void Backtrack(uint32_t level);
+    void AttachClause(uint32_t clause);
+    void BumpActivity(uint32_t variable);
+    void HeapInsert(uint32_t variable);
+    uint32_t HeapPop();
+    void HeapUp(size_t position);
+    void HeapDown(size_t position);
+    static size_t Luby(size_t index);
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <wx/wx.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+#include "circuit_netlist.h"
+#include "waveform_recorder.h"
+
+// When a run stops on its own
+struct RunCondition {
+    enum class Kind {
+        NONE,           // Only when paused
+        CYCLES,         // After a number of cycles
+        NET_EQUALS,     // At the end of the first cycle the net holds the value
+        NET_CHANGES     // As soon as the net changes, checked after every clock phase
+    };
+
+    Kind kind;
+    uint64_t cycles;
+    uint32_t net;
+    BusValue value;
+
+    RunCondition() : kind(Kind::NONE), cycles(0), net(CircuitNetlist::NO_NET), value{ 0, 0 } {}
+
+    static RunCondition Cycles(uint64_t count);
+    static RunCondition NetEquals(uint32_t net, BusValue value);
+    static RunCondition NetChanges(uint32_t net);
+};
+
+// Pauses a run when a pin's net meets the condition. Kept by component ID
+// and pin number so it survives rebuilding the netlist, and deleting the
+// component and undoing that.
+struct Breakpoint {
+    ComponentId componentId;
+    ComponentType componentType;    // For descriptions while the component is not placed
+    size_t pinIndex;
+    CircuitNetlist::Watchpoint::Kind kind;
+    BusValue value;     // For EQUALS
+    bool enabled;
+};
+
+// Why the last run or step stopped
+enum class SimulationStop {
+    PAUSED,
+    CYCLES_DONE,
+    NET_EQUAL,
+    NET_CHANGED,
+    OSCILLATING,
+    NO_CLOCK,
+    BREAKPOINT
+};
+
+// Runs clock cycles on a built netlist. One cycle drives every clock
+// generator net high, settles, drives them low and settles again. Steps run
+// on the calling thread; Run hands the netlist to a worker thread that
+// cycles as fast as it can until the condition holds or Pause is called.
+//
+// While a run is active the worker owns the netlist and the component pins
+// it evaluates. Other threads take the state mutex before reading or
+// changing them; the worker only holds it for one cycle at a time.
+class SimulationController {
+private:
+    CircuitNetlist& netlist;
+    wxEvtHandler* listener;     // Gets wxEVT_SIMULATION_STOPPED when a run ends
+    WaveformRecorder* recorder; // Sampled after every completed cycle
+    ComponentLookup findComponent;  // Places breakpoints on pins
+    std::thread worker;
+    mutable std::mutex stateMutex;
+    std::atomic<bool> pauseRequested;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> cycle;
+    std::atomic<SimulationStop> lastStop;
+    std::vector<Breakpoint> breakpoints;
+    std::vector<uint32_t> breakpointHits;   // Indices in breakpoints that stopped the last run, under the state mutex
+
+public:
+    SimulationController(CircuitNetlist& compiled, wxEvtHandler* stopListener = nullptr);
+    ~SimulationController();
+
+    // Cycles since the last ResetCycleCount
+    uint64_t GetCycle() const { return cycle; }
+    void ResetCycleCount() { cycle = 0; }
+
+    void SetRecorder(WaveformRecorder* waveforms) { recorder = waveforms; }
+    void SetComponentLookup(const ComponentLookup& lookup) { findComponent = lookup; }
+
+    bool IsRunning() const { return running; }
+    SimulationStop GetLastStop() const { return lastStop; }
+    std::mutex& GetStateMutex() { return stateMutex; }
+
+    // Start the worker; false if it is already running
+    bool Run(const RunCondition& condition);
+
+    // Stop the worker and wait for it. Safe to call when it is not running.
+    void Pause();
+
+    // Run on the calling thread, only while not running
+    SimulationStop Step(const RunCondition& condition);
+
+    static wxString DescribeStop(SimulationStop reason);
+
+    // Breakpoints; changing them takes the state mutex, so they can be set during a run
+    void AddBreakpoint(const Breakpoint& breakpoint);
+    void RemoveBreakpoint(size_t index);
+    void ClearBreakpoints();
+    const std::vector<Breakpoint>& GetBreakpoints() const { return breakpoints; }
+    std::vector<uint32_t> GetBreakpointHits() const;  // A copy, the worker may be changing them
+    static wxString DescribeBreakpoint(const Breakpoint& breakpoint);
+
+    // Turn the breakpoints into watchpoints of the netlist. Called after
+    // every Build, while not running. Breakpoints on components that are
+    // not placed stay inactive until they are.
+    void ApplyBreakpoints();
+
+    // Sent to the listener with the SimulationStop in the event's int and,
+    // for BREAKPOINT, the index of the first breakpoint hit in its extra long
+    static const wxEventType wxEVT_SIMULATION_STOPPED;
+
+private:
+    SimulationStop RunCycles(const RunCondition& condition);
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <wx/wx.h>
+#include <map>
+#include <memory>
+#include <vector>
+#include "../components/subcircuit_component.h"
+
+// Loads subcircuit definitions from circuit files, once per file. Every
+// instance placed from the same file shares the cached definition.
+class SubcircuitLibrary {
+private:
+    std::map<wxString, std::shared_ptr<const SubcircuitDefinition>> definitions;
+    std::vector<wxString> loading;  // Files being loaded, to reject recursive definitions
+
+public:
+    static SubcircuitLibrary& GetInstance();
+
+    // Returns nullptr and sets error if the file cannot be used
+    std::shared_ptr<const SubcircuitDefinition> Load(const wxString& filepath, wxString& error);
+    void Clear() { definitions.clear(); }
+
+private:
+    SubcircuitLibrary() {}
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <wx/wx.h>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+class CircuitNetlist;
+class SubcircuitDefinition;
+
+// Bounded least-recently-used map from packed input vectors to packed outputs
+class SubcircuitCache {
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t value;
+    };
+
+    std::list<Entry> entries;   // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t capacity;
+
+public:
+    explicit SubcircuitCache(size_t maxEntries);
+
+    bool Find(uint64_t key, uint64_t& value);
+    void Insert(uint64_t key, uint64_t value);
+    void Clear();
+    size_t GetSize() const { return index.size(); }
+};
+
+// Evaluates a pure combinational definition as one block. Inputs and outputs
+// are packed one bit per port in the low 32 bits, with the undefined mask in
+// the high 32 bits. Fully defined inputs of small definitions are answered
+// from a table filled at compile time, everything else from the LRU cache or,
+// on a miss, by settling the definition's own netlist.
+class SubcircuitModel {
+public:
+    static const size_t MAX_PORTS = 32;
+
+private:
+    std::shared_ptr<const SubcircuitDefinition> definition;   // Kept alive with the model
+    std::unique_ptr<CircuitNetlist> netlist;
+    std::vector<uint32_t> inputNets;    // Port nets inside the definition
+    std::vector<uint32_t> outputNets;
+    std::vector<uint64_t> table;        // Indexed by the input bits, empty if too many inputs
+    SubcircuitCache cache;
+    uint64_t hits;
+    uint64_t misses;
+
+public:
+    SubcircuitModel(std::shared_ptr<const SubcircuitDefinition> def, std::unique_ptr<CircuitNetlist> compiled,
+                    size_t cacheEntries, size_t maxTableInputs);
+    ~SubcircuitModel();
+
+    // Whether a compiled definition can be evaluated as one block
+    static bool IsEligible(const SubcircuitDefinition& def, const CircuitNetlist& compiled);
+
+    uint64_t Evaluate(uint64_t high, uint64_t undefined);
+
+    const SubcircuitDefinition* GetDefinition() const { return definition.get(); }
+    size_t GetInputCount() const { return inputNets.size(); }
+    size_t GetOutputCount() const { return outputNets.size(); }
+    bool HasTable() const { return !table.empty(); }
+    uint64_t GetHitCount() const { return hits; }
+    uint64_t GetMissCount() const { return misses; }
+
+private:
+    uint64_t Simulate(uint64_t high, uint64_t undefined);
+    void BuildTable();
+};
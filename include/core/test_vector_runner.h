@@ -0,0 +1,70 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+
+// One expected output that did not match
+struct TestVectorMismatch {
+    size_t line;            // Line number in the vector file
+    wxString signal;        // OutputLED label
+    LogicValue expected;
+    LogicValue actual;
+};
+
+// Outcome of running a vector set
+struct TestVectorReport {
+    size_t vectorsRun;
+    size_t vectorsFailed;
+    size_t unstableVectors;     // Rows on which the circuit oscillated
+    size_t mismatchCount;       // Total, including those not kept below
+    std::vector<TestVectorMismatch> mismatches;
+
+    TestVectorReport() : vectorsRun(0), vectorsFailed(0), unstableVectors(0), mismatchCount(0) {}
+
+    bool Passed() const { return vectorsFailed == 0 && unstableVectors == 0; }
+    wxString Format(size_t maxLines = 20) const;
+};
+
+// Table of input assignments and expected outputs, keyed by the labels of
+// InputSwitch and OutputLED components. The first line names the columns;
+// every other line holds one vector with 0, 1 or X per column. Columns may be
+// separated by commas, semicolons, tabs or spaces and '#' starts a comment.
+// An X in an output column means "don't care".
+//
+//     # a, b, cin -> sum, cout
+//     a, b, cin, sum, cout
+//     0, 0, 1,   1,   0
+class TestVectorRunner {
+public:
+    // Cell encoding in the parsed table
+    static const uint8_t CELL_LOW = 0;
+    static const uint8_t CELL_HIGH = 1;
+    static const uint8_t CELL_X = 2;
+
+private:
+    std::vector<wxString> columns;
+    std::vector<uint8_t> cells;         // Row-major, columns.size() per row
+    std::vector<size_t> lineNumbers;    // Source line of each row
+    wxString lastError;
+
+public:
+    TestVectorRunner();
+
+    bool LoadFromFile(const wxString& filepath);
+    bool LoadFromString(const wxString& text);
+
+    // Apply every vector to an already built netlist. The netlist is
+    // compiled once and only the changed inputs are re-propagated per row.
+    bool Run(CircuitNetlist& netlist, TestVectorReport& report, size_t maxMismatches = 1000);
+
+    size_t GetVectorCount() const { return lineNumbers.size(); }
+    const std::vector<wxString>& GetColumns() const { return columns; }
+    uint8_t GetCell(size_t row, size_t column) const { return cells[row * columns.size() + column]; }
+    size_t GetLineNumber(size_t row) const { return lineNumbers[row]; }
+    const wxString& GetLastError() const { return lastError; }
+
+private:
+    bool ParseLine(const wxString& line, size_t lineNumber);
+    static void SplitFields(const wxString& line, std::vector<wxString>& fields);
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <wx/wx.h>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+
+// Static timing over a compiled netlist. Paths start at input switches,
+// clocks and flip-flop outputs and end at output LEDs and flip-flop inputs.
+// Arrival times are propagated once through the nodes in level order using
+// the larger of each node's rise and fall delay, so a whole analysis is
+// linear in the number of pins. Flip-flop outputs launch after their own
+// delay, as clock to output time.
+class TimingAnalysis {
+public:
+    static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+    // One path to an end point, launching node first, capturing node last
+    struct Path {
+        uint64_t arrival;
+        std::vector<uint32_t> nodes;
+    };
+
+private:
+    std::vector<uint64_t> netArrival;
+    std::vector<uint32_t> netDriver;    // Node driving each net, NO_NODE for undriven nets
+    std::vector<Path> paths;            // Worst end points first
+    bool brokenLoops;                   // Combinational loops were cut to analyze the rest
+
+public:
+    TimingAnalysis();
+
+    // Arrival times of every net and the critical paths of the pathCount
+    // slowest end points
+    void Analyze(const CircuitNetlist& netlist, size_t pathCount = 10);
+    void Clear();
+
+    const std::vector<Path>& GetPaths() const { return paths; }
+    uint64_t GetCriticalDelay() const { return paths.empty() ? 0 : paths[0].arrival; }
+    uint64_t GetNetArrival(size_t net) const { return netArrival[net]; }
+    bool HasBrokenLoops() const { return brokenLoops; }
+
+    // Plain text report of the paths, one line per node
+    wxString Format(const CircuitNetlist& netlist) const;
+
+    // Top level component a node belongs to; the instance for nodes
+    // flattened out of a subcircuit
+    static const CircuitComponent* GetTopLevelComponent(const CircuitNetlist& netlist, uint32_t node);
+
+private:
+    uint32_t WorstInput(const CircuitNetlist& netlist, uint32_t node) const;
+    static bool IsStartPoint(const CircuitNetlist::Node& node);
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/stream.h>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+
+// Exhaustive truth table of a combinational circuit, from its input switches
+// to its output LEDs. Rows are simulated 64 at a time with the netlist's
+// bit-parallel evaluator and outputs are kept as packed bits per column, so
+// a table with millions of rows stays a few megabytes. The first input is
+// the most significant bit of the row number.
+//
+// Given a selection, the table spans only the selected switches and LEDs;
+// the other switches hold their current state in every row.
+class TruthTable {
+public:
+    static const size_t MAX_INPUTS = 24;
+
+private:
+    std::vector<wxString> inputNames;
+    std::vector<wxString> outputNames;
+    size_t rowCount;
+    size_t wordsPerColumn;
+    std::vector<uint64_t> outputHigh;       // wordsPerColumn words per output
+    std::vector<uint64_t> outputUndefined;
+    wxString lastError;
+
+public:
+    TruthTable();
+
+    // Enumerate every input combination. Fails on sequential circuits,
+    // feedback loops and more than MAX_INPUTS switches. An empty selection
+    // means every switch and LED.
+    bool Generate(CircuitNetlist& netlist, const std::vector<ComponentId>& selection = std::vector<ComponentId>());
+    void Clear();
+
+    size_t GetRowCount() const { return rowCount; }
+    size_t GetInputCount() const { return inputNames.size(); }
+    size_t GetOutputCount() const { return outputNames.size(); }
+    size_t GetColumnCount() const { return inputNames.size() + outputNames.size(); }
+    const wxString& GetColumnName(size_t column) const;
+    const wxString& GetLastError() const { return lastError; }
+
+    bool GetInput(size_t row, size_t input) const;
+    LogicValue GetOutput(size_t row, size_t output) const;
+    wxString GetCellText(size_t row, size_t column) const;   // Inputs first, then outputs
+
+    // Comma separated, one header line and one line per row
+    bool WriteCSV(wxOutputStream& stream) const;
+    bool SaveCSV(const wxString& filepath) const;
+};
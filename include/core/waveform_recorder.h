@@ -0,0 +1,77 @@
+#pragma once
+#include <wx/wx.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include "circuit_netlist.h"
+
+// Recorded history of one probed pin, stored as a list of transitions.
+// times[i] is the cycle at which the signal took values[i]; the value holds
+// until times[i + 1]. Steady signals cost nothing no matter how long the run.
+// Values are kept as buses, single lines in bit 0.
+//
+// The pin is kept by component ID and number, so a probe outlives its
+// component being deleted and picks up again when the deletion is undone.
+struct WaveformTrace {
+    wxString name;
+    ComponentId componentId;
+    size_t pinIndex;
+    int width;
+    uint32_t net;       // Net of the pin in the simulated netlist, NO_NET until resolved
+    const CircuitComponent* component;  // Found from the ID; nullptr while not placed
+    std::vector<uint64_t> times;
+    std::vector<BusValue> values;
+
+    WaveformTrace(ComponentId id, size_t pinNumber, int pinWidth, const wxString& traceName)
+        : name(traceName), componentId(id), pinIndex(pinNumber), width(pinWidth),
+          net(CircuitNetlist::NO_NET), component(nullptr) {}
+
+    void Record(uint64_t time, const BusValue& value);
+    BusValue ValueAt(uint64_t time) const;     // Fully undefined before the first sample
+
+    // Index of the first transition at or after the given time
+    size_t LowerBound(uint64_t time, size_t from = 0) const;
+    size_t GetTransitionCount() const { return times.size(); }
+};
+
+// Samples probed nets once per simulation cycle. During a run the
+// simulation worker samples every cycle it completes, reading the nets of
+// the netlist; edits sample once per settle. The traces are shared with the
+// viewer, which takes the mutex while reading them.
+class WaveformRecorder {
+private:
+    std::vector<WaveformTrace> traces;
+    std::atomic<uint64_t> currentTime;
+    std::atomic<unsigned long> revision;    // Bumped whenever traces or samples change
+    mutable std::mutex mutex;
+
+public:
+    WaveformRecorder();
+
+    // Probe management
+    bool AddProbe(const CircuitComponent* component, size_t pinIndex, const wxString& name);
+    void RemoveProbe(size_t traceIndex);
+    void RemoveAllProbes();
+    bool HasProbe(ComponentId componentId, size_t pinIndex) const;
+
+    // Look up the pin and net of every probe. Called after every Build.
+    void ResolveNets(const CircuitNetlist& netlist, const ComponentLookup& findComponent);
+
+    // Stop reading the pins of a component taken off the canvas; its probes
+    // keep their samples and resume when it is resolved again
+    void DetachComponent(ComponentId componentId);
+
+    // Capture the probed nets as the next cycle. The caller holds the
+    // simulation's state mutex; probes without a net read their pins.
+    void Sample(const CircuitNetlist& netlist);
+
+    // Discard recorded samples but keep probes
+    void ClearSamples();
+
+    // Only read the traces while holding the mutex
+    std::mutex& GetMutex() const { return mutex; }
+    const std::vector<WaveformTrace>& GetTraces() const { return traces; }
+    uint64_t GetEndTime() const { return currentTime; }
+    unsigned long GetRevision() const { return revision; }
+};
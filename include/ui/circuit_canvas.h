@@ -2,25 +2,59 @@
 #include <wx/wx.h>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include "../components/circuit_component.h"
 #include "../components/wire.h"
 #include "../core/command_system.h"
+#include "../core/waveform_recorder.h"
+#include "../core/circuit_netlist.h"
+#include "../core/simulation_controller.h"
+#include "../core/timing_analysis.h"
 
 // Enhanced canvas with zoom and pan capabilities
 class CircuitCanvas : public wxWindow {
 private:
+    ComponentPool::Owner pool;  // Holds the components, so it goes last
     std::vector<std::unique_ptr<CircuitComponent>> components;
+    std::unordered_map<ComponentId, CircuitComponent*> componentsById;
+    ComponentId nextComponentId;
     std::unique_ptr<Wire> currentWire;
-    CircuitComponent* selectedComponent;
+    CircuitComponent* selectedComponent;            // Primary selection, shown in the properties
+    std::vector<CircuitComponent*> selection;       // Everything selected, the primary last
     ComponentType currentTool;
     wxPoint dragStart;
     wxPoint dragStartPos; // Original position of component when drag started
+    wxPoint dragOffset;   // How far the selection has been dragged so far
+    wxPoint dragTarget;   // Latest pointer position, applied once per repaint
+    bool dragMotionPending;
     bool isDragging;
     bool isPanning;
 
+    // Rectangle selection, dragged out from empty space with the select tool
+    bool isRubberBanding;
+    wxPoint rubberBandStart;
+    wxPoint rubberBandEnd;
+
     // Command system for undo/redo
     CommandManager commandManager;
 
+    // Probed signals sampled after every simulation step
+    WaveformRecorder waveformRecorder;
+
+    // Compiled circuit, rebuilt when components or wires change
+    CircuitNetlist netlist;
+    bool netlistDirty;
+
+    // Clocked runs on a worker thread; editing pauses them
+    SimulationController simulation;
+
+    // Static timing, redone on every recompile while the critical path is shown
+    TimingAnalysis timing;
+    CircuitNetlist timingNetlist;   // Flat and unoptimized, analyzed when the simulated one is not
+    bool showCriticalPath;
+    std::vector<const CircuitComponent*> criticalComponents;
+    std::vector<const Wire*> criticalWires;
+
     // View transformation
     double zoomFactor;
     wxPoint panOffset;
@@ -56,6 +90,35 @@ public:
 
     void SetTool(ComponentType tool);
     void SimulateCircuit();
+    void InvalidateNetlist() { netlistDirty = true; }   // Recompile on the next simulation
+
+    // Clocked simulation. While running, the canvas shows the state copied by SampleSimulation.
+    bool RunSimulation(const RunCondition& condition);
+    void PauseSimulation();
+    SimulationStop StepSimulation(const RunCondition& condition);
+    void SampleSimulation();
+    bool IsSimulationRunning() const { return simulation.IsRunning(); }
+    uint64_t GetSimulationCycle() const { return simulation.GetCycle(); }
+    uint32_t FindPinNet(const CircuitComponent* component, size_t pinIndex);
+    SimulationController& GetSimulation() { return simulation; }
+
+    // Propagation delays instead of zero-delay settling; recompiles the circuit
+    void SetTimedMode(bool enabled);
+    bool IsTimedMode() const { return netlist.IsTimedMode(); }
+    const CircuitNetlist& GetNetlist() const { return netlist; }
+
+    // Simplify the compiled circuit before simulating; recompiles the circuit
+    void SetOptimization(bool enabled);
+    bool IsOptimizationEnabled() const { return netlist.IsOptimizationEnabled(); }
+
+    // Static timing analysis of the compiled circuit
+    void AnalyzeTiming();
+    const TimingAnalysis& GetTimingAnalysis() const { return timing; }
+    const CircuitNetlist& GetTimingNetlist() const {
+        return NeedsTimingNetlist() ? timingNetlist : netlist;
+    }
+    void SetShowCriticalPath(bool show);
+    bool GetShowCriticalPath() const { return showCriticalPath; }
 
     // View control methods
     void ZoomIn();
@@ -83,6 +146,16 @@ public:
     void ClearSelection();
     CircuitComponent* GetSelectedComponent() const { return selectedComponent; }
 
+    // Multiple selection; move, rotate and delete apply to all of it as one command
+    void SetSelection(const std::vector<CircuitComponent*>& selected);
+    void ToggleSelection(CircuitComponent* component);
+    void SelectAll();
+    void SelectInRectangle(const wxRect& rect, bool add);   // Components lying wholly inside
+    const std::vector<CircuitComponent*>& GetSelection() const { return selection; }
+    bool HasSelection() const { return !selection.empty(); }
+    void DeleteSelection();
+    void RotateSelection(double degrees);
+
     // Theme customization
     void SetBackgroundColor(const wxColour& color) { backgroundColor = color; Refresh(); }
     void SetGridColor(const wxColour& color) { gridColor = color; Refresh(); }
@@ -91,8 +164,12 @@ public:
     void ClearComponents();
     void AddComponentCopy(const CircuitComponent* component);
     std::unique_ptr<CircuitComponent> CloneComponent(const CircuitComponent* component) const;
+    ComponentPool* GetComponentPool() const { return pool.get(); }  // Make current while adding components
     const std::vector<std::unique_ptr<CircuitComponent>>& GetComponents() const { return components; }
 
+    // Component on the canvas with the given ID, nullptr if it is not there
+    CircuitComponent* FindComponent(ComponentId id) const;
+
     // Command system support methods
     void RemoveComponentDirectly(CircuitComponent* component);
     void InsertComponentAt(size_t index, std::unique_ptr<CircuitComponent> component);
@@ -100,20 +177,45 @@ public:
     void AddComponentDirectly(std::unique_ptr<CircuitComponent> component);
     std::unique_ptr<CircuitComponent> ExtractComponent(CircuitComponent* component);
 
+    // Bulk versions over ascending indices, a single pass over the components each
+    std::vector<std::unique_ptr<CircuitComponent>> ExtractComponents(const std::vector<size_t>& indices);
+    void InsertComponentsAt(const std::vector<size_t>& indices,
+                            std::vector<std::unique_ptr<CircuitComponent>> inserted);
+
     // Access to command manager
     CommandManager& GetCommandManager() { return commandManager; }
 
+    // Waveform probes
+    WaveformRecorder& GetWaveformRecorder() { return waveformRecorder; }
+    int AddWaveformProbes(CircuitComponent* component);
+
 public:
     CircuitComponent* CreateComponent(ComponentType type, const wxPoint& pos);
 
 private:
+    // Moves the selection to the latest drag position, if the pointer moved since
+    void ApplyPendingDrag();
+
     void DrawGrid(wxDC& dc);
     void DrawComponents(wxDC& dc);
     void DrawSelection(wxDC& dc);
+    void DrawCriticalPath(wxDC& dc);
+    void PrepareNetlist();
+    void NotifySelectionChanged();
+    void RegisterComponent(CircuitComponent* component);    // Gives it an ID if it needs one
+    void ForgetComponent(CircuitComponent* component);  // Drops ID and selection, detaches probes
+    // Removed gates and subcircuit models, which switch at once, would hide delays
+    bool NeedsTimingNetlist() const {
+        return netlist.GetOptimizationStats().Total() > 0 || (netlist.GetModelCount() > 0 && !netlist.IsTimedMode());
+    }
+    ComponentLookup GetComponentLookup() const {
+        return [this](ComponentId id) -> const CircuitComponent* { return FindComponent(id); };
+    }
 
     wxDECLARE_EVENT_TABLE();
 
 public:
     // Custom events
     static const wxEventType wxEVT_COMPONENT_SELECTED;
+    static const wxEventType wxEVT_SIMULATION_UPDATED;
 };
\ No newline at end of file
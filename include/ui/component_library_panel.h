@@ -18,6 +18,8 @@ private:
     wxTreeItemId logicGatesId;
     wxTreeItemId arithmeticId;
     wxTreeItemId dataSelectionId;
+    wxTreeItemId busesId;
+    wxTreeItemId memoryId;
     wxTreeItemId sequentialId;
     wxTreeItemId encodersId;
     wxTreeItemId displayId;
@@ -1,8 +1,27 @@
 #pragma once
 #include <wx/wx.h>
+#include <wx/cmdline.h>
 
 // Application class
 class LogisimApp : public wxApp {
+private:
+    // Batch mode: run a circuit file from the command line without a window
+    bool batchMode;
+    bool printTruthTable;
+    bool nativeCode;            // Compile full parallel passes with the system compiler
+    wxString circuitFile;
+    wxString vectorsFile;
+    wxString referenceFile;     // Checked for equivalence with the circuit
+    wxString outputFile;
+
 public:
+    LogisimApp();
+
     bool OnInit() override;
-};
\ No newline at end of file
+    int OnRun() override;
+    void OnInitCmdLine(wxCmdLineParser& parser) override;
+    bool OnCmdLineParsed(wxCmdLineParser& parser) override;
+
+private:
+    int RunBatch();
+};
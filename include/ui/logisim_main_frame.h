@@ -3,9 +3,11 @@
 #include <wx/splitter.h>
 #include <wx/aui/framemanager.h>
 #include <wx/aui/auibook.h>
+#include <chrono>
 #include "circuit_canvas.h"
 #include "properties_panel.h"
 #include "component_library_panel.h"
+#include "waveform_panel.h"
 #include "../core/circuit_document.h"
 #include "../core/command_system.h"
 
@@ -19,16 +21,27 @@ private:
     CircuitCanvas* canvas;
     PropertiesPanel* propertiesPanel;
     ComponentLibraryPanel* libraryPanel;
+    WaveformPanel* waveformPanel;
 
     // View menu items
     wxMenuItem* showGridMenuItem;
     wxMenuItem* snapToGridMenuItem;
     wxMenuItem* showPropertiesMenuItem;
     wxMenuItem* showLibraryMenuItem;
+    wxMenuItem* showWaveformMenuItem;
 
     // File menu items
     wxMenu* recentFilesMenu;
 
+    // Simulation menu items
+    wxMenuItem* nativeCodeMenuItem;
+
+    // Refreshes the canvas from a running simulation
+    static const int SIMULATION_REFRESH_MS = 33;
+    wxTimer simulationTimer;
+    uint64_t lastSampleCycle;
+    std::chrono::steady_clock::time_point lastSampleTime;
+
     // Document and command system
     std::unique_ptr<CircuitDocument> document;
     std::unique_ptr<CommandManager> commandManager;
@@ -41,6 +54,28 @@ public:
     void OnComponentSelected(wxCommandEvent& event);
     void OnCanvasComponentSelected(wxCommandEvent& event);
     void OnSimulate(wxCommandEvent& event);
+    void OnSimulationUpdated(wxCommandEvent& event);
+    void OnComponentPropertiesChanging(wxCommandEvent& event);
+    void OnComponentPropertiesChanged(wxCommandEvent& event);
+    void OnAddWaveformProbe(wxCommandEvent& event);
+    void OnRunTestVectors(wxCommandEvent& event);
+    void OnFaultCoverage(wxCommandEvent& event);
+    void OnTruthTable(wxCommandEvent& event);
+    void OnCheckEquivalence(wxCommandEvent& event);
+    void OnTimedMode(wxCommandEvent& event);
+    void OnOptimizeNetlist(wxCommandEvent& event);
+    void OnShowCriticalPath(wxCommandEvent& event);
+    void OnTimingReport(wxCommandEvent& event);
+    void OnRunSimulation(wxCommandEvent& event);
+    void OnPauseSimulation(wxCommandEvent& event);
+    void OnStepCycle(wxCommandEvent& event);
+    void OnStepCycles(wxCommandEvent& event);
+    void OnRunUntil(wxCommandEvent& event);
+    void OnAddBreakpoint(wxCommandEvent& event);
+    void OnRemoveBreakpoint(wxCommandEvent& event);
+    void OnClearBreakpoints(wxCommandEvent& event);
+    void OnSimulationTimer(wxTimerEvent& event);
+    void OnSimulationStopped(wxCommandEvent& event);
     void OnAbout(wxCommandEvent& event);
     void OnExit(wxCommandEvent& event);
 
@@ -49,6 +84,7 @@ public:
     void OnSnapToGrid(wxCommandEvent& event);
     void OnShowProperties(wxCommandEvent& event);
     void OnShowLibrary(wxCommandEvent& event);
+    void OnShowWaveform(wxCommandEvent& event);
     void OnZoomIn(wxCommandEvent& event);
     void OnZoomOut(wxCommandEvent& event);
     void OnZoomReset(wxCommandEvent& event);
@@ -64,6 +100,7 @@ public:
     void OnSaveFile(wxCommandEvent& event);
     void OnSaveAsFile(wxCommandEvent& event);
     void OnRecentFile(wxCommandEvent& event);
+    void OnPlaceSubcircuit(wxCommandEvent& event);
 
     // Edit menu handlers
     void OnUndo(wxCommandEvent& event);
@@ -71,6 +108,7 @@ public:
     void OnCopy(wxCommandEvent& event);
     void OnPaste(wxCommandEvent& event);
     void OnDelete(wxCommandEvent& event);
+    void OnSelectAll(wxCommandEvent& event);
 
     // Document access
     CircuitDocument* GetDocument() const { return document.get(); }
@@ -86,6 +124,8 @@ private:
     void UpdateTitle();
     void UpdateMenus();
     void UpdateRecentFilesMenu();
+    void StartSimulation(const RunCondition& condition);
+    bool ChoosePin(const wxString& title, CircuitComponent*& component, size_t& pinIndex, uint32_t& net);
 
     // Menu IDs
     enum {
@@ -93,6 +133,26 @@ private:
         ID_SNAP_TO_GRID,
         ID_SHOW_PROPERTIES,
         ID_SHOW_LIBRARY,
+        ID_SHOW_WAVEFORM,
+        ID_ADD_WAVEFORM_PROBE,
+        ID_RUN_TEST_VECTORS,
+        ID_FAULT_COVERAGE,
+        ID_TRUTH_TABLE,
+        ID_CHECK_EQUIVALENCE,
+        ID_NATIVE_CODE,
+        ID_TIMED_MODE,
+        ID_OPTIMIZE_NETLIST,
+        ID_SHOW_CRITICAL_PATH,
+        ID_TIMING_REPORT,
+        ID_RUN_SIMULATION,
+        ID_PAUSE_SIMULATION,
+        ID_STEP_CYCLE,
+        ID_STEP_CYCLES,
+        ID_RUN_UNTIL,
+        ID_ADD_BREAKPOINT,
+        ID_REMOVE_BREAKPOINT,
+        ID_CLEAR_BREAKPOINTS,
+        ID_SIMULATION_TIMER,
         ID_ZOOM_IN,
         ID_ZOOM_OUT,
         ID_ZOOM_RESET,
@@ -100,6 +160,7 @@ private:
         ID_LIGHT_THEME,
         ID_DARK_THEME,
         ID_SAVEAS,  // Custom ID for Save As
+        ID_PLACE_SUBCIRCUIT,
         ID_RECENT_FILE_START = wxID_HIGHEST + 1000  // Range for recent files
     };
 
@@ -36,10 +36,21 @@ private:
     void PopulateMultiplexerProperties();    // For mux/demux components
     void PopulateClockProperties();
     void PopulateDisplayProperties();
+    void PopulateBusProperties();            // For width-parametric bus components
+    void PopulateMemoryProperties();         // For RAM and ROM
+    void PopulateTimingProperties();         // Delays for the timed simulation mode
     void PopulateDefaultProperties();
 
     // Helper methods
     wxString GetComponentName() const;
+    void NotifyComponentChanging();
 
     wxDECLARE_EVENT_TABLE();
+
+public:
+    // Sent before a change that recreates pins or contents the simulation reads
+    static const wxEventType wxEVT_COMPONENT_CHANGING;
+
+    // Sent when a change needs the circuit to be recompiled
+    static const wxEventType wxEVT_COMPONENT_CHANGED;
 };
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include "../core/truth_table.h"
+
+// Virtual list over a TruthTable; rows are formatted only when shown
+class TruthTableListCtrl : public wxListCtrl {
+private:
+    const TruthTable& table;
+
+public:
+    TruthTableListCtrl(wxWindow* parent, const TruthTable& truthTable);
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+};
+
+// Modal view of a generated truth table with CSV export
+class TruthTableDialog : public wxDialog {
+private:
+    const TruthTable& table;
+
+public:
+    TruthTableDialog(wxWindow* parent, const TruthTable& truthTable);
+
+private:
+    void OnSaveCSV(wxCommandEvent& event);
+
+    enum {
+        ID_TRUTH_TABLE_SAVE_CSV = wxID_HIGHEST + 2100
+    };
+
+    wxDECLARE_EVENT_TABLE();
+};
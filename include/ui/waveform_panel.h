@@ -0,0 +1,79 @@
+#pragma once
+#include <wx/wx.h>
+#include <cstdint>
+#include "../core/waveform_recorder.h"
+
+// Dockable waveform viewer for probed signals.
+// Only the visible time window is drawn and every pixel column is reduced to
+// at most one edge or one "busy" bar, so paint cost depends on the panel
+// width rather than on the number of recorded cycles.
+class WaveformPanel : public wxPanel {
+private:
+    WaveformRecorder* recorder;
+    wxStaticText* titleLabel;
+    wxWindow* traceArea;
+    wxScrollBar* timeScrollBar;
+
+    // Time axis view state
+    double viewStart;       // First visible cycle
+    double cyclesPerPixel;  // Horizontal zoom level
+    bool followLatest;      // Keep the newest samples in view while simulating
+    uint64_t scrollUnit;    // Cycles per scrollbar unit (keeps the range within int)
+    unsigned long lastRevision;
+
+    // Mouse panning
+    bool isPanning;
+    int lastPanX;
+
+public:
+    WaveformPanel(wxWindow* parent);
+
+    void SetRecorder(WaveformRecorder* rec);
+    void RefreshTraces();
+
+    // View control methods
+    void ZoomIn();
+    void ZoomOut();
+    void ZoomToFit();
+
+private:
+    void OnPaintTraces(wxPaintEvent& event);
+    void OnTraceSize(wxSizeEvent& event);
+    void OnTraceMouseWheel(wxMouseEvent& event);
+    void OnTraceLeftDown(wxMouseEvent& event);
+    void OnTraceLeftUp(wxMouseEvent& event);
+    void OnTraceMouseMove(wxMouseEvent& event);
+    void OnTraceRightDown(wxMouseEvent& event);
+    void OnScroll(wxScrollEvent& event);
+    void OnZoomInButton(wxCommandEvent& event);
+    void OnZoomOutButton(wxCommandEvent& event);
+    void OnZoomFitButton(wxCommandEvent& event);
+    void OnClearButton(wxCommandEvent& event);
+
+    // Drawing helpers
+    void DrawTimeAxis(wxDC& dc, int width);
+    void DrawTrace(wxDC& dc, const WaveformTrace& trace, int top, int width);
+
+    // View helpers
+    void ZoomAround(double factor, int plotX);
+    void ClampView();
+    void UpdateScrollBar();
+    int GetPlotWidth() const;
+    double GetVisibleCycles() const;
+    uint64_t ColumnBoundary(int column) const;
+
+    // Layout constants
+    static const int NAME_COLUMN_WIDTH = 130;
+    static const int AXIS_HEIGHT = 20;
+    static const int ROW_HEIGHT = 28;
+
+    enum {
+        ID_WAVE_ZOOM_IN = wxID_HIGHEST + 2000,
+        ID_WAVE_ZOOM_OUT,
+        ID_WAVE_ZOOM_FIT,
+        ID_WAVE_CLEAR,
+        ID_WAVE_SCROLL
+    };
+
+    wxDECLARE_EVENT_TABLE();
+};
@@ -8,12 +8,12 @@ ArithmeticComponent::ArithmeticComponent(const wxPoint& pos, const wxSize& sz, C
 HalfAdder::HalfAdder(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(60, 50), ComponentType::HALF_ADDER, "HA") {
     // Create input pins: A and B
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));      // A
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 35), true));      // B
+    pins.push_back(Pin(wxPoint(0, 10), true));      // A
+    pins.push_back(Pin(wxPoint(0, 35), true));      // B
 
     // Create output pins: Sum and Carry
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 15), false));  // Sum
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 35), false));  // Carry
+    pins.push_back(Pin(wxPoint(60, 15), false));  // Sum
+    pins.push_back(Pin(wxPoint(60, 35), false));  // Carry
 }
 
 void HalfAdder::Draw(wxDC& dc) {
@@ -38,7 +38,7 @@ void HalfAdder::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -66,13 +66,13 @@ void HalfAdder::ComputeOutputs() {
 FullAdder::FullAdder(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(60, 60), ComponentType::FULL_ADDER, "FA") {
     // Create input pins: A, B, Cin
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));      // A
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));      // B
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 50), true));      // Cin
+    pins.push_back(Pin(wxPoint(0, 10), true));      // A
+    pins.push_back(Pin(wxPoint(0, 30), true));      // B
+    pins.push_back(Pin(wxPoint(0, 50), true));      // Cin
 
     // Create output pins: Sum and Cout
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));  // Sum
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 40), false));  // Cout
+    pins.push_back(Pin(wxPoint(60, 20), false));  // Sum
+    pins.push_back(Pin(wxPoint(60, 40), false));  // Cout
 }
 
 void FullAdder::Draw(wxDC& dc) {
@@ -98,7 +98,7 @@ void FullAdder::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -126,18 +126,18 @@ Adder4Bit::Adder4Bit(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(80, 120), ComponentType::ADDER_4BIT, "4-bit ADD") {
     // Create input pins: A3-A0, B3-B0, Cin
     for (int i = 0; i < 4; i++) {
-        pins.push_back(Pin(wxPoint(pos.x, pos.y + 10 + i * 20), true));  // A3-A0
+        pins.push_back(Pin(wxPoint(0, 10 + i * 20), true));  // A3-A0
     }
     for (int i = 0; i < 4; i++) {
-        pins.push_back(Pin(wxPoint(pos.x, pos.y + 90 + i * 20), true));  // B3-B0
+        pins.push_back(Pin(wxPoint(0, 90 + i * 20), true));  // B3-B0
     }
-    pins.push_back(Pin(wxPoint(pos.x + 40, pos.y + 170), true));         // Cin
+    pins.push_back(Pin(wxPoint(40, 170), true));         // Cin
 
     // Create output pins: S3-S0, Cout
     for (int i = 0; i < 4; i++) {
-        pins.push_back(Pin(wxPoint(pos.x + 80, pos.y + 20 + i * 20), false)); // S3-S0
+        pins.push_back(Pin(wxPoint(80, 20 + i * 20), false)); // S3-S0
     }
-    pins.push_back(Pin(wxPoint(pos.x + 40, pos.y), false));              // Cout
+    pins.push_back(Pin(wxPoint(40, 0), false));              // Cout
 }
 
 void Adder4Bit::Draw(wxDC& dc) {
@@ -166,7 +166,7 @@ void Adder4Bit::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -198,12 +198,12 @@ void Adder4Bit::ComputeOutputs() {
 Multiplexer2to1::Multiplexer2to1(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(50, 60), ComponentType::MULTIPLEXER_2TO1, "MUX") {
     // Input pins: I0, I1, S
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 15), true));      // I0
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 35), true));      // I1
-    pins.push_back(Pin(wxPoint(pos.x + 25, pos.y + 60), true)); // Select
+    pins.push_back(Pin(wxPoint(0, 15), true));      // I0
+    pins.push_back(Pin(wxPoint(0, 35), true));      // I1
+    pins.push_back(Pin(wxPoint(25, 60), true)); // Select
 
     // Output pin: Y
-    pins.push_back(Pin(wxPoint(pos.x + 50, pos.y + 25), false)); // Y
+    pins.push_back(Pin(wxPoint(50, 25), false)); // Y
 }
 
 void Multiplexer2to1::Draw(wxDC& dc) {
@@ -235,7 +235,7 @@ void Multiplexer2to1::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -255,15 +255,15 @@ void Multiplexer2to1::ComputeOutputs() {
 Multiplexer4to1::Multiplexer4to1(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(60, 80), ComponentType::MULTIPLEXER_4TO1, "MUX") {
     // Input pins: I0, I1, I2, I3, S0, S1
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));      // I0
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 25), true));      // I1
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 40), true));      // I2
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 55), true));      // I3
-    pins.push_back(Pin(wxPoint(pos.x + 15, pos.y + 80), true)); // S0
-    pins.push_back(Pin(wxPoint(pos.x + 35, pos.y + 80), true)); // S1
+    pins.push_back(Pin(wxPoint(0, 10), true));      // I0
+    pins.push_back(Pin(wxPoint(0, 25), true));      // I1
+    pins.push_back(Pin(wxPoint(0, 40), true));      // I2
+    pins.push_back(Pin(wxPoint(0, 55), true));      // I3
+    pins.push_back(Pin(wxPoint(15, 80), true)); // S0
+    pins.push_back(Pin(wxPoint(35, 80), true)); // S1
 
     // Output pin: Y
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 32), false)); // Y
+    pins.push_back(Pin(wxPoint(60, 32), false)); // Y
 }
 
 void Multiplexer4to1::Draw(wxDC& dc) {
@@ -298,7 +298,7 @@ void Multiplexer4to1::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -321,12 +321,12 @@ void Multiplexer4to1::ComputeOutputs() {
 Demultiplexer1to2::Demultiplexer1to2(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(50, 60), ComponentType::DEMULTIPLEXER_1TO2, "DEMUX") {
     // Input pins: I, S
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 25), true));      // I
-    pins.push_back(Pin(wxPoint(pos.x + 25, pos.y + 60), true)); // Select
+    pins.push_back(Pin(wxPoint(0, 25), true));      // I
+    pins.push_back(Pin(wxPoint(25, 60), true)); // Select
 
     // Output pins: Y0, Y1
-    pins.push_back(Pin(wxPoint(pos.x + 50, pos.y + 15), false)); // Y0
-    pins.push_back(Pin(wxPoint(pos.x + 50, pos.y + 35), false)); // Y1
+    pins.push_back(Pin(wxPoint(50, 15), false)); // Y0
+    pins.push_back(Pin(wxPoint(50, 35), false)); // Y1
 }
 
 void Demultiplexer1to2::Draw(wxDC& dc) {
@@ -358,7 +358,7 @@ void Demultiplexer1to2::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -382,15 +382,15 @@ void Demultiplexer1to2::ComputeOutputs() {
 Demultiplexer1to4::Demultiplexer1to4(const wxPoint& pos)
     : ArithmeticComponent(pos, wxSize(60, 80), ComponentType::DEMULTIPLEXER_1TO4, "DEMUX") {
     // Input pins: I, S0, S1
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 32), true));      // I
-    pins.push_back(Pin(wxPoint(pos.x + 15, pos.y + 80), true)); // S0
-    pins.push_back(Pin(wxPoint(pos.x + 35, pos.y + 80), true)); // S1
+    pins.push_back(Pin(wxPoint(0, 32), true));      // I
+    pins.push_back(Pin(wxPoint(15, 80), true)); // S0
+    pins.push_back(Pin(wxPoint(35, 80), true)); // S1
 
     // Output pins: Y0, Y1, Y2, Y3
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 10), false)); // Y0
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 25), false)); // Y1
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 40), false)); // Y2
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 55), false)); // Y3
+    pins.push_back(Pin(wxPoint(60, 10), false)); // Y0
+    pins.push_back(Pin(wxPoint(60, 25), false)); // Y1
+    pins.push_back(Pin(wxPoint(60, 40), false)); // Y2
+    pins.push_back(Pin(wxPoint(60, 55), false)); // Y3
 }
 
 void Demultiplexer1to4::Draw(wxDC& dc) {
@@ -425,7 +425,7 @@ void Demultiplexer1to4::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -0,0 +1,593 @@
+#include "../../include/components/bus_components.h"
+#include <algorithm>
+
+namespace {
+
+const int LINE_SPACING = 10;
+
+LogicValue LineValue(const BusValue& value, int line) {
+    if ((value.undefined >> line) & 1) return LogicValue::UNDEFINED;
+    return ((value.bits >> line) & 1) ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+// Undefined lines count as LOW, like in the fixed-width arithmetic blocks
+uint64_t DefinedBits(const Pin& pin) {
+    BusValue value = ReadBus(pin);
+    return value.bits & ~value.undefined & BusMask(pin.width);
+}
+
+BusValue DefinedBus(uint64_t bits, int width) {
+    BusValue value = { bits & BusMask(width), 0 };
+    return value;
+}
+
+// a + b + carry in over width bits. A 64-bit carry out shows up as wrap-around.
+uint64_t AddWithCarry(uint64_t a, uint64_t b, uint64_t carryIn, int width, bool& carryOut) {
+    uint64_t partial = a + b;
+    uint64_t sum = partial + carryIn;
+    carryOut = width >= 64 ? (partial < a || sum < partial) : ((sum >> width) & 1) != 0;
+    return sum & BusMask(width);
+}
+
+// Shifts by the full word width or more are defined here, unlike in C++
+uint64_t ShiftLeft(uint64_t value, uint64_t amount) {
+    return amount >= 64 ? 0 : value << amount;
+}
+
+uint64_t ShiftRight(uint64_t value, uint64_t amount) {
+    return amount >= 64 ? 0 : value >> amount;
+}
+
+int64_t SignExtend(uint64_t value, int width) {
+    if (width >= 64) return static_cast<int64_t>(value);
+    uint64_t sign = uint64_t(1) << (width - 1);
+    return static_cast<int64_t>((value ^ sign) - sign);
+}
+
+// Full 128-bit product from 32-bit halves, portable across compilers
+void MultiplyWide(uint64_t a, uint64_t b, uint64_t& low, uint64_t& high) {
+    uint64_t aLow = a & 0xFFFFFFFFull, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFFull, bHigh = b >> 32;
+
+    uint64_t lowLow = aLow * bLow;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t highHigh = aHigh * bHigh;
+
+    uint64_t middle = (lowLow >> 32) + (highLow & 0xFFFFFFFFull) + (lowHigh & 0xFFFFFFFFull);
+    low = (middle << 32) | (lowLow & 0xFFFFFFFFull);
+    high = highHigh + (highLow >> 32) + (lowHigh >> 32) + (middle >> 32);
+}
+
+// Draws a block body with its name, like the fixed-width arithmetic blocks
+void DrawBody(wxDC& dc, const wxPoint& position, const wxSize& size, bool selected,
+              const wxColour& fill, const wxString& label) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(fill));
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+    dc.DrawText(label, position.x + (size.x - dc.GetTextExtent(label).x) / 2, position.y + size.y / 2 - 8);
+}
+
+void DrawPinLabel(wxDC& dc, const CircuitComponent& component, const wxString& text, const Pin& pin) {
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    wxPoint at = component.GetPinLayoutPosition(pin);
+    int x = pin.isInput ? at.x + 4 : at.x - 4 - dc.GetTextExtent(text).x;
+    dc.DrawText(text, x, at.y - 5);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+}
+
+} // namespace
+
+void DrawComponentPins(wxDC& dc, const CircuitComponent& component) {
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    for (const auto& pin : component.GetPins()) {
+        dc.SetPen(*wxBLACK_PEN);
+        dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
+        wxPoint at = component.GetPinLayoutPosition(pin);
+        if (pin.width > 1) {
+            dc.DrawRectangle(at.x - 4, at.y - 4, 8, 8);
+            dc.DrawText(wxString::Format("/%d", pin.width), at.x + (pin.isInput ? -18 : 6), at.y - 12);
+        } else {
+            dc.DrawCircle(at, 3);
+        }
+    }
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+}
+
+const int BusComponent::MIN_WIDTH;
+const int BusComponent::MAX_WIDTH;
+const int BusComponent::DEFAULT_WIDTH;
+
+BusComponent::BusComponent(const wxPoint& pos, const wxSize& sz, ComponentType t, int bits)
+    : CircuitComponent(pos, sz, t), width(std::max(MIN_WIDTH, std::min(MAX_WIDTH, bits))) {
+}
+
+void BusComponent::SetDataWidth(int bits) {
+    width = std::max(MIN_WIDTH, std::min(MAX_WIDTH, bits));
+    pins.clear();
+    CreatePins();
+}
+
+void BusComponent::DrawPins(wxDC& dc) const {
+    DrawComponentPins(dc, *this);
+}
+
+// Bus Splitter Implementation
+BusSplitter::BusSplitter(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(30, 20), ComponentType::BUS_SPLITTER, bits) {
+    CreatePins();
+}
+
+void BusSplitter::CreatePins() {
+    size = wxSize(30, width * LINE_SPACING + LINE_SPACING);
+    UpdateTransform();
+
+    // Input pin: the bus
+    pins.push_back(Pin(wxPoint(0, (width + 1) / 2 * LINE_SPACING), true, width));
+
+    // Output pins: one per line
+    for (int i = 0; i < width; i++) {
+        pins.push_back(Pin(wxPoint(size.x, LINE_SPACING + i * LINE_SPACING), false));
+    }
+}
+
+void BusSplitter::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : wxPen(*wxBLACK, 3));
+    dc.DrawLine(position.x + 10, position.y + 5, position.x + 10, position.y + size.y - 5);
+    wxPoint input = GetPinLayoutPosition(pins[0]);
+    dc.DrawLine(input, wxPoint(position.x + 10, input.y));
+
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    for (size_t i = 1; i < pins.size(); i++) {
+        wxPoint line = GetPinLayoutPosition(pins[i]);
+        dc.DrawLine(position.x + 10, line.y, line.x, line.y);
+    }
+
+    DrawPins(dc);
+}
+
+void BusSplitter::ComputeOutputs() {
+    for (int i = 0; i < width; i++) {
+        pins[1 + i].value = LineValue(ReadBus(pins[0]), i);
+    }
+}
+
+// Bus Joiner Implementation
+BusJoiner::BusJoiner(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(30, 20), ComponentType::BUS_JOINER, bits) {
+    CreatePins();
+}
+
+void BusJoiner::CreatePins() {
+    size = wxSize(30, width * LINE_SPACING + LINE_SPACING);
+    UpdateTransform();
+
+    // Input pins: one per line
+    for (int i = 0; i < width; i++) {
+        pins.push_back(Pin(wxPoint(0, LINE_SPACING + i * LINE_SPACING), true));
+    }
+
+    // Output pin: the bus
+    pins.push_back(Pin(wxPoint(size.x, (width + 1) / 2 * LINE_SPACING), false, width));
+}
+
+void BusJoiner::Draw(wxDC& dc) {
+    wxPoint output = GetPinLayoutPosition(pins[width]);
+
+    dc.SetPen(selected ? *wxRED_PEN : wxPen(*wxBLACK, 3));
+    dc.DrawLine(position.x + 20, position.y + 5, position.x + 20, position.y + size.y - 5);
+    dc.DrawLine(wxPoint(position.x + 20, output.y), output);
+
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    for (int i = 0; i < width; i++) {
+        wxPoint line = GetPinLayoutPosition(pins[i]);
+        dc.DrawLine(line.x, line.y, position.x + 20, line.y);
+    }
+
+    DrawPins(dc);
+}
+
+void BusJoiner::ComputeOutputs() {
+    BusValue result = { 0, 0 };
+    for (int i = 0; i < width; i++) {
+        if (pins[i].value == LogicValue::HIGH) result.bits |= uint64_t(1) << i;
+        if (pins[i].value == LogicValue::UNDEFINED) result.undefined |= uint64_t(1) << i;
+    }
+    WriteBus(pins[width], result);
+}
+
+// N-bit Adder Implementation
+BusAdder::BusAdder(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(70, 80), ComponentType::BUS_ADDER, bits) {
+    CreatePins();
+}
+
+void BusAdder::CreatePins() {
+    // Input pins: A, B, Cin
+    pins.push_back(Pin(wxPoint(0, 20), true, width));  // A
+    pins.push_back(Pin(wxPoint(0, 40), true, width));  // B
+    pins.push_back(Pin(wxPoint(0, 60), true));         // Cin
+
+    // Output pins: Sum, Cout
+    pins.push_back(Pin(wxPoint(70, 30), false, width)); // S
+    pins.push_back(Pin(wxPoint(70, 50), false));        // Cout
+}
+
+void BusAdder::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(wxColour(220, 255, 255)));
+
+    // Draw main body
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    // Draw label
+    dc.DrawText(wxString::Format("%d-bit", width), position.x + 15, position.y + 25);
+    dc.DrawText("ADDER", position.x + 15, position.y + 40);
+
+    // Draw pin labels
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("A", position.x + 3, position.y + 15);
+    dc.DrawText("B", position.x + 3, position.y + 35);
+    dc.DrawText("Cin", position.x + 3, position.y + 55);
+    dc.DrawText("S", position.x + 60, position.y + 25);
+    dc.DrawText("Co", position.x + 55, position.y + 45);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void BusAdder::ComputeOutputs() {
+    uint64_t cin = (pins[2].value == LogicValue::HIGH) ? 1 : 0;
+
+    bool carry;
+    WriteBus(pins[3], DefinedBus(AddWithCarry(DefinedBits(pins[0]), DefinedBits(pins[1]), cin, width, carry), width));
+    pins[4].value = carry ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+// N-bit Multiplexer 4-to-1 Implementation
+BusMultiplexer4to1::BusMultiplexer4to1(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(60, 100), ComponentType::BUS_MULTIPLEXER_4TO1, bits) {
+    CreatePins();
+}
+
+void BusMultiplexer4to1::CreatePins() {
+    // Input pins: I0-I3, S0, S1
+    for (int i = 0; i < 4; i++) {
+        pins.push_back(Pin(wxPoint(0, 20 + i * 20), true, width)); // I0-I3
+    }
+    pins.push_back(Pin(wxPoint(20, 100), true));  // S0
+    pins.push_back(Pin(wxPoint(40, 100), true));  // S1
+
+    // Output pin: Y
+    pins.push_back(Pin(wxPoint(60, 50), false, width));
+}
+
+void BusMultiplexer4to1::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(wxColour(255, 255, 220)));
+
+    // Draw main body
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    // Draw label
+    dc.DrawText("MUX", position.x + 15, position.y + 40);
+
+    // Draw pin labels
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    for (int i = 0; i < 4; i++) {
+        dc.DrawText(wxString::Format("I%d", i), position.x + 3, position.y + 15 + i * 20);
+    }
+    dc.DrawText("S0", position.x + 15, position.y + 88);
+    dc.DrawText("S1", position.x + 35, position.y + 88);
+    dc.DrawText("Y", position.x + 50, position.y + 45);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void BusMultiplexer4to1::ComputeOutputs() {
+    int select = (pins[4].value == LogicValue::HIGH ? 1 : 0) | (pins[5].value == LogicValue::HIGH ? 2 : 0);
+    WriteBus(pins[6], ReadBus(pins[select]));
+}
+
+// N-bit Magnitude Comparator Implementation
+BusComparator::BusComparator(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(70, 80), ComponentType::BUS_COMPARATOR, bits) {
+    CreatePins();
+}
+
+void BusComparator::CreatePins() {
+    // Input pins: A, B
+    pins.push_back(Pin(wxPoint(0, 25), true, width));  // A
+    pins.push_back(Pin(wxPoint(0, 55), true, width));  // B
+
+    // Output pins: A>B, A=B, A<B
+    pins.push_back(Pin(wxPoint(70, 20), false));
+    pins.push_back(Pin(wxPoint(70, 40), false));
+    pins.push_back(Pin(wxPoint(70, 60), false));
+}
+
+void BusComparator::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(wxColour(240, 240, 255)));
+
+    // Draw main body
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    // Draw label
+    dc.DrawText("CMP", position.x + 20, position.y + 32);
+
+    // Draw pin labels
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("A", position.x + 3, position.y + 20);
+    dc.DrawText("B", position.x + 3, position.y + 50);
+    dc.DrawText(">", position.x + 60, position.y + 15);
+    dc.DrawText("=", position.x + 60, position.y + 35);
+    dc.DrawText("<", position.x + 60, position.y + 55);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void BusComparator::ComputeOutputs() {
+    uint64_t a = DefinedBits(pins[0]);
+    uint64_t b = DefinedBits(pins[1]);
+
+    pins[2].value = a > b ? LogicValue::HIGH : LogicValue::LOW;
+    pins[3].value = a == b ? LogicValue::HIGH : LogicValue::LOW;
+    pins[4].value = a < b ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+// N-bit Subtractor Implementation
+BusSubtractor::BusSubtractor(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(70, 80), ComponentType::BUS_SUBTRACTOR, bits) {
+    CreatePins();
+}
+
+void BusSubtractor::CreatePins() {
+    // Input pins: A, B, Bin
+    pins.push_back(Pin(wxPoint(0, 20), true, width));  // A
+    pins.push_back(Pin(wxPoint(0, 40), true, width));  // B
+    pins.push_back(Pin(wxPoint(0, 60), true));         // Bin
+
+    // Output pins: Difference, Bout
+    pins.push_back(Pin(wxPoint(70, 30), false, width)); // D
+    pins.push_back(Pin(wxPoint(70, 50), false));        // Bout
+}
+
+void BusSubtractor::Draw(wxDC& dc) {
+    DrawBody(dc, position, size, selected, wxColour(220, 255, 255), wxString::Format("%d-bit SUB", width));
+    DrawPinLabel(dc, *this, "A", pins[0]);
+    DrawPinLabel(dc, *this, "B", pins[1]);
+    DrawPinLabel(dc, *this, "Bin", pins[2]);
+    DrawPinLabel(dc, *this, "D", pins[3]);
+    DrawPinLabel(dc, *this, "Bo", pins[4]);
+    DrawPins(dc);
+}
+
+void BusSubtractor::ComputeOutputs() {
+    // A - B - bin is A + ~B + !bin; the borrow is the inverted carry
+    uint64_t carryIn = (pins[2].value == LogicValue::HIGH) ? 0 : 1;
+
+    bool carry;
+    WriteBus(pins[3], DefinedBus(AddWithCarry(DefinedBits(pins[0]), ~DefinedBits(pins[1]) & BusMask(width),
+                                          carryIn, width, carry), width));
+    pins[4].value = carry ? LogicValue::LOW : LogicValue::HIGH;
+}
+
+// N-bit Multiplier Implementation
+BusMultiplier::BusMultiplier(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(70, 80), ComponentType::BUS_MULTIPLIER, bits) {
+    CreatePins();
+}
+
+void BusMultiplier::CreatePins() {
+    // Input pins: A, B
+    pins.push_back(Pin(wxPoint(0, 25), true, width));  // A
+    pins.push_back(Pin(wxPoint(0, 55), true, width));  // B
+
+    // Output pins: low and high halves of the product
+    pins.push_back(Pin(wxPoint(70, 25), false, width)); // P low
+    pins.push_back(Pin(wxPoint(70, 55), false, width)); // P high
+}
+
+void BusMultiplier::Draw(wxDC& dc) {
+    DrawBody(dc, position, size, selected, wxColour(220, 255, 255), wxString::Format("%d-bit MUL", width));
+    DrawPinLabel(dc, *this, "A", pins[0]);
+    DrawPinLabel(dc, *this, "B", pins[1]);
+    DrawPinLabel(dc, *this, "Lo", pins[2]);
+    DrawPinLabel(dc, *this, "Hi", pins[3]);
+    DrawPins(dc);
+}
+
+void BusMultiplier::ComputeOutputs() {
+    uint64_t low, high;
+    MultiplyWide(DefinedBits(pins[0]), DefinedBits(pins[1]), low, high);
+
+    // The product has 2 * width bits; split it at width
+    if (width < 64) {
+        high = (low >> width) | ShiftLeft(high, 64 - width);
+    }
+    WriteBus(pins[2], DefinedBus(low, width));
+    WriteBus(pins[3], DefinedBus(high, width));
+}
+
+// N-bit Barrel Shifter Implementation
+BusShifter::BusShifter(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(70, 80), ComponentType::BUS_SHIFTER, bits) {
+    CreatePins();
+}
+
+int BusShifter::GetShiftWidth(int bits) {
+    // Enough lines to shift by width - 1
+    int shiftWidth = 1;
+    while ((1 << shiftWidth) < bits) {
+        ++shiftWidth;
+    }
+    return shiftWidth;
+}
+
+void BusShifter::CreatePins() {
+    // Input pins: A, shift amount, right, arithmetic
+    pins.push_back(Pin(wxPoint(0, 25), true, width));                 // A
+    pins.push_back(Pin(wxPoint(0, 55), true, GetShiftWidth(width)));  // SH
+    pins.push_back(Pin(wxPoint(25, 80), true));                   // R
+    pins.push_back(Pin(wxPoint(45, 80), true));                   // AR
+
+    // Output pin: Y
+    pins.push_back(Pin(wxPoint(70, 40), false, width));
+}
+
+void BusShifter::Draw(wxDC& dc) {
+    DrawBody(dc, position, size, selected, wxColour(255, 255, 220), "SHIFT");
+    DrawPinLabel(dc, *this, "A", pins[0]);
+    DrawPinLabel(dc, *this, "SH", pins[1]);
+    DrawPinLabel(dc, *this, "Y", pins[4]);
+
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("R", GetPinLayoutPosition(pins[2]).x - 3, GetPinLayoutPosition(pins[2]).y - 14);
+    dc.DrawText("AR", GetPinLayoutPosition(pins[3]).x - 5, GetPinLayoutPosition(pins[3]).y - 14);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void BusShifter::ComputeOutputs() {
+    uint64_t a = DefinedBits(pins[0]);
+    uint64_t amount = DefinedBits(pins[1]);
+    bool right = pins[2].value == LogicValue::HIGH;
+    bool arithmetic = pins[3].value == LogicValue::HIGH;
+
+    uint64_t result;
+    if (!right) {
+        result = ShiftLeft(a, amount);
+    } else if (arithmetic) {
+        // Shifting the sign-extended value fills with the sign bit
+        int64_t value = SignExtend(a, width);
+        result = static_cast<uint64_t>(value >> std::min<uint64_t>(amount, 63));
+    } else {
+        result = ShiftRight(a, amount);
+    }
+    WriteBus(pins[4], DefinedBus(result, width));
+}
+
+// N-bit ALU Implementation
+BusALU::BusALU(const wxPoint& pos, int bits)
+    : BusComponent(pos, wxSize(80, 100), ComponentType::BUS_ALU, bits) {
+    CreatePins();
+}
+
+void BusALU::CreatePins() {
+    // Input pins: A, B, opcode
+    pins.push_back(Pin(wxPoint(0, 30), true, width));        // A
+    pins.push_back(Pin(wxPoint(0, 70), true, width));        // B
+    pins.push_back(Pin(wxPoint(40, 100), true, 3));      // OP
+
+    // Output pins: Y, carry, zero
+    pins.push_back(Pin(wxPoint(80, 30), false, width));  // Y
+    pins.push_back(Pin(wxPoint(80, 60), false));         // C
+    pins.push_back(Pin(wxPoint(80, 80), false));         // Z
+}
+
+void BusALU::Draw(wxDC& dc) {
+    DrawBody(dc, position, size, selected, wxColour(255, 235, 220), wxString::Format("%d-bit ALU", width));
+    DrawPinLabel(dc, *this, "A", pins[0]);
+    DrawPinLabel(dc, *this, "B", pins[1]);
+    DrawPinLabel(dc, *this, "Y", pins[3]);
+    DrawPinLabel(dc, *this, "C", pins[4]);
+    DrawPinLabel(dc, *this, "Z", pins[5]);
+
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("OP", GetPinLayoutPosition(pins[2]).x - 6, GetPinLayoutPosition(pins[2]).y - 14);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void BusALU::ComputeOutputs() {
+    uint64_t a = DefinedBits(pins[0]);
+    uint64_t b = DefinedBits(pins[1]);
+    uint64_t mask = BusMask(width);
+
+    uint64_t result = 0;
+    bool carry = false;
+    switch (static_cast<Opcode>(DefinedBits(pins[2]))) {
+        case OP_ADD:
+            result = AddWithCarry(a, b, 0, width, carry);
+            break;
+        case OP_SUB:
+            // Carry is the borrow
+            result = AddWithCarry(a, ~b & mask, 1, width, carry);
+            carry = !carry;
+            break;
+        case OP_AND: result = a & b; break;
+        case OP_OR:  result = a | b; break;
+        case OP_XOR: result = a ^ b; break;
+        case OP_SHL: result = ShiftLeft(a, b); break;
+        case OP_SHR: result = ShiftRight(a, b); break;
+        case OP_SLT:
+            result = SignExtend(a, width) < SignExtend(b, width) ? 1 : 0;
+            break;
+    }
+
+    WriteBus(pins[3], DefinedBus(result, width));
+    pins[4].value = carry ? LogicValue::HIGH : LogicValue::LOW;
+    pins[5].value = (result & mask) == 0 ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+// N-bit Register Implementation
+BusRegister::BusRegister(const wxPoint& pos, int bits)
+    : SequentialComponent(pos, wxSize(70, 80), ComponentType::BUS_REGISTER),
+      width(std::max(BusComponent::MIN_WIDTH, std::min(BusComponent::MAX_WIDTH, bits))), stored{ 0, 0 } {
+    CreatePins();
+}
+
+void BusRegister::CreatePins() {
+    // D input, Clock input, Q output
+    pins.emplace_back(wxPoint(0, 20), true, width);       // D
+    pins.emplace_back(wxPoint(0, 60), true);              // Clock
+    pins.emplace_back(wxPoint(70, 20), false, width); // Q
+    WriteBus(pins[2], stored);
+}
+
+void BusRegister::SetDataWidth(int bits) {
+    width = std::max(BusComponent::MIN_WIDTH, std::min(BusComponent::MAX_WIDTH, bits));
+    stored.bits &= BusMask(width);
+    stored.undefined &= BusMask(width);
+    pins.clear();
+    CreatePins();
+}
+
+void BusRegister::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(*wxWHITE));
+
+    // Draw main body
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    // Draw label and the stored value
+    dc.DrawText("REG", position.x + 22, position.y + 5);
+    dc.SetFont(wxFont(7, wxFONTFAMILY_TELETYPE, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText(stored.undefined ? wxString("?") : wxString::Format("%llX", (unsigned long long)stored.bits),
+                position.x + 15, position.y + 35);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    // Draw clock triangle
+    wxPoint triangle[] = {
+        wxPoint(position.x, position.y + 65),
+        wxPoint(position.x + 10, position.y + 60),
+        wxPoint(position.x, position.y + 55)
+    };
+    dc.DrawPolygon(3, triangle);
+
+    DrawComponentPins(dc, *this);
+}
+
+void BusRegister::UpdateOnClock() {
+    if (IsClockTriggered(pins[1].value)) {
+        stored = ReadBus(pins[0]);
+        stored.bits &= BusMask(width);
+        stored.undefined &= BusMask(width);
+    }
+    WriteBus(pins[2], stored);
+}
@@ -3,24 +3,87 @@
 #include <algorithm>
 
 CircuitComponent::CircuitComponent(const wxPoint& pos, const wxSize& sz, ComponentType t)
-    : position(pos), size(sz), selected(false), type(t), rotation(0.0), scaleX(1.0), scaleY(1.0) {
+    : id(NO_COMPONENT_ID), position(pos), size(sz), selected(false), type(t), rotation(0.0), scaleX(1.0), scaleY(1.0),
+      delay{ 0, 0 }, customDelay(false) {
+    UpdateTransform();
+}
+
+PropagationDelay CircuitComponent::GetDefaultDelay(ComponentType type) {
+    // Roughly in inverter delays; sources, sinks and wires are instantaneous
+    switch (type) {
+        case ComponentType::NOT_GATE:
+        case ComponentType::BUFFER:
+        case ComponentType::NAND_GATE:
+        case ComponentType::NOR_GATE:
+            return PropagationDelay{ 1, 1 };
+        case ComponentType::AND_GATE:
+        case ComponentType::OR_GATE:
+            return PropagationDelay{ 2, 2 };
+        case ComponentType::XOR_GATE:
+        case ComponentType::XNOR_GATE:
+            return PropagationDelay{ 3, 3 };
+        case ComponentType::HALF_ADDER:
+        case ComponentType::MULTIPLEXER_2TO1:
+        case ComponentType::DEMULTIPLEXER_1TO2:
+        case ComponentType::DECODER_2TO4:
+        case ComponentType::ENCODER_4TO2:
+        case ComponentType::BUS_SPLITTER:
+        case ComponentType::BUS_JOINER:
+            return PropagationDelay{ 3, 3 };
+        case ComponentType::FULL_ADDER:
+        case ComponentType::MULTIPLEXER_4TO1:
+        case ComponentType::DEMULTIPLEXER_1TO4:
+        case ComponentType::DECODER_3TO8:
+        case ComponentType::DECODER_4TO16:
+        case ComponentType::ENCODER_8TO3:
+        case ComponentType::PRIORITY_ENCODER:
+        case ComponentType::BCD_TO_7SEGMENT:
+        case ComponentType::BUS_MULTIPLEXER_4TO1:
+            return PropagationDelay{ 5, 5 };
+        case ComponentType::D_FLIPFLOP:
+        case ComponentType::JK_FLIPFLOP:
+        case ComponentType::SR_LATCH:
+        case ComponentType::T_FLIPFLOP:
+        case ComponentType::REGISTER_4BIT:
+        case ComponentType::SHIFT_REGISTER_4BIT:
+        case ComponentType::COUNTER_4BIT:
+        case ComponentType::BCD_COUNTER:
+        case ComponentType::BUS_REGISTER:
+            return PropagationDelay{ 4, 4 };
+        case ComponentType::ADDER_4BIT:
+        case ComponentType::BUS_ADDER:
+        case ComponentType::BUS_SUBTRACTOR:
+        case ComponentType::BUS_COMPARATOR:
+        case ComponentType::BUS_SHIFTER:
+            return PropagationDelay{ 8, 8 };
+        case ComponentType::BUS_MULTIPLIER:
+        case ComponentType::BUS_ALU:
+        case ComponentType::RAM:
+        case ComponentType::ROM:
+            return PropagationDelay{ 12, 12 };
+        default:
+            return PropagationDelay{ 0, 0 };
+    }
 }
 
 void CircuitComponent::Move(const wxPoint& offset) {
+    // Pins are placed relative to the position, so they follow by themselves
     position += offset;
-    for (auto& pin : pins) {
-        pin.position += offset;
-    }
+    transform.dx += offset.x;
+    transform.dy += offset.y;
 }
 
 bool CircuitComponent::Contains(const wxPoint& pt) const {
-    return (pt.x >= position.x && pt.x <= position.x + size.x &&
-            pt.y >= position.y && pt.y <= position.y + size.y);
+    // Turns are whole quarters, so the turned body fills its bounding box
+    wxRect bounds = GetBounds();
+    return (pt.x >= bounds.x && pt.x <= bounds.x + bounds.width &&
+            pt.y >= bounds.y && pt.y <= bounds.y + bounds.height);
 }
 
 Pin* CircuitComponent::GetPinAt(const wxPoint& pt) {
     for (auto& pin : pins) {
-        wxRect pinRect(pin.position.x - 5, pin.position.y - 5, 10, 10);
+        wxPoint pinPosition = GetPinPosition(pin);
+        wxRect pinRect(pinPosition.x - 5, pinPosition.y - 5, 10, 10);
         if (pinRect.Contains(pt)) {
             return &pin;
         }
@@ -41,6 +104,7 @@ void CircuitComponent::SetRotation(double degrees) {
         rotation = rotation + (90.0 - remainder);
     }
     if (rotation >= 360.0) rotation = 0.0;
+    UpdateTransform();
 }
 
 void CircuitComponent::Rotate(double degrees) {
@@ -51,6 +115,7 @@ void CircuitComponent::SetScale(double sx, double sy) {
     // Limit scale factors to reasonable ranges
     scaleX = std::max(0.25, std::min(4.0, sx));
     scaleY = std::max(0.25, std::min(4.0, sy));
+    UpdateTransform();
 }
 
 void CircuitComponent::Scale(double sx, double sy) {
@@ -72,4 +137,22 @@ wxSize CircuitComponent::GetEffectiveSize() const {
     }
 
     return effectiveSize;
+}
+
+void CircuitComponent::UpdateTransform() {
+    // Clockwise on the canvas, whose y axis points down
+    static const int COSINES[] = { 1, 0, -1, 0 };
+    static const int SINES[] = { 0, 1, 0, -1 };
+    int quarter = static_cast<int>(rotation / 90.0) % 4;
+
+    transform.xx = COSINES[quarter] * scaleX;
+    transform.xy = -SINES[quarter] * scaleY;
+    transform.yx = SINES[quarter] * scaleX;
+    transform.yy = COSINES[quarter] * scaleY;
+
+    // Shift the turned body's top left corner back onto the position
+    double left = std::min(0.0, transform.xx * size.x) + std::min(0.0, transform.xy * size.y);
+    double top = std::min(0.0, transform.yx * size.x) + std::min(0.0, transform.yy * size.y);
+    transform.dx = position.x - left;
+    transform.dy = position.y - top;
 }
\ No newline at end of file
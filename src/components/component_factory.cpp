@@ -0,0 +1,311 @@
+#include "../../include/components/component_factory.h"
+#include "../../include/components/logic_gates.h"
+#include "../../include/components/arithmetic_components.h"
+#include "../../include/components/io_components.h"
+#include "../../include/components/wire.h"
+#include "../../include/components/sequential_components.h"
+#include "../../include/components/decoder_encoder_components.h"
+#include "../../include/components/display_components.h"
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/components/bus_components.h"
+#include "../../include/components/memory_components.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+struct TypeName {
+    ComponentType type;
+    const char* name;
+};
+
+const TypeName TYPE_NAMES[] = {
+    { ComponentType::INPUT_PIN, "INPUT_PIN" },
+    { ComponentType::OUTPUT_PIN, "OUTPUT_PIN" },
+    { ComponentType::AND_GATE, "AND_GATE" },
+    { ComponentType::OR_GATE, "OR_GATE" },
+    { ComponentType::NOT_GATE, "NOT_GATE" },
+    { ComponentType::NAND_GATE, "NAND_GATE" },
+    { ComponentType::NOR_GATE, "NOR_GATE" },
+    { ComponentType::XOR_GATE, "XOR_GATE" },
+    { ComponentType::XNOR_GATE, "XNOR_GATE" },
+    { ComponentType::BUFFER, "BUFFER" },
+    { ComponentType::WIRE, "WIRE" },
+    { ComponentType::HALF_ADDER, "HALF_ADDER" },
+    { ComponentType::FULL_ADDER, "FULL_ADDER" },
+    { ComponentType::ADDER_4BIT, "ADDER_4BIT" },
+    { ComponentType::MULTIPLEXER_2TO1, "MULTIPLEXER_2TO1" },
+    { ComponentType::MULTIPLEXER_4TO1, "MULTIPLEXER_4TO1" },
+    { ComponentType::DEMULTIPLEXER_1TO2, "DEMULTIPLEXER_1TO2" },
+    { ComponentType::DEMULTIPLEXER_1TO4, "DEMULTIPLEXER_1TO4" },
+    { ComponentType::ENCODER_4TO2, "ENCODER_4TO2" },
+    { ComponentType::ENCODER_8TO3, "ENCODER_8TO3" },
+    { ComponentType::PRIORITY_ENCODER, "PRIORITY_ENCODER" },
+    { ComponentType::DECODER_2TO4, "DECODER_2TO4" },
+    { ComponentType::DECODER_3TO8, "DECODER_3TO8" },
+    { ComponentType::DECODER_4TO16, "DECODER_4TO16" },
+    { ComponentType::BCD_TO_7SEGMENT, "BCD_TO_7SEGMENT" },
+    { ComponentType::D_FLIPFLOP, "D_FLIPFLOP" },
+    { ComponentType::JK_FLIPFLOP, "JK_FLIPFLOP" },
+    { ComponentType::SR_LATCH, "SR_LATCH" },
+    { ComponentType::T_FLIPFLOP, "T_FLIPFLOP" },
+    { ComponentType::CLOCK_GENERATOR, "CLOCK_GENERATOR" },
+    { ComponentType::REGISTER_4BIT, "REGISTER_4BIT" },
+    { ComponentType::SHIFT_REGISTER_4BIT, "SHIFT_REGISTER_4BIT" },
+    { ComponentType::COUNTER_4BIT, "COUNTER_4BIT" },
+    { ComponentType::BCD_COUNTER, "BCD_COUNTER" },
+    { ComponentType::SEVEN_SEGMENT_DISPLAY, "SEVEN_SEGMENT_DISPLAY" },
+    { ComponentType::LED_MATRIX_8X8, "LED_MATRIX_8X8" },
+    { ComponentType::LCD_DISPLAY, "LCD_DISPLAY" },
+    { ComponentType::HEX_DISPLAY, "HEX_DISPLAY" },
+    { ComponentType::BINARY_DISPLAY, "BINARY_DISPLAY" },
+    { ComponentType::SUBCIRCUIT, "SUBCIRCUIT" },
+    { ComponentType::BUS_SPLITTER, "BUS_SPLITTER" },
+    { ComponentType::BUS_JOINER, "BUS_JOINER" },
+    { ComponentType::BUS_ADDER, "BUS_ADDER" },
+    { ComponentType::BUS_MULTIPLEXER_4TO1, "BUS_MULTIPLEXER_4TO1" },
+    { ComponentType::BUS_REGISTER, "BUS_REGISTER" },
+    { ComponentType::BUS_COMPARATOR, "BUS_COMPARATOR" },
+    { ComponentType::BUS_SUBTRACTOR, "BUS_SUBTRACTOR" },
+    { ComponentType::BUS_MULTIPLIER, "BUS_MULTIPLIER" },
+    { ComponentType::BUS_SHIFTER, "BUS_SHIFTER" },
+    { ComponentType::BUS_ALU, "BUS_ALU" },
+    { ComponentType::RAM, "RAM" },
+    { ComponentType::ROM, "ROM" }
+};
+
+} // namespace
+
+CircuitComponent* ComponentFactory::Create(ComponentType type, const wxPoint& pos) {
+    switch (type) {
+        case ComponentType::AND_GATE:
+            return new AndGate(pos);
+        case ComponentType::OR_GATE:
+            return new OrGate(pos);
+        case ComponentType::NOT_GATE:
+            return new NotGate(pos);
+        case ComponentType::NAND_GATE:
+            return new NandGate(pos);
+        case ComponentType::NOR_GATE:
+            return new NorGate(pos);
+        case ComponentType::XOR_GATE:
+            return new XorGate(pos);
+        case ComponentType::XNOR_GATE:
+            return new XnorGate(pos);
+        case ComponentType::INPUT_PIN:
+            return new InputSwitch(pos);
+        case ComponentType::OUTPUT_PIN:
+            return new OutputLED(pos);
+        case ComponentType::HALF_ADDER:
+            return new HalfAdder(pos);
+        case ComponentType::FULL_ADDER:
+            return new FullAdder(pos);
+        case ComponentType::ADDER_4BIT:
+            return new Adder4Bit(pos);
+        case ComponentType::MULTIPLEXER_2TO1:
+            return new Multiplexer2to1(pos);
+        case ComponentType::MULTIPLEXER_4TO1:
+            return new Multiplexer4to1(pos);
+        case ComponentType::DEMULTIPLEXER_1TO2:
+            return new Demultiplexer1to2(pos);
+        case ComponentType::DEMULTIPLEXER_1TO4:
+            return new Demultiplexer1to4(pos);
+        // Sequential Logic Components
+        case ComponentType::D_FLIPFLOP:
+            return new DFlipFlop(pos);
+        case ComponentType::JK_FLIPFLOP:
+            return new JKFlipFlop(pos);
+        case ComponentType::SR_LATCH:
+            return new SRLatch(pos);
+        case ComponentType::CLOCK_GENERATOR:
+            return new ClockGenerator(pos);
+        case ComponentType::COUNTER_4BIT:
+            return new BinaryCounter4Bit(pos);
+        // Encoder/Decoder components
+        case ComponentType::DECODER_3TO8:
+            return new Decoder3to8(pos);
+        case ComponentType::BCD_TO_7SEGMENT:
+            return new BCDTo7SegmentDecoder(pos);
+        case ComponentType::PRIORITY_ENCODER:
+            return new PriorityEncoder8to3(pos);
+        // Display Components
+        case ComponentType::SEVEN_SEGMENT_DISPLAY:
+            return new SevenSegmentDisplay(pos);
+        case ComponentType::LED_MATRIX_8X8:
+            return new LEDMatrix8x8(pos);
+        case ComponentType::HEX_DISPLAY:
+            return new HexDisplay(pos);
+        case ComponentType::BINARY_DISPLAY:
+            return new BinaryDisplay8Bit(pos);
+        // Bus Components
+        case ComponentType::BUS_SPLITTER:
+            return new BusSplitter(pos);
+        case ComponentType::BUS_JOINER:
+            return new BusJoiner(pos);
+        case ComponentType::BUS_ADDER:
+            return new BusAdder(pos);
+        case ComponentType::BUS_MULTIPLEXER_4TO1:
+            return new BusMultiplexer4to1(pos);
+        case ComponentType::BUS_REGISTER:
+            return new BusRegister(pos);
+        case ComponentType::BUS_COMPARATOR:
+            return new BusComparator(pos);
+        case ComponentType::BUS_SUBTRACTOR:
+            return new BusSubtractor(pos);
+        case ComponentType::BUS_MULTIPLIER:
+            return new BusMultiplier(pos);
+        case ComponentType::BUS_SHIFTER:
+            return new BusShifter(pos);
+        case ComponentType::BUS_ALU:
+            return new BusALU(pos);
+        // Memory Components
+        case ComponentType::RAM:
+            return new RAM(pos);
+        case ComponentType::ROM:
+            return new ROM(pos);
+
+        default:
+            return nullptr;
+    }
+}
+
+std::unique_ptr<CircuitComponent> ComponentFactory::Clone(const CircuitComponent* component) {
+    if (!component || component->GetType() == ComponentType::WIRE) return nullptr;
+
+    std::unique_ptr<CircuitComponent> copy;
+    if (auto subcircuit = dynamic_cast<const SubcircuitComponent*>(component)) {
+        // Instances share their definition
+        copy.reset(new SubcircuitComponent(component->GetPosition(), subcircuit->GetDefinition()));
+    } else {
+        copy.reset(Create(component->GetType(), component->GetPosition()));
+    }
+    if (!copy) return nullptr;
+
+    copy->SetId(component->GetId());
+    if (component->GetDataWidth() > 0) {
+        copy->SetDataWidth(component->GetDataWidth());
+    }
+    if (component->GetInputCount() > 0) {
+        copy->SetInputCount(component->GetInputCount());
+    }
+    if (component->GetMemory()) {
+        copy->SetAddressWidth(component->GetAddressWidth());
+        *copy->GetMemory() = *component->GetMemory();
+    }
+
+    double sx, sy;
+    component->GetScale(sx, sy);
+    copy->SetRotation(component->GetRotation());
+    copy->SetScale(sx, sy);
+    if (component->HasCustomDelay()) {
+        copy->SetDelay(component->GetDelay());
+    }
+
+    // Type specific state
+    if (auto inputSwitch = dynamic_cast<const InputSwitch*>(component)) {
+        InputSwitch* target = static_cast<InputSwitch*>(copy.get());
+        target->SetLabel(inputSwitch->GetLabel());
+        target->SetState(inputSwitch->GetValue() == LogicValue::HIGH);
+    } else if (auto outputLED = dynamic_cast<const OutputLED*>(component)) {
+        static_cast<OutputLED*>(copy.get())->SetLabel(outputLED->GetLabel());
+    }
+
+    // Pin values and connection flags
+    const auto& sourcePins = component->GetPins();
+    auto& targetPins = copy->GetPins();
+    for (size_t i = 0; i < sourcePins.size() && i < targetPins.size(); ++i) {
+        targetPins[i].value = sourcePins[i].value;
+        targetPins[i].bus = sourcePins[i].bus;
+        targetPins[i].isConnected = sourcePins[i].isConnected;
+    }
+
+    return copy;
+}
+
+void ComponentFactory::CloneCircuit(const std::vector<std::unique_ptr<CircuitComponent>>& source,
+                                    std::vector<std::unique_ptr<CircuitComponent>>& target) {
+    // Copy the components first so every wire end can be mapped. Each
+    // component's pins are one array, so a wire end is found by binary
+    // search over the arrays sorted by address.
+    struct PinRange {
+        const Pin* begin;
+        const Pin* end;
+        size_t component;
+    };
+    std::vector<std::unique_ptr<CircuitComponent>> copies(source.size());
+    std::vector<PinRange> ranges;
+    ranges.reserve(source.size());
+    for (size_t i = 0; i < source.size(); ++i) {
+        copies[i] = Clone(source[i].get());
+        if (!copies[i]) continue;
+
+        const auto& sourcePins = source[i]->GetPins();
+        if (!sourcePins.empty()) {
+            ranges.push_back(PinRange{ sourcePins.data(), sourcePins.data() + sourcePins.size(), i });
+        }
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const PinRange& a, const PinRange& b) { return std::less<const Pin*>()(a.begin, b.begin); });
+
+    // Copied pin and its canvas position for a source pin, nullptr if it is not in the circuit
+    struct CopiedPin {
+        Pin* pin;
+        wxPoint position;
+    };
+    auto mapPin = [&](const Pin* pin) -> CopiedPin {
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), pin,
+            [](const Pin* p, const PinRange& r) { return std::less<const Pin*>()(p, r.begin); });
+        if (range == ranges.begin() || !std::less<const Pin*>()(pin, (--range)->end)) return CopiedPin{ nullptr, wxPoint() };
+        CircuitComponent* copy = copies[range->component].get();
+        size_t index = pin - range->begin;
+        if (index >= copy->GetPins().size()) return CopiedPin{ nullptr, wxPoint() };
+        Pin* copiedPin = &copy->GetPins()[index];
+        return CopiedPin{ copiedPin, copy->GetPinPosition(*copiedPin) };
+    };
+
+    // Keep the original order, recreating wires between the copied pins
+    std::vector<CopiedPin> ends(2 * source.size(), CopiedPin{ nullptr, wxPoint() });
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (copies[i] || source[i]->GetType() != ComponentType::WIRE) continue;
+        const Wire* wire = static_cast<const Wire*>(source[i].get());
+        ends[2 * i] = mapPin(wire->GetStartPin());
+        ends[2 * i + 1] = mapPin(wire->GetEndPin());
+    }
+
+    for (size_t i = 0; i < source.size(); ++i) {
+        if (copies[i]) {
+            target.push_back(std::move(copies[i]));
+            continue;
+        }
+        const CopiedPin& start = ends[2 * i];
+        const CopiedPin& end = ends[2 * i + 1];
+        if (!start.pin || !end.pin) continue;
+
+        const Wire* wire = static_cast<const Wire*>(source[i].get());
+        auto copy = std::make_unique<Wire>(start.pin, start.position);
+        const auto& points = wire->GetPoints();
+        for (size_t p = 1; p + 1 < points.size(); ++p) {
+            copy->AddPoint(points[p]);
+        }
+        copy->SetEndPin(end.pin, end.position);
+        copy->SetId(wire->GetId());
+        target.push_back(std::move(copy));
+    }
+}
+
+wxString ComponentFactory::GetTypeName(ComponentType type) {
+    for (const auto& entry : TYPE_NAMES) {
+        if (entry.type == type) return entry.name;
+    }
+    return "SELECT";
+}
+
+bool ComponentFactory::GetTypeFromName(const wxString& name, ComponentType& type) {
+    for (const auto& entry : TYPE_NAMES) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
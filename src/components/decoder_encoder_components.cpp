@@ -6,14 +6,14 @@ Decoder3to8::Decoder3to8(const wxPoint& pos)
     : CircuitComponent(pos, wxSize(80, 120), ComponentType::DECODER_3TO8) {
 
     // 3 input pins (A2, A1, A0), Enable pin, 8 output pins
-    pins.emplace_back(wxPoint(pos.x, pos.y + 20), true);      // A0
-    pins.emplace_back(wxPoint(pos.x, pos.y + 40), true);      // A1
-    pins.emplace_back(wxPoint(pos.x, pos.y + 60), true);      // A2
-    pins.emplace_back(wxPoint(pos.x, pos.y + 100), true);     // Enable
+    pins.emplace_back(wxPoint(0, 20), true);      // A0
+    pins.emplace_back(wxPoint(0, 40), true);      // A1
+    pins.emplace_back(wxPoint(0, 60), true);      // A2
+    pins.emplace_back(wxPoint(0, 100), true);     // Enable
 
     // 8 output pins
     for (int i = 0; i < 8; ++i) {
-        pins.emplace_back(wxPoint(pos.x + 80, pos.y + 10 + i * 12), false);
+        pins.emplace_back(wxPoint(80, 10 + i * 12), false);
     }
 }
 
@@ -49,7 +49,7 @@ void Decoder3to8::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -100,17 +100,17 @@ LogicValue Decoder3to8::GetOutput(int index) const {
 
 // BCD to 7-Segment Decoder implementation
 BCDTo7SegmentDecoder::BCDTo7SegmentDecoder(const wxPoint& pos)
-    : CircuitComponent(pos, wxSize(80, 100), ComponentType::DECODER_2TO4) {
+    : CircuitComponent(pos, wxSize(80, 100), ComponentType::BCD_TO_7SEGMENT) {
 
     // 4 BCD input pins
-    pins.emplace_back(wxPoint(pos.x, pos.y + 20), true);      // D0
-    pins.emplace_back(wxPoint(pos.x, pos.y + 35), true);      // D1
-    pins.emplace_back(wxPoint(pos.x, pos.y + 50), true);      // D2
-    pins.emplace_back(wxPoint(pos.x, pos.y + 65), true);      // D3
+    pins.emplace_back(wxPoint(0, 20), true);      // D0
+    pins.emplace_back(wxPoint(0, 35), true);      // D1
+    pins.emplace_back(wxPoint(0, 50), true);      // D2
+    pins.emplace_back(wxPoint(0, 65), true);      // D3
 
     // 7 segment output pins (a, b, c, d, e, f, g)
     for (int i = 0; i < 7; ++i) {
-        pins.emplace_back(wxPoint(pos.x + 80, pos.y + 15 + i * 10), false);
+        pins.emplace_back(wxPoint(80, 15 + i * 10), false);
     }
 
     // Initialize outputs
@@ -189,7 +189,7 @@ void BCDTo7SegmentDecoder::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -249,18 +249,18 @@ bool BCDTo7SegmentDecoder::GetSegment(int segment) const {
 
 // 8-to-3 Priority Encoder implementation
 PriorityEncoder8to3::PriorityEncoder8to3(const wxPoint& pos)
-    : CircuitComponent(pos, wxSize(80, 120), ComponentType::ENCODER_4TO2) {
+    : CircuitComponent(pos, wxSize(80, 120), ComponentType::PRIORITY_ENCODER) {
 
     // 8 input pins
     for (int i = 0; i < 8; ++i) {
-        pins.emplace_back(wxPoint(pos.x, pos.y + 10 + i * 12), true);
+        pins.emplace_back(wxPoint(0, 10 + i * 12), true);
     }
 
     // 3 output pins (A2, A1, A0) + Valid output
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 30), false); // A0
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 50), false); // A1
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 70), false); // A2
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 90), false); // Valid
+    pins.emplace_back(wxPoint(80, 30), false); // A0
+    pins.emplace_back(wxPoint(80, 50), false); // A1
+    pins.emplace_back(wxPoint(80, 70), false); // A2
+    pins.emplace_back(wxPoint(80, 90), false); // Valid
 }
 
 void PriorityEncoder8to3::Draw(wxDC& dc) {
@@ -295,7 +295,7 @@ void PriorityEncoder8to3::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
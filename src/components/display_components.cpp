@@ -9,7 +9,7 @@ SevenSegmentDisplay::SevenSegmentDisplay(const wxPoint& pos, bool commonCathode)
 
     // 7 segment input pins (a, b, c, d, e, f, g)
     for (int i = 0; i < 7; ++i) {
-        pins.emplace_back(wxPoint(pos.x, pos.y + 10 + i * 10), true);
+        pins.emplace_back(wxPoint(0, 10 + i * 10), true);
         segments[i] = false;
     }
 }
@@ -115,7 +115,7 @@ void SevenSegmentDisplay::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxWHITE;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -160,8 +160,8 @@ LEDMatrix8x8::LEDMatrix8x8(const wxPoint& pos)
 
     // 8 row pins + 8 column pins
     for (int i = 0; i < 8; ++i) {
-        pins.emplace_back(wxPoint(pos.x, pos.y + 10 + i * 12), true);        // Rows
-        pins.emplace_back(wxPoint(pos.x + 10 + i * 12, pos.y + 120), true);  // Columns
+        pins.emplace_back(wxPoint(0, 10 + i * 12), true);        // Rows
+        pins.emplace_back(wxPoint(10 + i * 12, 120), true);  // Columns
     }
 
     // Initialize matrix
@@ -206,7 +206,7 @@ void LEDMatrix8x8::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxWHITE;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -266,12 +266,12 @@ void LEDMatrix8x8::SetPattern(const bool pattern[8][8]) {
 
 // Hex Display implementation
 HexDisplay::HexDisplay(const wxPoint& pos)
-    : CircuitComponent(pos, wxSize(40, 40), ComponentType::SEVEN_SEGMENT_DISPLAY),
+    : CircuitComponent(pos, wxSize(40, 40), ComponentType::HEX_DISPLAY),
       value(0), backgroundColor(*wxBLACK), textColor(*wxGREEN) {
 
     // 4 input pins for 4-bit value
     for (int i = 0; i < 4; ++i) {
-        pins.emplace_back(wxPoint(pos.x, pos.y + 5 + i * 8), true);
+        pins.emplace_back(wxPoint(0, 5 + i * 8), true);
     }
 }
 
@@ -305,7 +305,7 @@ void HexDisplay::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxWHITE;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -338,12 +338,12 @@ char HexDisplay::GetHexChar() const {
 
 // Binary Display implementation
 BinaryDisplay8Bit::BinaryDisplay8Bit(const wxPoint& pos)
-    : CircuitComponent(pos, wxSize(120, 30), ComponentType::SEVEN_SEGMENT_DISPLAY),
+    : CircuitComponent(pos, wxSize(120, 30), ComponentType::BINARY_DISPLAY),
       onColor(*wxRED), offColor(wxColour(100, 100, 100)) {
 
     // 8 input pins for 8-bit value
     for (int i = 0; i < 8; ++i) {
-        pins.emplace_back(wxPoint(pos.x, pos.y + 5 + i * 3), true);
+        pins.emplace_back(wxPoint(0, 5 + i * 3), true);
         bits[i] = false;
     }
 }
@@ -378,7 +378,7 @@ void BinaryDisplay8Bit::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxWHITE;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
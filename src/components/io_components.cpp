@@ -4,7 +4,7 @@
 InputSwitch::InputSwitch(const wxPoint& pos)
     : CircuitComponent(pos, wxSize(40, 30), ComponentType::INPUT_PIN), state(false) {
     // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 40, pos.y + 15), false));
+    pins.push_back(Pin(wxPoint(40, 15), false));
 }
 
 void InputSwitch::Draw(wxDC& dc) {
@@ -17,11 +17,16 @@ void InputSwitch::Draw(wxDC& dc) {
     // Draw the state text
     dc.DrawText(state ? "ON" : "OFF", position.x + 5, position.y + 5);
 
+    // Draw the label above the switch
+    if (!label.IsEmpty()) {
+        dc.DrawText(label, position.x, position.y - 15);
+    }
+
     // Draw pins
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -30,6 +35,11 @@ void InputSwitch::Toggle() {
     pins[0].value = state ? LogicValue::HIGH : LogicValue::LOW;
 }
 
+void InputSwitch::SetState(bool on) {
+    state = on;
+    pins[0].value = state ? LogicValue::HIGH : LogicValue::LOW;
+}
+
 LogicValue InputSwitch::GetValue() const {
     return state ? LogicValue::HIGH : LogicValue::LOW;
 }
@@ -38,7 +48,7 @@ LogicValue InputSwitch::GetValue() const {
 OutputLED::OutputLED(const wxPoint& pos)
     : CircuitComponent(pos, wxSize(30, 30), ComponentType::OUTPUT_PIN) {
     // Create input pin
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 15), true));
+    pins.push_back(Pin(wxPoint(0, 15), true));
 }
 
 void OutputLED::Draw(wxDC& dc) {
@@ -56,10 +66,15 @@ void OutputLED::Draw(wxDC& dc) {
     // Draw the LED body
     dc.DrawCircle(position.x + size.x / 2, position.y + size.y / 2, size.x / 2);
 
+    // Draw the label above the LED
+    if (!label.IsEmpty()) {
+        dc.DrawText(label, position.x, position.y - 15);
+    }
+
     // Draw pins
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
\ No newline at end of file
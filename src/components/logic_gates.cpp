@@ -1,17 +1,59 @@
 #include "../../include/components/logic_gates.h"
+#include <algorithm>
+
+namespace {
+
+// Odd number of set bits
+bool Parity(uint64_t bits) {
+    bits ^= bits >> 32;
+    bits ^= bits >> 16;
+    bits ^= bits >> 8;
+    bits ^= bits >> 4;
+    bits ^= bits >> 2;
+    bits ^= bits >> 1;
+    return (bits & 1) != 0;
+}
+
+} // namespace
+
+LogicGate::LogicGate(const wxPoint& pos, const wxSize& sz, ComponentType t, const std::string& lbl, int inputs)
+    : CircuitComponent(pos, sz, t), label(lbl), inputCount(inputs) {
+    CreatePins();
+}
+
+void LogicGate::CreatePins() {
+    // Two inputs keep the classic 40 pixel body, wider gates grow 10 pixels per input
+    size.y = std::max(40, 10 * (inputCount + 1));
+    UpdateTransform();
+    pins.reserve(inputCount + 1);
+
+    // Create input pins
+    for (int i = 0; i < inputCount; i++) {
+        int y = inputCount > 1 ? 10 + i * (size.y - 20) / (inputCount - 1) : size.y / 2;
+        pins.push_back(Pin(wxPoint(0, y), true));
+    }
+    // Create output pin
+    pins.push_back(Pin(wxPoint(size.x, size.y / 2), false));
+}
 
-LogicGate::LogicGate(const wxPoint& pos, const wxSize& sz, ComponentType t, const std::string& lbl)
-    : CircuitComponent(pos, sz, t), label(lbl) {
+void LogicGate::SetInputCount(int count) {
+    inputCount = std::max(MIN_INPUTS, std::min(MAX_INPUTS, count));
+    pins.clear();
+    CreatePins();
+}
+
+BusValue LogicGate::ReadInputs() const {
+    BusValue inputs = { 0, 0 };
+    for (int i = 0; i < inputCount; i++) {
+        if (pins[i].value == LogicValue::HIGH) inputs.bits |= uint64_t(1) << i;
+        if (pins[i].value == LogicValue::UNDEFINED) inputs.undefined |= uint64_t(1) << i;
+    }
+    return inputs;
 }
 
 // AND Gate
 AndGate::AndGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::AND_GATE, "AND") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void AndGate::Draw(wxDC& dc) {
@@ -36,25 +78,18 @@ void AndGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue AndGate::Evaluate() {
-    if (pins[0].value == LogicValue::HIGH && pins[1].value == LogicValue::HIGH) {
-        return LogicValue::HIGH;
-    }
-    return LogicValue::LOW;
+    BusValue inputs = ReadInputs();
+    return inputs.bits == BusMask(inputCount) ? LogicValue::HIGH : LogicValue::LOW;
 }
 
 // OR Gate
 OrGate::OrGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::OR_GATE, "OR") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void OrGate::Draw(wxDC& dc) {
@@ -80,24 +115,18 @@ void OrGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue OrGate::Evaluate() {
-    if (pins[0].value == LogicValue::HIGH || pins[1].value == LogicValue::HIGH) {
-        return LogicValue::HIGH;
-    }
-    return LogicValue::LOW;
+    BusValue inputs = ReadInputs();
+    return inputs.bits != 0 ? LogicValue::HIGH : LogicValue::LOW;
 }
 
 // NOT Gate
 NotGate::NotGate(const wxPoint& pos)
-    : LogicGate(pos, wxSize(60, 40), ComponentType::NOT_GATE, "NOT") {
-    // Create input pin
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 20), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
+    : LogicGate(pos, wxSize(60, 40), ComponentType::NOT_GATE, "NOT", 1) {
 }
 
 void NotGate::Draw(wxDC& dc) {
@@ -122,7 +151,7 @@ void NotGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
@@ -136,11 +165,6 @@ LogicValue NotGate::Evaluate() {
 // NAND Gate
 NandGate::NandGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::NAND_GATE, "NAND") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void NandGate::Draw(wxDC& dc) {
@@ -168,25 +192,18 @@ void NandGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue NandGate::Evaluate() {
-    if (pins[0].value == LogicValue::HIGH && pins[1].value == LogicValue::HIGH) {
-        return LogicValue::LOW;
-    }
-    return LogicValue::HIGH;
+    BusValue inputs = ReadInputs();
+    return inputs.bits == BusMask(inputCount) ? LogicValue::LOW : LogicValue::HIGH;
 }
 
 // NOR Gate
 NorGate::NorGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::NOR_GATE, "NOR") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void NorGate::Draw(wxDC& dc) {
@@ -215,25 +232,18 @@ void NorGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue NorGate::Evaluate() {
-    if (pins[0].value == LogicValue::HIGH || pins[1].value == LogicValue::HIGH) {
-        return LogicValue::LOW;
-    }
-    return LogicValue::HIGH;
+    BusValue inputs = ReadInputs();
+    return inputs.bits != 0 ? LogicValue::LOW : LogicValue::HIGH;
 }
 
 // XOR Gate
 XorGate::XorGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::XOR_GATE, "XOR") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void XorGate::Draw(wxDC& dc) {
@@ -262,26 +272,19 @@ void XorGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue XorGate::Evaluate() {
-    if ((pins[0].value == LogicValue::HIGH && pins[1].value == LogicValue::LOW) ||
-        (pins[0].value == LogicValue::LOW && pins[1].value == LogicValue::HIGH)) {
-        return LogicValue::HIGH;
-    }
-    return LogicValue::LOW;
+    // HIGH for an odd number of HIGH inputs; any undefined input gives LOW
+    BusValue inputs = ReadInputs();
+    return inputs.undefined == 0 && Parity(inputs.bits) ? LogicValue::HIGH : LogicValue::LOW;
 }
 
 // XNOR Gate
 XnorGate::XnorGate(const wxPoint& pos)
     : LogicGate(pos, wxSize(60, 40), ComponentType::XNOR_GATE, "XNOR") {
-    // Create input pins
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 10), true));
-    pins.push_back(Pin(wxPoint(pos.x, pos.y + 30), true));
-    // Create output pin
-    pins.push_back(Pin(wxPoint(pos.x + 60, pos.y + 20), false));
 }
 
 void XnorGate::Draw(wxDC& dc) {
@@ -313,14 +316,12 @@ void XnorGate::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         dc.SetPen(*wxBLACK_PEN);
         dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 }
 
 LogicValue XnorGate::Evaluate() {
-    if ((pins[0].value == LogicValue::HIGH && pins[1].value == LogicValue::HIGH) ||
-        (pins[0].value == LogicValue::LOW && pins[1].value == LogicValue::LOW)) {
-        return LogicValue::HIGH;
-    }
-    return LogicValue::LOW;
+    // HIGH for an even number of HIGH inputs; any undefined input gives LOW
+    BusValue inputs = ReadInputs();
+    return inputs.undefined == 0 && !Parity(inputs.bits) ? LogicValue::HIGH : LogicValue::LOW;
 }
\ No newline at end of file
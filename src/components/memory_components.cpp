@@ -0,0 +1,129 @@
+#include "../../include/components/memory_components.h"
+#include <algorithm>
+
+namespace {
+
+// Addressed word, undefined while any address line is
+BusValue ReadWord(const MemoryImage& memory, const Pin& addressPin) {
+    BusValue address = ReadBus(addressPin);
+    if (address.undefined != 0) {
+        BusValue unknown = { 0, BusMask(memory.GetDataWidth()) };
+        return unknown;
+    }
+
+    BusValue word = { memory.Read(address.bits), 0 };
+    return word;
+}
+
+void DrawMemory(wxDC& dc, const wxPoint& position, const wxSize& size, bool selected,
+                const wxString& label, const MemoryImage& memory) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(wxColour(255, 245, 220)));
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    dc.DrawText(label, position.x + (size.x - dc.GetTextExtent(label).x) / 2, position.y + 5);
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    wxString geometry = wxString::Format("%zu x %d", memory.GetWordCount(), memory.GetDataWidth());
+    dc.DrawText(geometry, position.x + (size.x - dc.GetTextExtent(geometry).x) / 2, position.y + 20);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+}
+
+} // namespace
+
+// RAM Implementation
+RAM::RAM(const wxPoint& pos, int addressBits, int dataBits)
+    : SequentialComponent(pos, wxSize(80, 100), ComponentType::RAM), memory(addressBits, dataBits) {
+    CreatePins();
+}
+
+void RAM::CreatePins() {
+    // Address, data in, write enable and clock inputs, data out
+    pins.emplace_back(wxPoint(0, 20), true, memory.GetAddressWidth());   // A
+    pins.emplace_back(wxPoint(0, 40), true, memory.GetDataWidth());      // D
+    pins.emplace_back(wxPoint(0, 60), true);                             // WE
+    pins.emplace_back(wxPoint(0, 80), true);                             // Clock
+    pins.emplace_back(wxPoint(80, 40), false, memory.GetDataWidth()); // Q
+    WriteBus(pins[4], ReadWord(memory, pins[0]));
+}
+
+void RAM::SetDataWidth(int bits) {
+    memory.Resize(memory.GetAddressWidth(), std::max(BusComponent::MIN_WIDTH, std::min(BusComponent::MAX_WIDTH, bits)));
+    pins.clear();
+    CreatePins();
+}
+
+void RAM::SetAddressWidth(int bits) {
+    memory.Resize(bits, memory.GetDataWidth());
+    pins.clear();
+    CreatePins();
+}
+
+void RAM::Draw(wxDC& dc) {
+    DrawMemory(dc, position, size, selected, "RAM", memory);
+
+    // Draw clock triangle
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    wxPoint triangle[] = {
+        wxPoint(position.x, position.y + 85),
+        wxPoint(position.x + 10, position.y + 80),
+        wxPoint(position.x, position.y + 75)
+    };
+    dc.DrawPolygon(3, triangle);
+
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("A", position.x + 4, position.y + 15);
+    dc.DrawText("D", position.x + 4, position.y + 35);
+    dc.DrawText("WE", position.x + 4, position.y + 55);
+    dc.DrawText("Q", position.x + 70, position.y + 35);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawComponentPins(dc, *this);
+}
+
+void RAM::UpdateOnClock() {
+    // One word access per evaluation; undefined data lines are stored as 0
+    BusValue address = ReadBus(pins[0]);
+    if (IsClockTriggered(pins[3].value) && pins[2].value == LogicValue::HIGH && address.undefined == 0) {
+        BusValue data = ReadBus(pins[1]);
+        memory.Write(address.bits, data.bits & ~data.undefined);
+    }
+    WriteBus(pins[4], ReadWord(memory, pins[0]));
+}
+
+// ROM Implementation
+ROM::ROM(const wxPoint& pos, int addressBits, int dataBits)
+    : BusComponent(pos, wxSize(80, 60), ComponentType::ROM, dataBits), memory(addressBits, width) {
+    CreatePins();
+}
+
+void ROM::CreatePins() {
+    // Address input, data out
+    pins.emplace_back(wxPoint(0, 30), true, memory.GetAddressWidth());   // A
+    pins.emplace_back(wxPoint(80, 30), false, width);               // Q
+}
+
+void ROM::SetDataWidth(int bits) {
+    BusComponent::SetDataWidth(bits);
+    memory.Resize(memory.GetAddressWidth(), width);
+}
+
+void ROM::SetAddressWidth(int bits) {
+    memory.Resize(bits, width);
+    pins.clear();
+    CreatePins();
+}
+
+void ROM::Draw(wxDC& dc) {
+    DrawMemory(dc, position, size, selected, "ROM", memory);
+
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.DrawText("A", position.x + 4, position.y + 25);
+    dc.DrawText("Q", position.x + 70, position.y + 25);
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    DrawPins(dc);
+}
+
+void ROM::ComputeOutputs() {
+    WriteBus(pins[1], ReadWord(memory, pins[0]));
+}
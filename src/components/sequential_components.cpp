@@ -29,10 +29,10 @@ DFlipFlop::DFlipFlop(const wxPoint& pos)
       outputQ(LogicValue::LOW), outputQNot(LogicValue::HIGH) {
 
     // D input, Clock input, Q output, Q̄ output
-    pins.emplace_back(wxPoint(pos.x, pos.y + 20), true);      // D
-    pins.emplace_back(wxPoint(pos.x, pos.y + 60), true);      // Clock
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 20), false); // Q
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 60), false); // Q̄
+    pins.emplace_back(wxPoint(0, 20), true);      // D
+    pins.emplace_back(wxPoint(0, 60), true);      // Clock
+    pins.emplace_back(wxPoint(60, 20), false); // Q
+    pins.emplace_back(wxPoint(60, 60), false); // Q̄
 }
 
 void DFlipFlop::Draw(wxDC& dc) {
@@ -69,7 +69,7 @@ void DFlipFlop::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -102,11 +102,11 @@ JKFlipFlop::JKFlipFlop(const wxPoint& pos)
       outputQ(LogicValue::LOW), outputQNot(LogicValue::HIGH) {
 
     // J input, K input, Clock input, Q output, Q̄ output
-    pins.emplace_back(wxPoint(pos.x, pos.y + 15), true);      // J
-    pins.emplace_back(wxPoint(pos.x, pos.y + 45), true);      // K
-    pins.emplace_back(wxPoint(pos.x, pos.y + 75), true);      // Clock
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 25), false); // Q
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 65), false); // Q̄
+    pins.emplace_back(wxPoint(0, 15), true);      // J
+    pins.emplace_back(wxPoint(0, 45), true);      // K
+    pins.emplace_back(wxPoint(0, 75), true);      // Clock
+    pins.emplace_back(wxPoint(60, 25), false); // Q
+    pins.emplace_back(wxPoint(60, 65), false); // Q̄
 }
 
 void JKFlipFlop::Draw(wxDC& dc) {
@@ -144,7 +144,7 @@ void JKFlipFlop::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -191,10 +191,10 @@ SRLatch::SRLatch(const wxPoint& pos)
       outputQ(LogicValue::LOW), outputQNot(LogicValue::HIGH) {
 
     // S input, R input, Q output, Q̄ output
-    pins.emplace_back(wxPoint(pos.x, pos.y + 20), true);      // S (Set)
-    pins.emplace_back(wxPoint(pos.x, pos.y + 60), true);      // R (Reset)
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 20), false); // Q
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 60), false); // Q̄
+    pins.emplace_back(wxPoint(0, 20), true);      // S (Set)
+    pins.emplace_back(wxPoint(0, 60), true);      // R (Reset)
+    pins.emplace_back(wxPoint(60, 20), false); // Q
+    pins.emplace_back(wxPoint(60, 60), false); // Q̄
 
     hasClockInput = false; // SR Latch is level-triggered, not edge-triggered
 }
@@ -225,7 +225,7 @@ void SRLatch::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
@@ -267,7 +267,7 @@ ClockGenerator::ClockGenerator(const wxPoint& pos)
       clockState(false), frequency(1), lastToggleTime(wxGetLocalTimeMillis()) {
 
     // Clock output
-    pins.emplace_back(wxPoint(pos.x + 60, pos.y + 20), false);
+    pins.emplace_back(wxPoint(60, 20), false);
 }
 
 void ClockGenerator::Draw(wxDC& dc) {
@@ -299,7 +299,7 @@ void ClockGenerator::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Show current state
@@ -340,12 +340,12 @@ BinaryCounter4Bit::BinaryCounter4Bit(const wxPoint& pos)
       count(0), countUp(true) {
 
     // Clock input, Reset input, 4 output bits
-    pins.emplace_back(wxPoint(pos.x, pos.y + 20), true);      // Clock
-    pins.emplace_back(wxPoint(pos.x, pos.y + 80), true);      // Reset
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 20), false); // Q0
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 35), false); // Q1
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 50), false); // Q2
-    pins.emplace_back(wxPoint(pos.x + 80, pos.y + 65), false); // Q3
+    pins.emplace_back(wxPoint(0, 20), true);      // Clock
+    pins.emplace_back(wxPoint(0, 80), true);      // Reset
+    pins.emplace_back(wxPoint(80, 20), false); // Q0
+    pins.emplace_back(wxPoint(80, 35), false); // Q1
+    pins.emplace_back(wxPoint(80, 50), false); // Q2
+    pins.emplace_back(wxPoint(80, 65), false); // Q3
 }
 
 void BinaryCounter4Bit::Draw(wxDC& dc) {
@@ -380,7 +380,7 @@ void BinaryCounter4Bit::Draw(wxDC& dc) {
     for (const auto& pin : pins) {
         wxColour pinColor = pin.isConnected ? *wxRED : *wxBLACK;
         dc.SetPen(wxPen(pinColor, 2));
-        dc.DrawCircle(pin.position, 3);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
     }
 
     // Highlight if selected
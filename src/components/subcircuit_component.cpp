@@ -0,0 +1,91 @@
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/components/io_components.h"
+#include <algorithm>
+
+namespace {
+
+const int SUBCIRCUIT_WIDTH = 80;
+const int PORT_SPACING = 20;
+
+// Ports are ordered like they are drawn in the definition: top to bottom, then left to right
+bool IsAbove(const CircuitComponent* a, const CircuitComponent* b) {
+    wxPoint pa = a->GetPosition();
+    wxPoint pb = b->GetPosition();
+    return pa.y != pb.y ? pa.y < pb.y : pa.x < pb.x;
+}
+
+} // namespace
+
+SubcircuitDefinition::SubcircuitDefinition(const wxString& definitionName, const wxString& path,
+                                           std::vector<std::unique_ptr<CircuitComponent>> circuit)
+    : name(definitionName), filepath(path), components(std::move(circuit)) {
+
+    for (const auto& component : components) {
+        if (auto inputSwitch = dynamic_cast<const InputSwitch*>(component.get())) {
+            inputPorts.push_back(inputSwitch);
+        } else if (auto outputLED = dynamic_cast<const OutputLED*>(component.get())) {
+            outputPorts.push_back(outputLED);
+        }
+    }
+
+    std::stable_sort(inputPorts.begin(), inputPorts.end(), IsAbove);
+    std::stable_sort(outputPorts.begin(), outputPorts.end(), IsAbove);
+}
+
+wxString SubcircuitDefinition::GetInputName(size_t index) const {
+    const wxString& label = inputPorts[index]->GetLabel();
+    return label.IsEmpty() ? wxString::Format("in%zu", index) : label;
+}
+
+wxString SubcircuitDefinition::GetOutputName(size_t index) const {
+    const wxString& label = outputPorts[index]->GetLabel();
+    return label.IsEmpty() ? wxString::Format("out%zu", index) : label;
+}
+
+SubcircuitComponent::SubcircuitComponent(const wxPoint& pos, std::shared_ptr<const SubcircuitDefinition> def)
+    : CircuitComponent(pos,
+                       wxSize(SUBCIRCUIT_WIDTH,
+                              static_cast<int>(std::max<size_t>(1, std::max(def->GetInputCount(), def->GetOutputCount()))) * PORT_SPACING + PORT_SPACING),
+                       ComponentType::SUBCIRCUIT),
+      definition(std::move(def)) {
+
+    // Input pins on the left, then output pins on the right
+    for (size_t i = 0; i < definition->GetInputCount(); ++i) {
+        pins.push_back(Pin(wxPoint(0, PORT_SPACING + static_cast<int>(i) * PORT_SPACING), true));
+    }
+    for (size_t i = 0; i < definition->GetOutputCount(); ++i) {
+        pins.push_back(Pin(wxPoint(SUBCIRCUIT_WIDTH, PORT_SPACING + static_cast<int>(i) * PORT_SPACING), false));
+    }
+}
+
+void SubcircuitComponent::Draw(wxDC& dc) {
+    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    dc.SetBrush(wxBrush(wxColour(235, 235, 255)));
+
+    // Draw main body
+    dc.DrawRectangle(position.x, position.y, size.x, size.y);
+
+    // Draw definition name
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.DrawText(definition->GetName(), position.x + 5, position.y + 2);
+
+    // Draw port names inside the body, next to their pins
+    dc.SetFont(wxFont(6, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    for (size_t i = 0; i < definition->GetInputCount(); ++i) {
+        dc.DrawText(definition->GetInputName(i), position.x + 5,
+                    position.y + PORT_SPACING - 5 + static_cast<int>(i) * PORT_SPACING);
+    }
+    for (size_t i = 0; i < definition->GetOutputCount(); ++i) {
+        wxString portName = definition->GetOutputName(i);
+        dc.DrawText(portName, position.x + size.x - 5 - dc.GetTextExtent(portName).x,
+                    position.y + PORT_SPACING - 5 + static_cast<int>(i) * PORT_SPACING);
+    }
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    // Draw pins
+    for (const auto& pin : pins) {
+        dc.SetPen(*wxBLACK_PEN);
+        dc.SetBrush(pin.isConnected ? *wxBLACK_BRUSH : *wxWHITE_BRUSH);
+        dc.DrawCircle(GetPinLayoutPosition(pin), 3);
+    }
+}
@@ -1,15 +1,17 @@
 #include "../../include/components/wire.h"
 #include <cmath>
 
-Wire::Wire(Pin* start)
-    : CircuitComponent(start->position, wxSize(0, 0), ComponentType::WIRE), startPin(start), endPin(nullptr) {
-    points.push_back(start->position);
+Wire::Wire(Pin* start, const wxPoint& startPosition)
+    : CircuitComponent(startPosition, wxSize(0, 0), ComponentType::WIRE), startPin(start), endPin(nullptr) {
+    // Most wires are a straight line between two pins
+    points.reserve(2);
+    points.push_back(startPosition);
 }
 
-void Wire::SetEndPin(Pin* end) {
+void Wire::SetEndPin(Pin* end, const wxPoint& endPosition) {
     endPin = end;
     if (end) {
-        points.push_back(end->position);
+        points.push_back(endPosition);
     }
 }
 
@@ -18,7 +20,9 @@ void Wire::AddPoint(const wxPoint& pt) {
 }
 
 void Wire::Draw(wxDC& dc) {
-    dc.SetPen(selected ? *wxRED_PEN : *wxBLACK_PEN);
+    // Buses are drawn thicker than single lines
+    bool bus = startPin && startPin->width > 1;
+    dc.SetPen(selected ? wxPen(*wxRED, bus ? 3 : 1) : wxPen(*wxBLACK, bus ? 3 : 1));
 
     // Draw the wire segments
     for (size_t i = 0; i < points.size() - 1; ++i) {
@@ -0,0 +1,52 @@
+#include "../../include/core/and_inverter_graph.h"
+#include <algorithm>
+
+const uint32_t AndInverterGraph::FALSE_LITERAL;
+const uint32_t AndInverterGraph::TRUE_LITERAL;
+const uint32_t AndInverterGraph::NO_FANIN;
+
+AndInverterGraph::AndInverterGraph() {
+    Clear();
+}
+
+void AndInverterGraph::Clear() {
+    nodes.assign(1, Node{ NO_FANIN, NO_FANIN });
+    inputs.clear();
+    strash.clear();
+}
+
+uint32_t AndInverterGraph::AddInput() {
+    uint32_t node = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{ NO_FANIN, NO_FANIN });
+    inputs.push_back(node);
+    return node * 2;
+}
+
+uint32_t AndInverterGraph::And(uint32_t a, uint32_t b) {
+    if (a > b) std::swap(a, b);
+
+    if (a == FALSE_LITERAL) return FALSE_LITERAL;
+    if (a == TRUE_LITERAL) return b;
+    if (a == b) return a;
+    if (a == Not(b)) return FALSE_LITERAL;
+
+    uint64_t key = (uint64_t(a) << 32) | b;
+    auto found = strash.find(key);
+    if (found != strash.end()) return found->second * 2;
+
+    uint32_t node = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(Node{ a, b });
+    strash.emplace(key, node);
+    return node * 2;
+}
+
+uint32_t AndInverterGraph::Xor(uint32_t a, uint32_t b) {
+    if (a == b) return FALSE_LITERAL;
+    if (a == Not(b)) return TRUE_LITERAL;
+    return Or(And(a, Not(b)), And(Not(a), b));
+}
+
+uint32_t AndInverterGraph::Mux(uint32_t select, uint32_t whenHigh, uint32_t whenLow) {
+    if (whenHigh == whenLow) return whenHigh;
+    return Or(And(select, whenHigh), And(Not(select), whenLow));
+}
@@ -4,14 +4,19 @@
 #include "../../include/components/arithmetic_components.h"
 #include "../../include/components/io_components.h"
 #include "../../include/components/wire.h"
+#include "../../include/components/component_factory.h"
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/core/subcircuit_library.h"
+#include "../../include/core/memory_image.h"
 #include <wx/config.h>
 #include <wx/wfstream.h>
 #include <wx/txtstrm.h>
 #include <wx/filename.h>
+#include <wx/tokenzr.h>
 #include <algorithm>
 #include <memory>
 
-CircuitDocument::CircuitDocument() : modified(false), title("Untitled Circuit") {
+CircuitDocument::CircuitDocument() : modified(false), title("Untitled Circuit"), pool(ComponentPool::Create()) {
     SetProperty("version", "2.0");
     SetProperty("description", "Logic Circuit Design");
 }
@@ -21,12 +26,15 @@ CircuitDocument::~CircuitDocument() {
 }
 
 bool CircuitDocument::LoadFromFile(const wxString& filepath) {
+    lastError.Clear();
     if (!wxFileExists(filepath)) {
+        lastError = wxString::Format("File not found: %s", filepath);
         return false;
     }
 
     wxFileInputStream fileStream(filepath);
     if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot open %s", filepath);
         return false;
     }
 
@@ -91,8 +99,15 @@ void CircuitDocument::RemoveComponent(CircuitComponent* component) {
     }
 }
 
+std::vector<std::unique_ptr<CircuitComponent>> CircuitDocument::ReleaseComponents() {
+    std::vector<std::unique_ptr<CircuitComponent>> released;
+    released.swap(components);
+    return released;
+}
+
 void CircuitDocument::ClearComponents() {
     components.clear();
+    pool->ReleaseIfUnused();
     SetModified(true);
 }
 
@@ -113,40 +128,109 @@ wxString CircuitDocument::GetProperty(const wxString& key, const wxString& defau
 }
 
 wxString CircuitDocument::SerializeToJSON() const {
-    // Simplified JSON serialization
+    // One object per line so the reader can stay line based
     wxString json = "{\n";
 
     // Metadata
     json += "  \"metadata\": {\n";
     json += "    \"version\": \"" + GetProperty("version", "2.0") + "\",\n";
-    json += "    \"title\": \"" + title + "\",\n";
+    json += "    \"title\": \"" + EscapeString(title) + "\",\n";
     json += "    \"description\": \"Logic Circuit Design\",\n";
     json += "    \"created\": \"" + wxDateTime::Now().Format() + "\"\n";
     json += "  },\n";
 
-    // Simple components array (empty for now)
-    json += "  \"components\": []\n";
+    // Components, indexed in file order; wires refer to them by index
+    std::map<const Pin*, PinLocation> pinLocations;
+    std::vector<const Wire*> wires;
+    std::vector<wxString> componentLines;
+
+    for (const auto& component : components) {
+        if (component->GetType() == ComponentType::WIRE) {
+            wires.push_back(static_cast<const Wire*>(component.get()));
+            continue;
+        }
+
+        const auto& pins = component->GetPins();
+        for (size_t p = 0; p < pins.size(); ++p) {
+            pinLocations[&pins[p]] = PinLocation{ static_cast<long>(componentLines.size()), static_cast<long>(p) };
+        }
+        componentLines.push_back("    " + SerializeComponent(*component));
+    }
+
+    json += "  \"components\": [\n";
+    for (size_t i = 0; i < componentLines.size(); ++i) {
+        json += componentLines[i] + (i + 1 < componentLines.size() ? ",\n" : "\n");
+    }
+    json += "  ],\n";
+
+    // Wires as (component, pin) pairs plus their drawn route
+    std::vector<wxString> wireLines;
+    for (const Wire* wire : wires) {
+        auto start = pinLocations.find(wire->GetStartPin());
+        auto end = pinLocations.find(wire->GetEndPin());
+        if (start == pinLocations.end() || end == pinLocations.end()) continue;
+
+        wireLines.push_back("    " + SerializeWire(*wire, start->second, end->second));
+    }
+
+    json += "  \"wires\": [\n";
+    for (size_t i = 0; i < wireLines.size(); ++i) {
+        json += wireLines[i] + (i + 1 < wireLines.size() ? ",\n" : "\n");
+    }
+    json += "  ]\n";
     json += "}";
 
     return json;
 }
 
 bool CircuitDocument::DeserializeFromJSON(const wxString& jsonData) {
-    // Simplified JSON parsing - for now, just return true
-    // In a full implementation, you would use a proper JSON parser
-
+    // Reads the line based layout written by SerializeToJSON
     ClearComponents();
+    ComponentPool::Scope scope(pool.get());
+
+    enum class Section { NONE, COMPONENTS, WIRES } section = Section::NONE;
+    std::vector<CircuitComponent*> placed; // Non-wire components in file order
+
+    size_t start = 0;
+    while (start < jsonData.length()) {
+        size_t end = jsonData.find('\n', start);
+        if (end == wxString::npos) end = jsonData.length();
+        wxString line = jsonData.Mid(start, end - start).Trim(false).Trim(true);
+        start = end + 1;
+
+        if (line.StartsWith("\"title\"")) {
+            title = ReadStringField(line, "title");
+            continue;
+        }
+        if (line.StartsWith("\"components\"")) {
+            section = Section::COMPONENTS;
+            continue;
+        }
+        if (line.StartsWith("\"wires\"")) {
+            section = Section::WIRES;
+            continue;
+        }
+        if (!line.StartsWith("{\"")) continue;
 
-    // For now, just parse basic metadata
-    if (jsonData.Contains("\"title\"")) {
-        // Very basic title extraction
-        size_t titleStart = jsonData.Find("\"title\": \"");
-        if (titleStart != wxNOT_FOUND) {
-            titleStart += 10; // Length of "\"title\": \""
-            size_t titleEnd = jsonData.find('\"', titleStart);
-            if (titleEnd != wxNOT_FOUND) {
-                title = jsonData.Mid(titleStart, titleEnd - titleStart);
+        if (section == Section::COMPONENTS) {
+            std::unique_ptr<CircuitComponent> component = DeserializeComponent(line, lastError);
+            if (!component) {
+                return false;
             }
+
+            placed.push_back(component.get());
+            components.push_back(std::move(component));
+        } else if (section == Section::WIRES) {
+            PinLocation from, to;
+            if (!ReadWireEnds(line, from, to)) continue;
+
+            Pin* startPin = GetPinAt(placed, from.component, from.pin);
+            Pin* endPin = GetPinAt(placed, to.component, to.pin);
+            if (!startPin || !endPin) continue;
+
+            auto wire = DeserializeWire(line, startPin, placed[from.component]->GetPinPosition(*startPin),
+                                        endPin, placed[to.component]->GetPinPosition(*endPin));
+            components.push_back(std::move(wire));
         }
     }
 
@@ -156,22 +240,239 @@ bool CircuitDocument::DeserializeFromJSON(const wxString& jsonData) {
 void CircuitDocument::LoadToCanvas(CircuitCanvas* canvas) {
     if (!canvas) return;
 
-    // Clear canvas components
     canvas->ClearComponents();
 
-    // For now, just refresh canvas
-    // In a full implementation, we would recreate components from saved data
+    // The canvas gets its own copy so the document stays a snapshot of the file
+    ComponentPool::Scope scope(canvas->GetComponentPool());
+    std::vector<std::unique_ptr<CircuitComponent>> copies;
+    ComponentFactory::CloneCircuit(components, copies);
+    for (auto& component : copies) {
+        canvas->AddComponentDirectly(std::move(component));
+    }
+
+    canvas->SimulateCircuit();
     canvas->Refresh();
 }
 
 void CircuitDocument::SaveFromCanvas(CircuitCanvas* canvas) {
     if (!canvas) return;
 
-    // For now, just mark document as modified
-    // The actual serialization will happen in SerializeToJSON based on canvas state
+    ClearComponents();
+    ComponentPool::Scope scope(pool.get());
+    ComponentFactory::CloneCircuit(canvas->GetComponents(), components);
     SetModified(true);
 }
 
+wxString CircuitDocument::SerializeComponent(const CircuitComponent& component) {
+    double sx, sy;
+    component.GetScale(sx, sy);
+    wxString line = wxString::Format("{\"id\": %u, \"type\": \"%s\", \"x\": %d, \"y\": %d, \"rotation\": %g, \"scaleX\": %g, \"scaleY\": %g",
+                                     component.GetId(), ComponentFactory::GetTypeName(component.GetType()),
+                                     component.GetPosition().x, component.GetPosition().y,
+                                     component.GetRotation(), sx, sy);
+
+    if (auto inputSwitch = dynamic_cast<const InputSwitch*>(&component)) {
+        line += ", \"label\": \"" + EscapeString(inputSwitch->GetLabel()) + "\"";
+        line += wxString::Format(", \"state\": %d", inputSwitch->GetValue() == LogicValue::HIGH ? 1 : 0);
+    } else if (auto subcircuit = dynamic_cast<const SubcircuitComponent*>(&component)) {
+        line += ", \"definition\": \"" + EscapeString(subcircuit->GetDefinition()->GetFilePath()) + "\"";
+    } else if (auto outputLED = dynamic_cast<const OutputLED*>(&component)) {
+        line += ", \"label\": \"" + EscapeString(outputLED->GetLabel()) + "\"";
+    }
+    if (component.GetDataWidth() > 0) {
+        line += wxString::Format(", \"width\": %d", component.GetDataWidth());
+    }
+    if (component.GetInputCount() > 0) {
+        line += wxString::Format(", \"inputs\": %d", component.GetInputCount());
+    }
+    if (const MemoryImage* memory = component.GetMemory()) {
+        // Contents written at run time are not saved, only the file they came from
+        line += wxString::Format(", \"address_width\": %d", component.GetAddressWidth());
+        line += ", \"contents\": \"" + EscapeString(memory->GetSourcePath()) + "\"";
+    }
+    if (component.HasCustomDelay()) {
+        line += wxString::Format(", \"rise_delay\": %u, \"fall_delay\": %u",
+                                 component.GetDelay().rise, component.GetDelay().fall);
+    }
+
+    return line + "}";
+}
+
+std::unique_ptr<CircuitComponent> CircuitDocument::DeserializeComponent(const wxString& line, wxString& error,
+                                                                        bool loadContents) {
+    ComponentType type;
+    if (!ComponentFactory::GetTypeFromName(ReadStringField(line, "type"), type)) {
+        error = "Unknown component type " + ReadStringField(line, "type");
+        return nullptr;
+    }
+
+    wxPoint pos(static_cast<int>(ReadNumberField(line, "x")),
+                static_cast<int>(ReadNumberField(line, "y")));
+    std::unique_ptr<CircuitComponent> component;
+    if (type == ComponentType::SUBCIRCUIT) {
+        auto definition = SubcircuitLibrary::GetInstance().Load(ReadStringField(line, "definition"), error);
+        if (!definition) {
+            return nullptr;
+        }
+        component.reset(new SubcircuitComponent(pos, definition));
+    } else {
+        component = CreateComponentFromType(type, pos);
+    }
+    if (!component) {
+        error = "Unsupported component type " + ReadStringField(line, "type");
+        return nullptr;
+    }
+
+    // Width and input count first, they recreate the pins the wires refer to
+    if (component->GetDataWidth() > 0) {
+        component->SetDataWidth(static_cast<int>(ReadNumberField(line, "width", component->GetDataWidth())));
+    }
+    if (component->GetInputCount() > 0) {
+        component->SetInputCount(static_cast<int>(ReadNumberField(line, "inputs", component->GetInputCount())));
+    }
+    if (MemoryImage* memory = component->GetMemory()) {
+        component->SetAddressWidth(static_cast<int>(ReadNumberField(line, "address_width",
+                                                                    component->GetAddressWidth())));
+        wxString contents = ReadStringField(line, "contents");
+        if (loadContents && !contents.empty() && !memory->LoadFromFile(contents)) {
+            error = memory->GetLastError();
+            return nullptr;
+        }
+    }
+    // Files from before IDs were saved leave it to the canvas to number them
+    component->SetId(static_cast<ComponentId>(ReadNumberField(line, "id", NO_COMPONENT_ID)));
+    component->SetRotation(ReadNumberField(line, "rotation"));
+    component->SetScale(ReadNumberField(line, "scaleX", 1.0), ReadNumberField(line, "scaleY", 1.0));
+
+    // Components without delay fields use their type's default
+    double rise = ReadNumberField(line, "rise_delay", -1.0);
+    double fall = ReadNumberField(line, "fall_delay", -1.0);
+    if (rise >= 0 && fall >= 0) {
+        component->SetDelay(PropagationDelay{ static_cast<uint32_t>(rise), static_cast<uint32_t>(fall) });
+    }
+
+    if (auto inputSwitch = dynamic_cast<InputSwitch*>(component.get())) {
+        inputSwitch->SetLabel(ReadStringField(line, "label"));
+        inputSwitch->SetState(ReadNumberField(line, "state") != 0);
+    } else if (auto outputLED = dynamic_cast<OutputLED*>(component.get())) {
+        outputLED->SetLabel(ReadStringField(line, "label"));
+    }
+
+    return component;
+}
+
+wxString CircuitDocument::SerializeWire(const Wire& wire, const PinLocation& from, const PinLocation& to) {
+    wxString line = wxString::Format("{\"id\": %u, \"from\": [%ld, %ld], \"to\": [%ld, %ld], \"points\": [",
+                                     wire.GetId(), from.component, from.pin, to.component, to.pin);
+    const auto& points = wire.GetPoints();
+    for (size_t p = 0; p < points.size(); ++p) {
+        line += wxString::Format(p == 0 ? "%d, %d" : ", %d, %d", points[p].x, points[p].y);
+    }
+    return line + "]}";
+}
+
+bool CircuitDocument::ReadWireEnds(const wxString& line, PinLocation& from, PinLocation& to) {
+    std::vector<long> fromField = ReadNumberArray(line, "from");
+    std::vector<long> toField = ReadNumberArray(line, "to");
+    if (fromField.size() != 2 || toField.size() != 2) return false;
+
+    from = PinLocation{ fromField[0], fromField[1] };
+    to = PinLocation{ toField[0], toField[1] };
+    return true;
+}
+
+std::unique_ptr<Wire> CircuitDocument::DeserializeWire(const wxString& line, Pin* startPin, const wxPoint& startPos,
+                                                       Pin* endPin, const wxPoint& endPos) {
+    auto wire = std::make_unique<Wire>(startPin, startPos);
+    std::vector<long> points = ReadNumberArray(line, "points");
+    // The first and last points are the pins themselves
+    for (size_t p = 2; p + 3 < points.size(); p += 2) {
+        wire->AddPoint(wxPoint(points[p], points[p + 1]));
+    }
+    wire->SetEndPin(endPin, endPos);
+    wire->SetId(static_cast<ComponentId>(ReadNumberField(line, "id", NO_COMPONENT_ID)));
+    startPin->isConnected = true;
+    endPin->isConnected = true;
+    return wire;
+}
+
+std::unique_ptr<CircuitComponent> CircuitDocument::CreateComponentFromType(ComponentType type, const wxPoint& pos) {
+    return std::unique_ptr<CircuitComponent>(ComponentFactory::Create(type, pos));
+}
+
+wxString CircuitDocument::EscapeString(const wxString& str) {
+    wxString escaped;
+    for (wxUniChar ch : str) {
+        if (ch == '"' || ch == '\\') {
+            escaped += '\\';
+        }
+        escaped += ch;
+    }
+    return escaped;
+}
+
+wxString CircuitDocument::ReadStringField(const wxString& line, const wxString& key) {
+    wxString marker = "\"" + key + "\": \"";
+    int pos = line.Find(marker);
+    if (pos == wxNOT_FOUND) return wxString();
+
+    wxString value;
+    for (size_t i = pos + marker.length(); i < line.length(); ++i) {
+        wxUniChar ch = line[i];
+        if (ch == '\\' && i + 1 < line.length()) {
+            value += line[++i];
+        } else if (ch == '"') {
+            break;
+        } else {
+            value += ch;
+        }
+    }
+    return value;
+}
+
+double CircuitDocument::ReadNumberField(const wxString& line, const wxString& key, double defaultValue) {
+    wxString marker = "\"" + key + "\": ";
+    int pos = line.Find(marker);
+    if (pos == wxNOT_FOUND) return defaultValue;
+
+    size_t begin = pos + marker.length();
+    size_t end = begin;
+    while (end < line.length() && line[end] != ',' && line[end] != '}') {
+        ++end;
+    }
+
+    double value;
+    return line.Mid(begin, end - begin).ToCDouble(&value) ? value : defaultValue;
+}
+
+std::vector<long> CircuitDocument::ReadNumberArray(const wxString& line, const wxString& key) {
+    std::vector<long> values;
+    wxString marker = "\"" + key + "\": [";
+    int pos = line.Find(marker);
+    if (pos == wxNOT_FOUND) return values;
+
+    size_t begin = pos + marker.length();
+    size_t end = line.find(']', begin);
+    if (end == wxString::npos) return values;
+
+    wxStringTokenizer tokenizer(line.Mid(begin, end - begin), ", ");
+    while (tokenizer.HasMoreTokens()) {
+        long value;
+        if (tokenizer.GetNextToken().ToLong(&value)) {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+Pin* CircuitDocument::GetPinAt(const std::vector<CircuitComponent*>& placed, long component, long pin) {
+    if (component < 0 || component >= static_cast<long>(placed.size())) return nullptr;
+
+    auto& pins = placed[component]->GetPins();
+    if (pin < 0 || pin >= static_cast<long>(pins.size())) return nullptr;
+    return &pins[pin];
+}
+
 wxString CircuitDocument::LogicValueToString(LogicValue value) const {
     switch (value) {
         case LogicValue::LOW: return "LOW";
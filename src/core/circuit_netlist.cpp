@@ -0,0 +1,1560 @@
+#include "../../include/core/circuit_netlist.h"
+#include "../../include/components/logic_gates.h"
+#include "../../include/components/arithmetic_components.h"
+#include "../../include/components/io_components.h"
+#include "../../include/components/sequential_components.h"
+#include "../../include/components/decoder_encoder_components.h"
+#include "../../include/components/wire.h"
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/components/bus_components.h"
+#include "../../include/components/component_factory.h"
+#include "../../include/core/subcircuit_model.h"
+#include "../../include/core/netlist_compiler.h"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+// Union-find over pin indices, used to merge wired pins into nets
+class PinSets {
+private:
+    std::vector<uint32_t> parent;
+
+public:
+    explicit PinSets(size_t count) : parent(count) {
+        for (size_t i = 0; i < count; ++i) {
+            parent[i] = static_cast<uint32_t>(i);
+        }
+    }
+
+    uint32_t Find(uint32_t pin) {
+        while (parent[pin] != pin) {
+            parent[pin] = parent[parent[pin]];
+            pin = parent[pin];
+        }
+        return pin;
+    }
+
+    void Unite(uint32_t a, uint32_t b) {
+        a = Find(a);
+        b = Find(b);
+        if (a != b) {
+            parent[b] = a;
+        }
+    }
+};
+
+// Gate kernels for full parallel passes. The operation and, for small
+// input counts, the arity are template parameters, so every instantiation
+// is a tight loop with neither tested per gate. Arity 0 takes the input
+// count at run time. Same semantics as EvaluateNodeParallel.
+template <CircuitNetlist::NodeOp Op, uint32_t Arity>
+void EvaluateGates(const uint32_t* nets, uint32_t count, uint32_t arity, CircuitNetlist::LaneWord* words) {
+    typedef CircuitNetlist::NodeOp NodeOp;
+    const bool isAnd = Op == NodeOp::AND || Op == NodeOp::NAND;
+    const bool isXor = Op == NodeOp::XOR || Op == NodeOp::XNOR;
+    const bool inverted = Op == NodeOp::NAND || Op == NodeOp::NOR || Op == NodeOp::XNOR;
+    if (Arity != 0) arity = Arity;
+
+    for (uint32_t g = 0; g < count; ++g, nets += arity + 1) {
+        uint64_t high = isAnd ? ~uint64_t(0) : 0;
+        uint64_t undefined = 0;
+        for (uint32_t i = 0; i < arity; ++i) {
+            const CircuitNetlist::LaneWord& input = words[nets[i]];
+            if (isAnd) {
+                high &= input.high;
+            } else if (isXor) {
+                high ^= input.high;
+                undefined |= input.undefined;
+            } else {
+                high |= input.high;
+            }
+        }
+        if (inverted) high = ~high;
+
+        // Only XOR and XNOR see undefined inputs, which make them LOW
+        words[nets[arity]] = CircuitNetlist::LaneWord{ high & ~undefined, 0 };
+    }
+}
+
+typedef void (*GateKernelFunction)(const uint32_t*, uint32_t, uint32_t, CircuitNetlist::LaneWord*);
+
+template <CircuitNetlist::NodeOp Op>
+GateKernelFunction GateKernelForArity(uint32_t arity) {
+    switch (arity) {
+        case 1: return EvaluateGates<Op, 1>;
+        case 2: return EvaluateGates<Op, 2>;
+        case 3: return EvaluateGates<Op, 3>;
+        case 4: return EvaluateGates<Op, 4>;
+        default: return EvaluateGates<Op, 0>;
+    }
+}
+
+} // namespace
+
+const uint32_t CircuitNetlist::NO_NET;
+const uint32_t CircuitNetlist::NO_MODEL;
+const uint32_t CircuitNetlist::WHEEL_SLOTS;
+
+CircuitNetlist::CircuitNetlist()
+    : hasBuses(false), widthConflicts(0), cachingEnabled(true), cacheEntries(4096), maxTableInputs(16),
+      optimizing(false), optimizationStats{ 0, 0, 0, 0 }, hasLoops(false), nativeCode(false),
+      timed(false), currentTime(0), wheel(WHEEL_SLOTS), wheelCount(0), settleStamp(0),
+      glitchCount(0), pendingCount(0), scanLevel(0), evaluationLimit(0), oscillating(false) {
+}
+
+CircuitNetlist::~CircuitNetlist() {
+}
+
+void CircuitNetlist::SetSubcircuitCaching(bool enabled, size_t entries, size_t tableInputs) {
+    cachingEnabled = enabled;
+    cacheEntries = entries;
+    maxTableInputs = tableInputs;
+
+    // Models built with the old settings are dropped
+    models.clear();
+    modelIndex.clear();
+}
+
+void CircuitNetlist::Clear() {
+    nodes.clear();
+    nodeIndex.clear();
+    inputNets.clear();
+    outputNets.clear();
+    netValues.clear();
+    netWidths.clear();
+    busValues.clear();
+    hasBuses = false;
+    widthConflicts = 0;
+    optimizationStats = OptimizationStats{ 0, 0, 0, 0 };
+    constantNets.clear();
+    instances.clear();
+    instanceState.clear();
+    flattenedDefinitions.clear();
+    fanoutOffsets.clear();
+    fanoutNodes.clear();
+    levelOrder.clear();
+    hasLoops = false;
+    gateBatches.clear();
+    batchNets.clear();
+    compiler.reset();
+    inputNodes.clear();
+    outputNodes.clear();
+    clockNets.clear();
+    watchpoints.clear();
+    netWatched.clear();
+    watchpointHits.clear();
+    ClearTimedEvents();
+    projectedValues.clear();
+    projectedBus.clear();
+    netChangeStamp.clear();
+    levelQueues.clear();
+    levelScratch.clear();
+    queued.clear();
+    pendingCount = 0;
+    scanLevel = 0;
+    evaluationLimit = 0;
+    oscillating = false;
+}
+
+CircuitNetlist::NodeOp CircuitNetlist::ClassifyComponent(CircuitComponent* component) {
+    switch (component->GetType()) {
+        case ComponentType::INPUT_PIN:
+        case ComponentType::CLOCK_GENERATOR:
+            return NodeOp::SOURCE;
+        case ComponentType::AND_GATE:  return NodeOp::AND;
+        case ComponentType::OR_GATE:   return NodeOp::OR;
+        case ComponentType::NOT_GATE:  return NodeOp::NOT;
+        case ComponentType::NAND_GATE: return NodeOp::NAND;
+        case ComponentType::NOR_GATE:  return NodeOp::NOR;
+        case ComponentType::XOR_GATE:  return NodeOp::XOR;
+        case ComponentType::XNOR_GATE: return NodeOp::XNOR;
+        case ComponentType::SUBCIRCUIT: return NodeOp::SUBCIRCUIT;
+        default:
+            break;
+    }
+
+    // Blocks are identified by class, their type field is not always reliable
+    if (dynamic_cast<ArithmeticComponent*>(component)) return NodeOp::ARITHMETIC;
+    if (dynamic_cast<SequentialComponent*>(component)) return NodeOp::SEQUENTIAL;
+    if (dynamic_cast<BusComponent*>(component)) return NodeOp::BUS;
+    if (dynamic_cast<Decoder3to8*>(component)) return NodeOp::DECODER_3TO8;
+    if (dynamic_cast<BCDTo7SegmentDecoder*>(component)) return NodeOp::BCD_TO_7SEGMENT;
+    if (dynamic_cast<PriorityEncoder8to3*>(component)) return NodeOp::PRIORITY_ENCODER_8TO3;
+
+    // Anything else with outputs keeps driving whatever its pins hold
+    const auto& pins = component->GetPins();
+    bool hasOutputs = std::any_of(pins.begin(), pins.end(),
+                                  [](const Pin& pin) { return !pin.isInput; });
+    return hasOutputs ? NodeOp::SOURCE : NodeOp::SINK;
+}
+
+uint32_t CircuitNetlist::Flatten(const std::vector<std::unique_ptr<CircuitComponent>>& components, uint32_t instance,
+                                 const SubcircuitDefinition* definition, std::vector<PlacedComponent>& placed,
+                                 std::vector<std::pair<uint32_t, uint32_t>>& joins, uint32_t pinCount,
+                                 std::vector<uint32_t>& portPins) {
+    // Pin numbers are local to this instance, a shared definition's pins are numbered once per instance
+    std::unordered_map<const Pin*, uint32_t> pinIds;
+
+    for (const auto& component : components) {
+        if (component->GetType() == ComponentType::WIRE) continue;
+
+        uint32_t firstPin = pinCount;
+        for (const auto& pin : component->GetPins()) {
+            pinIds[&pin] = pinCount++;
+        }
+
+        // Inside a definition the switches and LEDs are ports, merged with the instance pins below
+        if (definition && (component->GetType() == ComponentType::INPUT_PIN ||
+                           component->GetType() == ComponentType::OUTPUT_PIN)) {
+            continue;
+        }
+
+        // State cannot live in a shared definition, so each instance gets its own copy
+        CircuitComponent* evaluated = component.get();
+        if (instance != 0 && dynamic_cast<SequentialComponent*>(evaluated)) {
+            std::unique_ptr<CircuitComponent> copy = ComponentFactory::Clone(evaluated);
+            if (copy) {
+                evaluated = copy.get();
+                instanceState.push_back(std::move(copy));
+            }
+        }
+
+        PlacedComponent entry;
+        entry.component = evaluated;
+        entry.instance = instance;
+        entry.firstPin = firstPin;
+        entry.model = NO_MODEL;
+
+        // A model switches the whole block at once, so timed mode flattens it to keep the gate delays
+        auto subcircuit = dynamic_cast<const SubcircuitComponent*>(component.get());
+        if (subcircuit && cachingEnabled && !timed) {
+            entry.model = FindModel(subcircuit->GetDefinition());
+        }
+        placed.push_back(entry);
+
+        if (subcircuit && entry.model == NO_MODEL) {
+            const SubcircuitDefinition& childDefinition = *subcircuit->GetDefinition();
+            uint32_t child = static_cast<uint32_t>(instances.size());
+            Instance childInstance = { instance, subcircuit };
+            instances.push_back(childInstance);
+
+            std::vector<uint32_t> childPorts;
+            pinCount = Flatten(childDefinition.GetComponents(), child, &childDefinition,
+                               placed, joins, pinCount, childPorts);
+
+            // Instance pins are the inputs then the outputs, in port order
+            for (uint32_t p = 0; p < childPorts.size(); ++p) {
+                joins.push_back(std::make_pair(firstPin + p, childPorts[p]));
+            }
+        }
+    }
+
+    // Merge pins joined by wires
+    for (const auto& component : components) {
+        if (component->GetType() != ComponentType::WIRE) continue;
+
+        Wire* wire = static_cast<Wire*>(component.get());
+        auto start = pinIds.find(wire->GetStartPin());
+        auto end = pinIds.find(wire->GetEndPin());
+        if (start != pinIds.end() && end != pinIds.end()) {
+            joins.push_back(std::make_pair(start->second, end->second));
+        }
+    }
+
+    if (definition) {
+        for (size_t i = 0; i < definition->GetInputCount(); ++i) {
+            portPins.push_back(pinIds[&definition->GetInputPort(i)->GetPins()[0]]);
+        }
+        for (size_t o = 0; o < definition->GetOutputCount(); ++o) {
+            portPins.push_back(pinIds[&definition->GetOutputPort(o)->GetPins()[0]]);
+        }
+    }
+
+    return pinCount;
+}
+
+uint32_t CircuitNetlist::FindModel(const std::shared_ptr<const SubcircuitDefinition>& definition) {
+    auto known = modelIndex.find(definition.get());
+    if (known != modelIndex.end()) return known->second;
+    if (flattenedDefinitions.count(definition.get())) return NO_MODEL;
+
+    // Compile the definition on its own, with the same settings for nested instances
+    std::unique_ptr<CircuitNetlist> compiled(new CircuitNetlist());
+    compiled->SetSubcircuitCaching(cachingEnabled, cacheEntries, maxTableInputs);
+    compiled->Build(definition->GetComponents());
+
+    if (!SubcircuitModel::IsEligible(*definition, *compiled)) {
+        flattenedDefinitions.insert(definition.get());
+        return NO_MODEL;
+    }
+
+    uint32_t index = static_cast<uint32_t>(models.size());
+    models.push_back(std::unique_ptr<SubcircuitModel>(
+        new SubcircuitModel(definition, std::move(compiled), cacheEntries, maxTableInputs)));
+    modelIndex[definition.get()] = index;
+    return index;
+}
+
+void CircuitNetlist::Build(const std::vector<std::unique_ptr<CircuitComponent>>& components) {
+    Clear();
+
+    // Number every pin of every non-wire component, descending into subcircuits
+    Instance topLevel = { 0, nullptr };
+    instances.push_back(topLevel);
+
+    std::vector<PlacedComponent> placed;
+    std::vector<std::pair<uint32_t, uint32_t>> joins;
+    std::vector<uint32_t> ports;
+    uint32_t pinCount = Flatten(components, 0, nullptr, placed, joins, 0, ports);
+
+    PinSets sets(pinCount);
+    for (const auto& join : joins) {
+        sets.Unite(join.first, join.second);
+    }
+
+    // Give each pin set a dense net index
+    std::vector<uint32_t> pinNets(pinCount, NO_NET);
+    uint32_t netCount = 0;
+    for (uint32_t pin = 0; pin < pinCount; ++pin) {
+        uint32_t root = sets.Find(pin);
+        if (pinNets[root] == NO_NET) {
+            pinNets[root] = netCount++;
+        }
+        pinNets[pin] = pinNets[root];
+    }
+    netValues.assign(netCount, LogicValue::UNDEFINED);
+    netWidths.assign(netCount, 0);
+    netWatched.assign(netCount, 0);
+
+    // Create nodes with their input and output net ranges
+    nodes.reserve(placed.size());
+    nodeIndex.reserve(placed.size());
+    for (const PlacedComponent& entry : placed) {
+        CircuitComponent* component = entry.component;
+        Node node;
+        node.component = component;
+        node.op = entry.model != NO_MODEL ? NodeOp::SUBCIRCUIT_MODEL : ClassifyComponent(component);
+        node.level = 0;
+        node.firstInput = static_cast<uint32_t>(inputNets.size());
+        node.firstOutput = static_cast<uint32_t>(outputNets.size());
+        node.instance = entry.instance;
+        node.model = entry.model;
+        node.delay = component->GetDelay();
+
+        uint32_t pinId = entry.firstPin;
+        for (const auto& pin : component->GetPins()) {
+            uint32_t net = pinNets[pinId++];
+            if (pin.isInput) {
+                inputNets.push_back(net);
+            } else {
+                outputNets.push_back(net);
+            }
+
+            // A net is as wide as its pins; mismatches are counted and the widest wins
+            uint8_t width = static_cast<uint8_t>(pin.width);
+            if (netWidths[net] != 0 && netWidths[net] != width) {
+                ++widthConflicts;
+            }
+            netWidths[net] = std::max(netWidths[net], width);
+        }
+
+        node.inputCount = static_cast<uint32_t>(inputNets.size()) - node.firstInput;
+        node.outputCount = static_cast<uint32_t>(outputNets.size()) - node.firstOutput;
+
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        if (entry.instance == 0 && component->GetType() == ComponentType::INPUT_PIN) {
+            inputNodes.push_back(index);
+        } else if (entry.instance == 0 && component->GetType() == ComponentType::OUTPUT_PIN) {
+            outputNodes.push_back(index);
+        } else if (component->GetType() == ComponentType::CLOCK_GENERATOR && node.outputCount > 0) {
+            clockNets.push_back(outputNets[node.firstOutput]);
+        }
+        nodeIndex.emplace(component, index);
+        nodes.push_back(node);
+    }
+
+    // Nets of port pins inside definitions have no placed pins and stay single lines
+    for (uint8_t& width : netWidths) {
+        if (width == 0) width = 1;
+        hasBuses = hasBuses || width > 1;
+    }
+    if (hasBuses) {
+        busValues.resize(netCount);
+    }
+
+    BuildFanout();
+    ComputeLevels();
+    if (optimizing && !timed) {
+        Optimize();
+        BuildFanout();
+        ComputeLevels();
+    }
+
+    BuildBatches();
+    queued.assign(nodes.size(), 0);
+    netChangeStamp.assign(netValues.size(), 0);
+    // Generous bound on evaluations per settle before declaring oscillation
+    evaluationLimit = nodes.size() * 64 + 1024;
+
+    if (nativeCode) {
+        compiler.reset(new NetlistCompiler());
+        if (!compiler->Start(*this)) {
+            compiler.reset();
+        }
+    }
+}
+
+void CircuitNetlist::BuildFanout() {
+    // Fan-out lists: every node reading a net, listed once per net
+    const size_t netCount = netValues.size();
+    fanoutOffsets.assign(netCount + 1, 0);
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        const Node& node = nodes[n];
+        if (!IsEvaluated(node.op)) continue;
+        for (uint32_t i = 0; i < node.inputCount; ++i) {
+            fanoutOffsets[inputNets[node.firstInput + i] + 1]++;
+        }
+    }
+    for (size_t net = 0; net < netCount; ++net) {
+        fanoutOffsets[net + 1] += fanoutOffsets[net];
+    }
+
+    fanoutNodes.resize(fanoutOffsets[netCount]);
+    std::vector<uint32_t> fill(fanoutOffsets.begin(), fanoutOffsets.end() - 1);
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        const Node& node = nodes[n];
+        if (!IsEvaluated(node.op)) continue;
+        for (uint32_t i = 0; i < node.inputCount; ++i) {
+            uint32_t net = inputNets[node.firstInput + i];
+            // A node reading the same net twice only needs one entry
+            if (fill[net] > fanoutOffsets[net] && fanoutNodes[fill[net] - 1] == n) continue;
+            fanoutNodes[fill[net]++] = n;
+        }
+    }
+    // Compact away the slots skipped for duplicates
+    size_t write = 0;
+    for (size_t net = 0; net < netCount; ++net) {
+        size_t begin = fanoutOffsets[net];
+        fanoutOffsets[net] = static_cast<uint32_t>(write);
+        for (size_t i = begin; i < fill[net]; ++i) {
+            fanoutNodes[write++] = fanoutNodes[i];
+        }
+    }
+    fanoutOffsets[netCount] = static_cast<uint32_t>(write);
+    fanoutNodes.resize(write);
+}
+
+void CircuitNetlist::ComputeLevels() {
+    // Kahn's algorithm over node dependencies. Sequential nodes start new
+    // paths, so feedback through flip-flops does not count as a cycle.
+    std::vector<uint32_t> pending(nodes.size(), 0);
+    std::vector<uint32_t> driversOfNet(netValues.size(), 0);
+    levelOrder.clear();
+
+    for (Node& node : nodes) {
+        node.level = 0;
+        // Instance pins alias nets driven inside the instance, and removed
+        // gates show the nets that replaced them
+        if (node.op == NodeOp::SUBCIRCUIT || node.op == NodeOp::REMOVED) continue;
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            driversOfNet[outputNets[node.firstOutput + o]]++;
+        }
+    }
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        const Node& node = nodes[n];
+        // Only evaluated nodes are on the fan-out lists
+        if (!IsEvaluated(node.op) || node.op == NodeOp::SEQUENTIAL) continue;
+        for (uint32_t i = 0; i < node.inputCount; ++i) {
+            pending[n] += driversOfNet[inputNets[node.firstInput + i]];
+        }
+    }
+
+    std::vector<uint32_t> ready;
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        if (pending[n] == 0) ready.push_back(n);
+    }
+
+    uint32_t maxLevel = 0;
+    size_t visited = 0;
+    while (visited < ready.size()) {
+        uint32_t n = ready[visited++];
+        const Node& node = nodes[n];
+        maxLevel = std::max(maxLevel, node.level);
+        if (node.op == NodeOp::SUBCIRCUIT || node.op == NodeOp::REMOVED) continue;
+
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            uint32_t net = outputNets[node.firstOutput + o];
+            for (uint32_t f = fanoutOffsets[net]; f < fanoutOffsets[net + 1]; ++f) {
+                Node& reader = nodes[fanoutNodes[f]];
+                if (reader.op == NodeOp::SEQUENTIAL) continue;
+                reader.level = std::max(reader.level, node.level + 1);
+
+                // A reader may use the net on several pins
+                for (uint32_t i = 0; i < reader.inputCount; ++i) {
+                    if (inputNets[reader.firstInput + i] == net && --pending[fanoutNodes[f]] == 0) {
+                        ready.push_back(fanoutNodes[f]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Nodes left over sit on combinational loops and go after everything else
+    hasLoops = visited < nodes.size();
+    if (hasLoops) {
+        ++maxLevel;
+        for (uint32_t n = 0; n < nodes.size(); ++n) {
+            if (pending[n] != 0) nodes[n].level = maxLevel;
+        }
+    }
+
+    levelQueues.assign(maxLevel + 1, std::vector<uint32_t>());
+
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        if (IsEvaluated(nodes[n].op)) {
+            levelOrder.push_back(n);
+        }
+    }
+    // Nodes of a level are independent, so grouping them by kernel is free
+    std::stable_sort(levelOrder.begin(), levelOrder.end(), [this](uint32_t a, uint32_t b) {
+        const Node& x = nodes[a];
+        const Node& y = nodes[b];
+        if (x.level != y.level) return x.level < y.level;
+        if (x.op != y.op) return x.op < y.op;
+        return x.inputCount < y.inputCount;
+    });
+}
+
+CircuitNetlist::GateKernel CircuitNetlist::SelectGateKernel(NodeOp op, uint32_t arity) {
+    switch (op) {
+        case NodeOp::AND: return GateKernelForArity<NodeOp::AND>(arity);
+        case NodeOp::NAND: return GateKernelForArity<NodeOp::NAND>(arity);
+        case NodeOp::OR: return GateKernelForArity<NodeOp::OR>(arity);
+        case NodeOp::NOR: return GateKernelForArity<NodeOp::NOR>(arity);
+        case NodeOp::XOR: return GateKernelForArity<NodeOp::XOR>(arity);
+        case NodeOp::XNOR: return GateKernelForArity<NodeOp::XNOR>(arity);
+        case NodeOp::NOT: return GateKernelForArity<NodeOp::NOR>(arity);   // NOT reads only its first input
+        default: return nullptr;
+    }
+}
+
+void CircuitNetlist::BuildBatches() {
+    gateBatches.clear();
+    batchNets.clear();
+
+    for (uint32_t n : levelOrder) {
+        const Node& node = nodes[n];
+        uint32_t arity = node.op == NodeOp::NOT ? std::min<uint32_t>(node.inputCount, 1) : node.inputCount;
+        GateKernel kernel = node.outputCount == 1 ? SelectGateKernel(node.op, arity) : nullptr;
+        if (!kernel) {
+            gateBatches.push_back(GateBatch{ nullptr, 0, 1, n });
+            continue;
+        }
+
+        GateBatch* batch = gateBatches.empty() ? nullptr : &gateBatches.back();
+        if (!batch || batch->kernel != kernel || batch->arity != arity) {
+            gateBatches.push_back(GateBatch{ kernel, arity, 0, static_cast<uint32_t>(batchNets.size()) });
+            batch = &gateBatches.back();
+        }
+        batch->count++;
+        batchNets.insert(batchNets.end(), inputNets.begin() + node.firstInput,
+                         inputNets.begin() + node.firstInput + arity);
+        batchNets.push_back(outputNets[node.firstOutput]);
+    }
+}
+
+uint32_t CircuitNetlist::AddConstantNet(LogicValue value) {
+    uint32_t net = static_cast<uint32_t>(netValues.size());
+    netValues.push_back(value);
+    netWidths.push_back(1);
+    netWatched.push_back(0);
+    if (hasBuses) {
+        busValues.push_back(BusValue{ 0, 0 });
+    }
+    constantNets.emplace_back(net, value);
+    return net;
+}
+
+void CircuitNetlist::Optimize() {
+    // Gates are visited in level order, so their inputs are already
+    // rewritten. Only single-line gates that alone drive their output and
+    // do not sit on a loop are touched; a removed gate's output net is
+    // replaced by an equivalent net everywhere it is read.
+    std::vector<uint32_t> drivers(netValues.size(), 0);
+    std::vector<uint32_t> gateDrivers(netValues.size(), 0);
+    for (const Node& node : nodes) {
+        if (node.op == NodeOp::SUBCIRCUIT) continue;
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            uint32_t net = outputNets[node.firstOutput + o];
+            drivers[net]++;
+            if (IsGate(node.op)) gateDrivers[net]++;
+        }
+    }
+
+    // Gate outputs are never undefined, which buffers and XOR rules rely on
+    std::vector<uint8_t> defined(netValues.size(), 0);
+    for (size_t net = 0; net < netValues.size(); ++net) {
+        defined[net] = drivers[net] > 0 && drivers[net] == gateDrivers[net];
+    }
+
+    std::vector<uint32_t> replacement(netValues.size());
+    for (uint32_t net = 0; net < replacement.size(); ++net) {
+        replacement[net] = net;
+    }
+    std::vector<uint32_t> inverseOf(netValues.size(), NO_NET);    // Net is a NOT of this defined net
+    std::map<std::vector<uint32_t>, uint32_t> gateIndex;           // Function and inputs to output net
+    uint32_t constants[2] = { NO_NET, NO_NET };
+
+    auto constantNet = [&](bool high) {
+        if (constants[high] == NO_NET) {
+            constants[high] = AddConstantNet(high ? LogicValue::HIGH : LogicValue::LOW);
+            replacement.push_back(constants[high]);
+            inverseOf.push_back(NO_NET);
+            defined.push_back(1);
+        }
+        return constants[high];
+    };
+
+    const uint32_t loopLevel = hasLoops ? static_cast<uint32_t>(levelQueues.size() - 1) : ~uint32_t(0);
+    std::vector<uint32_t> operands;
+    for (uint32_t n : levelOrder) {
+        Node& node = nodes[n];
+        if (!IsGate(node.op) || node.outputCount != 1 || node.level == loopLevel) continue;
+        uint32_t output = outputNets[node.firstOutput];
+        if (drivers[output] != 1 || netWidths[output] != 1) continue;
+
+        operands.clear();
+        bool narrow = true;
+        uint32_t used = node.op == NodeOp::NOT ? std::min<uint32_t>(node.inputCount, 1) : node.inputCount;
+        for (uint32_t i = 0; i < used; ++i) {
+            uint32_t net = replacement[inputNets[node.firstInput + i]];
+            narrow = narrow && netWidths[net] == 1;
+            operands.push_back(net);
+        }
+        if (!narrow) continue;
+
+        // Reduce to AND, OR or XOR of the operands, possibly inverted. NOT is
+        // a one-input NOR.
+        NodeOp base = node.op == NodeOp::NAND ? NodeOp::AND
+                    : node.op == NodeOp::NOR || node.op == NodeOp::NOT ? NodeOp::OR
+                    : node.op == NodeOp::XNOR ? NodeOp::XOR : node.op;
+        bool inverted = node.op == NodeOp::NAND || node.op == NodeOp::NOR ||
+                        node.op == NodeOp::NOT || node.op == NodeOp::XNOR;
+
+        // Fold constant operands; a controlling one decides the output
+        bool decided = false;
+        bool value = false;
+        size_t kept = 0;
+        for (uint32_t net : operands) {
+            if (net == constants[0] || net == constants[1]) {
+                bool high = net == constants[1];
+                if (base == NodeOp::XOR) {
+                    inverted ^= high;
+                } else if (high == (base == NodeOp::OR)) {
+                    decided = true;
+                    value = high;
+                }
+                continue;
+            }
+            operands[kept++] = net;
+        }
+        operands.resize(kept);
+
+        // Repeated operands: AND and OR ignore them, XOR cancels them in pairs
+        std::sort(operands.begin(), operands.end());
+        if (base == NodeOp::XOR) {
+            kept = 0;
+            for (size_t i = 0; i < operands.size(); ++i) {
+                if (i + 1 < operands.size() && operands[i] == operands[i + 1] && defined[operands[i]]) {
+                    ++i;
+                    continue;
+                }
+                operands[kept++] = operands[i];
+            }
+            operands.resize(kept);
+        } else {
+            operands.erase(std::unique(operands.begin(), operands.end()), operands.end());
+        }
+
+        uint32_t target = NO_NET;
+        if (decided || operands.empty()) {
+            // No operands left: AND of nothing is HIGH, OR and XOR of nothing LOW
+            if (!decided) value = base == NodeOp::AND;
+            target = constantNet(value != inverted);
+            optimizationStats.constantGates++;
+        } else if (operands.size() == 1 && defined[operands[0]]) {
+            // On a defined net every one-input gate is a buffer or a NOT
+            uint32_t source = operands[0];
+            if (!inverted) {
+                target = source;
+            } else if (inverseOf[source] != NO_NET) {
+                target = inverseOf[source];
+            } else {
+                inverseOf[output] = source;
+                base = NodeOp::OR;
+            }
+            if (target != NO_NET) optimizationStats.bufferGates++;
+        }
+
+        if (target == NO_NET) {
+            // Structural hashing: the same function of the same nets is one gate
+            operands.push_back(static_cast<uint32_t>(base) * 2 + inverted);
+            auto found = gateIndex.find(operands);
+            if (found == gateIndex.end()) {
+                gateIndex.emplace(operands, output);
+                continue;
+            }
+            target = found->second;
+            optimizationStats.mergedGates++;
+        }
+
+        replacement[output] = target;
+        node.op = NodeOp::REMOVED;
+    }
+
+    for (uint32_t& net : inputNets) net = replacement[net];
+    for (uint32_t& net : outputNets) net = replacement[net];
+
+    // Gates inside subcircuit instances whose outputs nobody reads are dead,
+    // so an unconnected instance output shows undefined. Top-level gates
+    // are kept because their pins are on screen.
+    std::vector<uint32_t> readers(netValues.size(), 0);
+    for (const Node& node : nodes) {
+        // Output ports inside an instance are only read through the instance pins
+        if (node.op == NodeOp::REMOVED || (node.op == NodeOp::SINK && node.instance != 0)) continue;
+        for (uint32_t i = 0; i < node.inputCount; ++i) {
+            readers[inputNets[node.firstInput + i]]++;
+        }
+    }
+    for (size_t i = levelOrder.size(); i-- > 0;) {
+        Node& node = nodes[levelOrder[i]];
+        if (!IsGate(node.op) || node.instance == 0) continue;
+
+        bool read = false;
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            read = read || readers[outputNets[node.firstOutput + o]] > 0;
+        }
+        if (read) continue;
+
+        for (uint32_t in = 0; in < node.inputCount; ++in) {
+            readers[inputNets[node.firstInput + in]]--;
+        }
+        node.op = NodeOp::REMOVED;
+        optimizationStats.deadGates++;
+    }
+}
+
+wxString CircuitNetlist::DescribeNode(size_t index) const {
+    const Node& node = nodes[index];
+    wxString name = ComponentFactory::GetTypeName(node.component->GetType());
+    if (auto inputSwitch = dynamic_cast<const InputSwitch*>(node.component)) {
+        if (!inputSwitch->GetLabel().empty()) name += " \"" + inputSwitch->GetLabel() + "\"";
+    } else if (auto outputLED = dynamic_cast<const OutputLED*>(node.component)) {
+        if (!outputLED->GetLabel().empty()) name += " \"" + outputLED->GetLabel() + "\"";
+    }
+    if (node.instance != 0) {
+        name += " (in subcircuit)";
+    }
+    return name;
+}
+
+int CircuitNetlist::FindNode(const CircuitComponent* component) const {
+    auto it = nodeIndex.find(component);
+    return it != nodeIndex.end() ? static_cast<int>(it->second) : -1;
+}
+
+uint32_t CircuitNetlist::GetInputNet(size_t node, size_t input) const {
+    const Node& n = nodes[node];
+    return input < n.inputCount ? inputNets[n.firstInput + input] : NO_NET;
+}
+
+uint32_t CircuitNetlist::GetOutputNet(size_t node, size_t output) const {
+    const Node& n = nodes[node];
+    return output < n.outputCount ? outputNets[n.firstOutput + output] : NO_NET;
+}
+
+uint32_t CircuitNetlist::FindPinNet(const CircuitComponent* component, size_t pinIndex) const {
+    int node = FindNode(component);
+    const auto& pins = component->GetPins();
+    if (node < 0 || pinIndex >= pins.size()) return NO_NET;
+
+    // Inputs and outputs are numbered separately, in pin order
+    size_t sameDirection = 0;
+    for (size_t p = 0; p < pinIndex; ++p) {
+        if (pins[p].isInput == pins[pinIndex].isInput) ++sameDirection;
+    }
+    return pins[pinIndex].isInput ? GetInputNet(node, sameDirection) : GetOutputNet(node, sameDirection);
+}
+
+int CircuitNetlist::FindInput(const wxString& label) const {
+    for (uint32_t n : inputNodes) {
+        if (static_cast<const InputSwitch*>(nodes[n].component)->GetLabel() == label) {
+            return static_cast<int>(n);
+        }
+    }
+    return -1;
+}
+
+int CircuitNetlist::FindOutput(const wxString& label) const {
+    for (uint32_t n : outputNodes) {
+        if (static_cast<const OutputLED*>(nodes[n].component)->GetLabel() == label) {
+            return static_cast<int>(n);
+        }
+    }
+    return -1;
+}
+
+void CircuitNetlist::SetInputValue(size_t node, LogicValue value) {
+    const Node& n = nodes[node];
+    if (n.outputCount > 0) {
+        DriveNet(outputNets[n.firstOutput], value);
+    }
+}
+
+LogicValue CircuitNetlist::GetOutputValue(size_t node) const {
+    const Node& n = nodes[node];
+    return n.inputCount > 0 ? netValues[inputNets[n.firstInput]] : LogicValue::UNDEFINED;
+}
+
+void CircuitNetlist::SetNetValue(size_t net, LogicValue value) {
+    DriveNet(static_cast<uint32_t>(net), value);
+}
+
+void CircuitNetlist::SetBusValue(size_t net, BusValue value) {
+    DriveBus(static_cast<uint32_t>(net), value);
+}
+
+BusValue CircuitNetlist::ReadNet(size_t net) const {
+    if (netWidths[net] > 1) return busValues[net];
+
+    BusValue value = { netValues[net] == LogicValue::HIGH ? uint64_t(1) : 0,
+                       netValues[net] == LogicValue::UNDEFINED ? uint64_t(1) : 0 };
+    return value;
+}
+
+void CircuitNetlist::AddWatchpoint(const Watchpoint& watchpoint) {
+    if (watchpoint.net >= netValues.size()) return;
+
+    watchpoints.push_back(watchpoint);
+    netWatched[watchpoint.net] = 1;
+}
+
+void CircuitNetlist::ClearWatchpoints() {
+    watchpoints.clear();
+    watchpointHits.clear();
+    std::fill(netWatched.begin(), netWatched.end(), 0);
+}
+
+void CircuitNetlist::CheckWatchpoints(uint32_t net) {
+    BusValue value = ReadNet(net);
+    for (const Watchpoint& watchpoint : watchpoints) {
+        if (watchpoint.net != net) continue;
+
+        bool hit = false;
+        switch (watchpoint.kind) {
+            case Watchpoint::Kind::CHANGES:
+                hit = true;
+                break;
+            case Watchpoint::Kind::GOES_HIGH:
+                hit = netValues[net] == LogicValue::HIGH;
+                break;
+            case Watchpoint::Kind::GOES_LOW:
+                hit = netValues[net] == LogicValue::LOW;
+                break;
+            case Watchpoint::Kind::EQUALS:
+                hit = value.bits == watchpoint.value.bits && value.undefined == watchpoint.value.undefined;
+                break;
+        }
+        if (hit && std::find(watchpointHits.begin(), watchpointHits.end(), watchpoint.tag) == watchpointHits.end()) {
+            watchpointHits.push_back(watchpoint.tag);
+        }
+    }
+}
+
+void CircuitNetlist::DriveNet(uint32_t net, LogicValue value) {
+    if (netValues[net] == value) return;
+
+    netValues[net] = value;
+    if (netWatched[net]) CheckWatchpoints(net);
+    ScheduleFanout(net);
+}
+
+void CircuitNetlist::DriveBus(uint32_t net, BusValue value) {
+    // Undefined lines read as 0 so equal values compare equal
+    uint64_t mask = BusMask(netWidths[net]);
+    value.undefined &= mask;
+    value.bits &= mask & ~value.undefined;
+
+    BusValue& current = busValues[net];
+    if (current.bits == value.bits && current.undefined == value.undefined) return;
+
+    current = value;
+    if (netWatched[net]) CheckWatchpoints(net);
+    ScheduleFanout(net);
+}
+
+void CircuitNetlist::ScheduleFanout(uint32_t net) {
+    for (uint32_t f = fanoutOffsets[net]; f < fanoutOffsets[net + 1]; ++f) {
+        Schedule(fanoutNodes[f]);
+    }
+}
+
+void CircuitNetlist::Schedule(uint32_t node) {
+    if (queued[node]) return;
+
+    queued[node] = 1;
+    uint32_t level = nodes[node].level;
+    levelQueues[level].push_back(node);
+    ++pendingCount;
+    if (level < scanLevel) {
+        scanLevel = level;
+    }
+}
+
+void CircuitNetlist::Reset() {
+    std::fill(netValues.begin(), netValues.end(), LogicValue::UNDEFINED);
+    for (size_t net = 0; net < busValues.size(); ++net) {
+        busValues[net].bits = 0;
+        busValues[net].undefined = BusMask(netWidths[net]);
+    }
+    for (const auto& constant : constantNets) {
+        netValues[constant.first] = constant.second;
+    }
+    oscillating = false;
+
+    // Time restarts with nothing pending
+    ClearTimedEvents();
+    currentTime = 0;
+    projectedValues = netValues;
+    projectedBus = busValues;
+
+    UpdateSources();
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        if (IsEvaluated(nodes[n].op)) {
+            Schedule(n);
+        }
+    }
+}
+
+void CircuitNetlist::UpdateSources() {
+    for (uint32_t n = 0; n < nodes.size(); ++n) {
+        const Node& node = nodes[n];
+        if (node.op != NodeOp::SOURCE) continue;
+
+        // Once driven, clock nets are stepped by the simulation controller
+        if (node.component->GetType() == ComponentType::CLOCK_GENERATOR &&
+            netValues[outputNets[node.firstOutput]] != LogicValue::UNDEFINED) continue;
+
+        // Switches drive their state; other sources drive their current pins
+        if (node.component->GetType() == ComponentType::INPUT_PIN) {
+            SetInputValue(n, static_cast<InputSwitch*>(node.component)->GetValue());
+        } else {
+            uint32_t output = node.firstOutput;
+            for (const auto& pin : node.component->GetPins()) {
+                if (pin.isInput) continue;
+                uint32_t net = outputNets[output++];
+                if (netWidths[net] > 1) {
+                    DriveBus(net, pin.bus);
+                } else {
+                    DriveNet(net, pin.value);
+                }
+            }
+        }
+    }
+}
+
+bool CircuitNetlist::Settle() {
+    size_t evaluations = 0;
+    ++settleStamp;
+    glitchCount = 0;
+
+    if (!EvaluateQueued(evaluations)) return false;
+
+    // Timed mode: step from one pending change to the next until the circuit is quiet
+    while (timed && AdvanceTime()) {
+        if (!EvaluateQueued(evaluations)) {
+            ClearTimedEvents();
+            return false;
+        }
+    }
+
+    oscillating = false;
+    return true;
+}
+
+bool CircuitNetlist::EvaluateQueued(size_t& evaluations) {
+    scanLevel = 0;
+
+    while (pendingCount > 0) {
+        while (levelQueues[scanLevel].empty()) {
+            ++scanLevel;
+        }
+
+        // Evaluating may queue more nodes on this level, so work on a copy
+        levelScratch.swap(levelQueues[scanLevel]);
+        for (uint32_t n : levelScratch) {
+            queued[n] = 0;
+            --pendingCount;
+            Evaluate(n);
+        }
+        evaluations += levelScratch.size();
+        levelScratch.clear();
+
+        if (evaluations > evaluationLimit) {
+            // Drop the remaining events so the next settle starts clean
+            for (auto& queue : levelQueues) {
+                for (uint32_t n : queue) queued[n] = 0;
+                queue.clear();
+            }
+            pendingCount = 0;
+            oscillating = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+void CircuitNetlist::SetTimedMode(bool enabled) {
+    timed = enabled;
+    ClearTimedEvents();
+}
+
+void CircuitNetlist::DriveOutput(const Node& node, uint32_t net, LogicValue value) {
+    if (!timed) {
+        DriveNet(net, value);
+        return;
+    }
+    if (projectedValues[net] == value) return;
+    projectedValues[net] = value;
+
+    // Undefined takes the slower of the two edges
+    uint32_t delay = value == LogicValue::HIGH ? node.delay.rise
+                   : value == LogicValue::LOW ? node.delay.fall
+                   : std::max(node.delay.rise, node.delay.fall);
+    TimedEvent event = { currentTime + delay, net, value, BusValue{ 0, 0 } };
+    if (delay == 0) {
+        ApplyEvent(event);
+    } else {
+        ScheduleEvent(event);
+    }
+}
+
+void CircuitNetlist::DriveOutputBus(const Node& node, uint32_t net, BusValue value) {
+    if (!timed) {
+        DriveBus(net, value);
+        return;
+    }
+
+    uint64_t mask = BusMask(netWidths[net]);
+    value.undefined &= mask;
+    value.bits &= mask & ~value.undefined;
+    BusValue& projected = projectedBus[net];
+    if (projected.bits == value.bits && projected.undefined == value.undefined) return;
+    projected = value;
+
+    // A bus settles when its slowest line has
+    uint32_t delay = std::max(node.delay.rise, node.delay.fall);
+    TimedEvent event = { currentTime + delay, net, LogicValue::UNDEFINED, value };
+    if (delay == 0) {
+        ApplyEvent(event);
+    } else {
+        ScheduleEvent(event);
+    }
+}
+
+void CircuitNetlist::ScheduleEvent(const TimedEvent& event) {
+    if (event.time - currentTime < WHEEL_SLOTS) {
+        wheel[event.time & (WHEEL_SLOTS - 1)].push_back(event);
+        ++wheelCount;
+    } else {
+        farEvents.push_back(event);
+    }
+}
+
+bool CircuitNetlist::AdvanceTime() {
+    if (wheelCount == 0 && farEvents.empty()) return false;
+
+    // With only far changes left, jump to the turn of the earliest one
+    if (wheelCount == 0) {
+        uint64_t earliest = farEvents[0].time;
+        for (const TimedEvent& event : farEvents) {
+            earliest = std::min(earliest, event.time);
+        }
+        currentTime = std::max(currentTime, (earliest & ~uint64_t(WHEEL_SLOTS - 1)) - 1);
+    }
+
+    for (;;) {
+        ++currentTime;
+        if ((currentTime & (WHEEL_SLOTS - 1)) == 0 && !farEvents.empty()) {
+            // New turn: bring in the far changes that fall into it
+            size_t keep = 0;
+            for (const TimedEvent& event : farEvents) {
+                if (event.time - currentTime < WHEEL_SLOTS) {
+                    wheel[event.time & (WHEEL_SLOTS - 1)].push_back(event);
+                    ++wheelCount;
+                } else {
+                    farEvents[keep++] = event;
+                }
+            }
+            farEvents.resize(keep);
+        }
+        if (!wheel[currentTime & (WHEEL_SLOTS - 1)].empty()) break;
+    }
+
+    // Changes made while applying go to other slots, delays are at least 1
+    wheelScratch.swap(wheel[currentTime & (WHEEL_SLOTS - 1)]);
+    wheelCount -= wheelScratch.size();
+    for (const TimedEvent& event : wheelScratch) {
+        ApplyEvent(event);
+    }
+    wheelScratch.clear();
+    return true;
+}
+
+void CircuitNetlist::ApplyEvent(const TimedEvent& event) {
+    bool changed;
+    if (netWidths[event.net] > 1) {
+        const BusValue& current = busValues[event.net];
+        changed = current.bits != event.bus.bits || current.undefined != event.bus.undefined;
+        DriveBus(event.net, event.bus);
+    } else {
+        changed = netValues[event.net] != event.value;
+        DriveNet(event.net, event.value);
+    }
+
+    if (!changed) return;
+    if (netChangeStamp[event.net] == settleStamp) {
+        ++glitchCount;
+    }
+    netChangeStamp[event.net] = settleStamp;
+}
+
+void CircuitNetlist::ClearTimedEvents() {
+    for (auto& slot : wheel) {
+        slot.clear();
+    }
+    farEvents.clear();
+    wheelCount = 0;
+}
+
+void CircuitNetlist::Evaluate(uint32_t n) {
+    const Node& node = nodes[n];
+    const uint32_t* in = inputNets.data() + node.firstInput;
+
+    // Gate kernels match the semantics of the LogicGate::Evaluate overrides
+    LogicValue result;
+    switch (node.op) {
+        case NodeOp::AND:
+        case NodeOp::NAND: {
+            bool allHigh = true;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                allHigh = allHigh && netValues[in[i]] == LogicValue::HIGH;
+            }
+            result = (allHigh == (node.op == NodeOp::AND)) ? LogicValue::HIGH : LogicValue::LOW;
+            break;
+        }
+        case NodeOp::OR:
+        case NodeOp::NOR: {
+            bool anyHigh = false;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                anyHigh = anyHigh || netValues[in[i]] == LogicValue::HIGH;
+            }
+            result = (anyHigh == (node.op == NodeOp::OR)) ? LogicValue::HIGH : LogicValue::LOW;
+            break;
+        }
+        case NodeOp::NOT:
+            result = (node.inputCount > 0 && netValues[in[0]] == LogicValue::HIGH) ? LogicValue::LOW : LogicValue::HIGH;
+            break;
+        case NodeOp::XOR:
+        case NodeOp::XNOR: {
+            // Any undefined input gives LOW
+            bool defined = true;
+            bool parity = false;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                LogicValue value = netValues[in[i]];
+                defined = defined && value != LogicValue::UNDEFINED;
+                parity ^= (value == LogicValue::HIGH);
+            }
+            result = (defined && parity == (node.op == NodeOp::XOR)) ? LogicValue::HIGH : LogicValue::LOW;
+            break;
+        }
+        case NodeOp::SOURCE:
+        case NodeOp::SINK:
+        case NodeOp::SUBCIRCUIT:
+        case NodeOp::REMOVED:
+            return;
+        case NodeOp::SUBCIRCUIT_MODEL: {
+            uint64_t high = 0;
+            uint64_t undefined = 0;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                LogicValue value = netValues[in[i]];
+                if (value == LogicValue::HIGH) high |= uint64_t(1) << i;
+                if (value == LogicValue::UNDEFINED) undefined |= uint64_t(1) << i;
+            }
+
+            uint64_t outputs = models[node.model]->Evaluate(high, undefined);
+            for (uint32_t o = 0; o < node.outputCount; ++o) {
+                DriveOutput(node, outputNets[node.firstOutput + o],
+                            ((outputs >> (o + 32)) & 1) ? LogicValue::UNDEFINED
+                            : ((outputs >> o) & 1) ? LogicValue::HIGH : LogicValue::LOW);
+            }
+            return;
+        }
+        default:
+            EvaluateBlock(node);
+            return;
+    }
+
+    for (uint32_t o = 0; o < node.outputCount; ++o) {
+        DriveOutput(node, outputNets[node.firstOutput + o], result);
+    }
+}
+
+void CircuitNetlist::EvaluateBlock(const Node& node) {
+    // Blocks without a native kernel run their own code on the component pins
+    auto& pins = node.component->GetPins();
+    uint32_t input = node.firstInput;
+    for (auto& pin : pins) {
+        if (!pin.isInput) continue;
+        uint32_t net = inputNets[input++];
+        if (netWidths[net] > 1) {
+            pin.bus = busValues[net];
+        } else {
+            pin.value = netValues[net];
+        }
+    }
+
+    switch (node.op) {
+        case NodeOp::ARITHMETIC:
+            static_cast<ArithmeticComponent*>(node.component)->ComputeOutputs();
+            break;
+        case NodeOp::SEQUENTIAL:
+            static_cast<SequentialComponent*>(node.component)->UpdateOnClock();
+            break;
+        case NodeOp::BUS:
+            static_cast<BusComponent*>(node.component)->ComputeOutputs();
+            break;
+        case NodeOp::DECODER_3TO8:
+            static_cast<Decoder3to8*>(node.component)->ComputeOutputs();
+            break;
+        case NodeOp::BCD_TO_7SEGMENT:
+            static_cast<BCDTo7SegmentDecoder*>(node.component)->ComputeOutputs();
+            break;
+        case NodeOp::PRIORITY_ENCODER_8TO3:
+            static_cast<PriorityEncoder8to3*>(node.component)->ComputeOutputs();
+            break;
+        default:
+            break;
+    }
+
+    uint32_t output = node.firstOutput;
+    for (const auto& pin : pins) {
+        if (pin.isInput) continue;
+        uint32_t net = outputNets[output++];
+        if (netWidths[net] > 1) {
+            DriveOutputBus(node, net, pin.bus);
+        } else {
+            DriveOutput(node, net, pin.value);
+        }
+    }
+}
+
+void CircuitNetlist::WriteBack() const {
+    for (const Node& node : nodes) {
+        // Components inside subcircuits belong to shared definitions
+        if (node.instance != 0) continue;
+
+        uint32_t input = node.firstInput;
+        uint32_t output = node.firstOutput;
+        for (auto& pin : node.component->GetPins()) {
+            uint32_t net = pin.isInput ? inputNets[input++] : outputNets[output++];
+            if (netWidths[net] > 1) {
+                pin.bus = busValues[net];
+            } else {
+                pin.value = netValues[net];
+            }
+        }
+    }
+}
+
+bool CircuitNetlist::IsCombinational() const {
+    if (hasLoops) return false;
+    return std::none_of(nodes.begin(), nodes.end(),
+                        [](const Node& node) { return node.op == NodeOp::SEQUENTIAL; });
+}
+
+void CircuitNetlist::ResetParallel(std::vector<LaneWord>& words) const {
+    LaneWord undefined = { 0, ~uint64_t(0) };
+    words.assign(netValues.size(), undefined);
+    for (const auto& constant : constantNets) {
+        words[constant.first].high = constant.second == LogicValue::HIGH ? ~uint64_t(0) : 0;
+        words[constant.first].undefined = 0;
+    }
+
+    // Sources other than switches hold their current pin values in every lane
+    for (const Node& node : nodes) {
+        if (node.op != NodeOp::SOURCE || node.component->GetType() == ComponentType::INPUT_PIN) continue;
+
+        uint32_t output = node.firstOutput;
+        for (const auto& pin : node.component->GetPins()) {
+            if (pin.isInput) continue;
+            LaneWord& word = words[outputNets[output++]];
+            word.high = pin.value == LogicValue::HIGH ? ~uint64_t(0) : 0;
+            word.undefined = pin.value == LogicValue::UNDEFINED ? ~uint64_t(0) : 0;
+        }
+    }
+}
+
+bool CircuitNetlist::IsNativeCodeReady() const {
+    return compiler && compiler->IsReady();
+}
+
+bool CircuitNetlist::WaitForNativeCode(wxString& error) {
+    if (!compiler) {
+        error = "The circuit cannot be compiled to native code";
+        return false;
+    }
+    if (compiler->Wait() != NetlistCompiler::State::READY) {
+        error = compiler->GetLastError();
+        return false;
+    }
+    return true;
+}
+
+void CircuitNetlist::EvaluateParallel(std::vector<LaneWord>& words) {
+    if (compiler && compiler->IsReady()) {
+        compiler->Evaluate(words);
+        return;
+    }
+    for (const GateBatch& batch : gateBatches) {
+        if (batch.kernel) {
+            batch.kernel(batchNets.data() + batch.first, batch.count, batch.arity, words.data());
+        } else {
+            EvaluateNodeParallel(nodes[batch.first], words);
+        }
+    }
+}
+
+void CircuitNetlist::EvaluateParallel(std::vector<LaneWord>& words, const std::vector<LaneForce>& forces) {
+    // Forces are grouped by node; remember where each forced node's group starts
+    nodeForces.resize(nodes.size(), 0);
+    for (size_t f = forces.size(); f-- > 0;) {
+        nodeForces[forces[f].node] = static_cast<uint32_t>(f + 1);
+    }
+
+    // Sources are not evaluated, so their forced outputs are set up front
+    laneChanges.clear();
+    for (const LaneForce& force : forces) {
+        const Node& node = nodes[force.node];
+        if (force.output && node.op == NodeOp::SOURCE) {
+            uint32_t net = outputNets[node.firstOutput + force.pin];
+            laneChanges.emplace_back(net, words[net]);
+            ForceLanes(words[net], force);
+            ScheduleFanout(net);
+        } else if (IsEvaluated(node.op)) {
+            Schedule(force.node);
+        }
+    }
+
+    // Without loops every node in the cones is evaluated once, after its inputs
+    scanLevel = 0;
+    while (pendingCount > 0) {
+        while (levelQueues[scanLevel].empty()) {
+            ++scanLevel;
+        }
+
+        levelScratch.swap(levelQueues[scanLevel]);
+        for (uint32_t n : levelScratch) {
+            queued[n] = 0;
+            --pendingCount;
+            EvaluateForcedNode(n, words, forces);
+        }
+        levelScratch.clear();
+    }
+
+    for (const LaneForce& force : forces) {
+        nodeForces[force.node] = 0;
+    }
+}
+
+void CircuitNetlist::EvaluateForcedNode(uint32_t n, std::vector<LaneWord>& words, const std::vector<LaneForce>& forces) {
+    const Node& node = nodes[n];
+
+    // Outputs are logged before they change so RestoreParallel can undo them
+    size_t logged = laneChanges.size();
+    for (uint32_t o = 0; o < node.outputCount; ++o) {
+        uint32_t net = outputNets[node.firstOutput + o];
+        laneChanges.emplace_back(net, words[net]);
+    }
+
+    // A forced input is only seen by this node, so its net is patched
+    // for the evaluation and restored before any other reader runs
+    size_t first = nodeForces[n] == 0 ? forces.size() : nodeForces[n] - 1;
+    size_t end = first;
+    forcedInputs.clear();
+    for (; end < forces.size() && forces[end].node == n; ++end) {
+        if (forces[end].output) continue;
+        uint32_t net = inputNets[node.firstInput + forces[end].pin];
+        forcedInputs.emplace_back(net, words[net]);
+        ForceLanes(words[net], forces[end]);
+    }
+
+    EvaluateNodeParallel(node, words);
+
+    for (size_t i = forcedInputs.size(); i-- > 0;) {
+        words[forcedInputs[i].first] = forcedInputs[i].second;
+    }
+    for (size_t f = first; f < end; ++f) {
+        if (forces[f].output) {
+            ForceLanes(words[outputNets[node.firstOutput + forces[f].pin]], forces[f]);
+        }
+    }
+
+    // Only outputs that differ from the previous pass carry the change on
+    for (size_t i = logged; i < laneChanges.size(); ++i) {
+        const LaneWord& before = laneChanges[i].second;
+        const LaneWord& after = words[laneChanges[i].first];
+        if (before.high != after.high || before.undefined != after.undefined) {
+            ScheduleFanout(laneChanges[i].first);
+        }
+    }
+}
+
+void CircuitNetlist::RestoreParallel(std::vector<LaneWord>& words) {
+    for (size_t i = laneChanges.size(); i-- > 0;) {
+        words[laneChanges[i].first] = laneChanges[i].second;
+    }
+    laneChanges.clear();
+}
+
+void CircuitNetlist::ForceLanes(LaneWord& word, const LaneForce& force) {
+    word.high = (word.high & ~force.lanes) | (force.high & force.lanes);
+    word.undefined &= ~force.lanes;
+}
+
+void CircuitNetlist::EvaluateNodeParallel(const Node& node, std::vector<LaneWord>& words) {
+    const uint32_t* in = inputNets.data() + node.firstInput;
+
+    // Same semantics as Evaluate, with one lane per bit. Gate outputs are
+    // never undefined, so only XOR and XNOR look at the undefined masks.
+    LaneWord result = { 0, 0 };
+    switch (node.op) {
+        case NodeOp::AND:
+        case NodeOp::NAND: {
+            uint64_t allHigh = ~uint64_t(0);
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                allHigh &= words[in[i]].high;
+            }
+            result.high = node.op == NodeOp::AND ? allHigh : ~allHigh;
+            break;
+        }
+        case NodeOp::OR:
+        case NodeOp::NOR: {
+            uint64_t anyHigh = 0;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                anyHigh |= words[in[i]].high;
+            }
+            result.high = node.op == NodeOp::OR ? anyHigh : ~anyHigh;
+            break;
+        }
+        case NodeOp::NOT:
+            result.high = node.inputCount > 0 ? ~words[in[0]].high : ~uint64_t(0);
+            break;
+        case NodeOp::XOR:
+        case NodeOp::XNOR: {
+            uint64_t anyUndefined = 0;
+            uint64_t parity = 0;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                anyUndefined |= words[in[i]].undefined;
+                parity ^= words[in[i]].high;
+            }
+            result.high = ~anyUndefined & (node.op == NodeOp::XOR ? parity : ~parity);
+            break;
+        }
+        case NodeOp::SUBCIRCUIT_MODEL:
+            EvaluateModelParallel(node, words);
+            return;
+        default:
+            EvaluateBlockParallel(node, words);
+            return;
+    }
+
+    for (uint32_t o = 0; o < node.outputCount; ++o) {
+        words[outputNets[node.firstOutput + o]] = result;
+    }
+}
+
+void CircuitNetlist::EvaluateBlockParallel(const Node& node, std::vector<LaneWord>& words) {
+    // Blocks have no word-level kernel, so run their code once per lane
+    auto& pins = node.component->GetPins();
+    std::vector<LaneWord> results(node.outputCount, LaneWord{ 0, 0 });
+
+    for (unsigned lane = 0; lane < 64; ++lane) {
+        const uint64_t bit = uint64_t(1) << lane;
+
+        uint32_t input = node.firstInput;
+        for (auto& pin : pins) {
+            if (!pin.isInput) continue;
+            const LaneWord& word = words[inputNets[input++]];
+            pin.value = (word.undefined & bit) ? LogicValue::UNDEFINED
+                      : (word.high & bit) ? LogicValue::HIGH : LogicValue::LOW;
+        }
+
+        switch (node.op) {
+            case NodeOp::ARITHMETIC:
+                static_cast<ArithmeticComponent*>(node.component)->ComputeOutputs();
+                break;
+            case NodeOp::DECODER_3TO8:
+                static_cast<Decoder3to8*>(node.component)->ComputeOutputs();
+                break;
+            case NodeOp::BCD_TO_7SEGMENT:
+                static_cast<BCDTo7SegmentDecoder*>(node.component)->ComputeOutputs();
+                break;
+            case NodeOp::PRIORITY_ENCODER_8TO3:
+                static_cast<PriorityEncoder8to3*>(node.component)->ComputeOutputs();
+                break;
+            default:
+                break;
+        }
+
+        uint32_t output = 0;
+        for (const auto& pin : pins) {
+            if (pin.isInput) continue;
+            if (pin.value == LogicValue::HIGH) results[output].high |= bit;
+            if (pin.value == LogicValue::UNDEFINED) results[output].undefined |= bit;
+            ++output;
+        }
+    }
+
+    for (uint32_t o = 0; o < node.outputCount; ++o) {
+        words[outputNets[node.firstOutput + o]] = results[o];
+    }
+}
+
+void CircuitNetlist::EvaluateModelParallel(const Node& node, std::vector<LaneWord>& words) {
+    // Lanes are looked up one at a time, mostly from the model's table
+    SubcircuitModel& model = *models[node.model];
+    const uint32_t* in = inputNets.data() + node.firstInput;
+    std::vector<LaneWord> results(node.outputCount, LaneWord{ 0, 0 });
+
+    for (unsigned lane = 0; lane < 64; ++lane) {
+        uint64_t high = 0;
+        uint64_t undefined = 0;
+        for (uint32_t i = 0; i < node.inputCount; ++i) {
+            high |= ((words[in[i]].high >> lane) & 1) << i;
+            undefined |= ((words[in[i]].undefined >> lane) & 1) << i;
+        }
+
+        uint64_t outputs = model.Evaluate(high & ~undefined, undefined);
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            results[o].high |= ((outputs >> o) & 1) << lane;
+            results[o].undefined |= ((outputs >> (o + 32)) & 1) << lane;
+        }
+    }
+
+    for (uint32_t o = 0; o < node.outputCount; ++o) {
+        words[outputNets[node.firstOutput + o]] = results[o];
+    }
+}
@@ -1,28 +1,190 @@
 #include "../../include/core/command_system.h"
 #include "../../include/ui/circuit_canvas.h"
+#include "../../include/components/wire.h"
+#include "../../include/core/memory_image.h"
+#include "../../include/core/circuit_document.h"
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+const size_t CommandManager::DEFAULT_MEMORY_BUDGET;
+
+namespace {
+
+std::vector<ComponentId> GetIds(const std::vector<CircuitComponent*>& components) {
+    std::vector<ComponentId> ids;
+    ids.reserve(components.size());
+    for (const CircuitComponent* component : components) {
+        ids.push_back(component->GetId());
+    }
+    return ids;
+}
+
+} // namespace
+
+// ComponentRecords implementation
+void ComponentRecords::Take(CircuitCanvas* canvas, const std::vector<ComponentId>& ids) {
+    records.clear();
+    if (!canvas) return;
+
+    // Every pin on the canvas by owner ID and number, for the wire ends
+    const auto& all = canvas->GetComponents();
+    std::unordered_map<const Pin*, PinLocation> pinLocations;
+    for (const auto& component : all) {
+        if (component->GetType() == ComponentType::WIRE) continue;
+        const auto& pins = component->GetPins();
+        for (size_t p = 0; p < pins.size(); ++p) {
+            pinLocations[&pins[p]] = PinLocation{ static_cast<long>(component->GetId()), static_cast<long>(p) };
+        }
+    }
+    auto locate = [&pinLocations](const Pin* pin) {
+        auto found = pinLocations.find(pin);
+        return found != pinLocations.end() ? found->second : PinLocation{ -1, -1 };
+    };
+
+    // One scan finds every index, however many components are taken
+    std::unordered_set<ComponentId> targets(ids.begin(), ids.end());
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < all.size(); ++i) {
+        const CircuitComponent* component = all[i].get();
+        bool taken = targets.count(component->GetId()) != 0;
+        if (!taken && component->GetType() == ComponentType::WIRE) {
+            // A wire cannot outlive the pins it is drawn between
+            const Wire* wire = static_cast<const Wire*>(component);
+            taken = targets.count(static_cast<ComponentId>(locate(wire->GetStartPin()).component)) != 0 ||
+                    targets.count(static_cast<ComponentId>(locate(wire->GetEndPin()).component)) != 0;
+        }
+        if (!taken) continue;
+
+        Record record{ i, component->GetType() == ComponentType::WIRE, wxString(), nullptr };
+        if (record.isWire) {
+            const Wire* wire = static_cast<const Wire*>(component);
+            record.line = CircuitDocument::SerializeWire(*wire, locate(wire->GetStartPin()), locate(wire->GetEndPin()));
+        } else {
+            record.line = CircuitDocument::SerializeComponent(*component);
+            if (const MemoryImage* memory = component->GetMemory()) {
+                record.memory = std::make_shared<MemoryImage>(*memory);
+            }
+        }
+        indices.push_back(i);
+        records.push_back(std::move(record));
+    }
+
+    // Pins left on the canvas stay connected only if another wire still ends there
+    std::vector<std::unique_ptr<CircuitComponent>> taken = canvas->ExtractComponents(indices);
+    std::unordered_set<Pin*> released;
+    for (const auto& component : taken) {
+        if (component->GetType() != ComponentType::WIRE) continue;
+        const Wire* wire = static_cast<const Wire*>(component.get());
+        for (Pin* pin : { wire->GetStartPin(), wire->GetEndPin() }) {
+            if (pin && !targets.count(static_cast<ComponentId>(locate(pin).component))) {
+                released.insert(pin);
+            }
+        }
+    }
+    for (Pin* pin : released) {
+        pin->isConnected = false;
+    }
+    for (const auto& component : canvas->GetComponents()) {
+        if (released.empty()) break;
+        if (component->GetType() != ComponentType::WIRE) continue;
+        const Wire* wire = static_cast<const Wire*>(component.get());
+        for (Pin* pin : { wire->GetStartPin(), wire->GetEndPin() }) {
+            if (pin && released.count(pin)) {
+                pin->isConnected = true;
+            }
+        }
+    }
+}
+
+void ComponentRecords::Restore(CircuitCanvas* canvas) {
+    if (!canvas || records.empty()) return;
+
+    // Components first, so the wires find their pins among them or on the canvas
+    ComponentPool::Scope scope(canvas->GetComponentPool());
+    std::vector<std::unique_ptr<CircuitComponent>> restored(records.size());
+    std::unordered_map<ComponentId, CircuitComponent*> restoredById;
+    for (size_t r = 0; r < records.size(); ++r) {
+        if (records[r].isWire) continue;
+
+        wxString error;
+        restored[r] = CircuitDocument::DeserializeComponent(records[r].line, error, !records[r].memory);
+        if (!restored[r]) continue;
+        if (records[r].memory) {
+            *restored[r]->GetMemory() = *records[r].memory;
+        }
+        restoredById[restored[r]->GetId()] = restored[r].get();
+    }
+
+    auto findPin = [&](const PinLocation& location, wxPoint& position) -> Pin* {
+        ComponentId id = static_cast<ComponentId>(location.component);
+        auto found = restoredById.find(id);
+        CircuitComponent* owner = found != restoredById.end() ? found->second : canvas->FindComponent(id);
+        if (!owner || location.pin < 0 || location.pin >= static_cast<long>(owner->GetPins().size())) return nullptr;
+        Pin* pin = &owner->GetPins()[location.pin];
+        position = owner->GetPinPosition(*pin);
+        return pin;
+    };
+    for (size_t r = 0; r < records.size(); ++r) {
+        if (!records[r].isWire) continue;
+
+        PinLocation from, to;
+        wxPoint startPos, endPos;
+        if (!CircuitDocument::ReadWireEnds(records[r].line, from, to)) continue;
+        Pin* startPin = findPin(from, startPos);
+        Pin* endPin = findPin(to, endPos);
+        if (startPin && endPin) {
+            restored[r] = CircuitDocument::DeserializeWire(records[r].line, startPin, startPos, endPin, endPos);
+        }
+    }
+
+    std::vector<size_t> indices;
+    std::vector<std::unique_ptr<CircuitComponent>> inserted;
+    for (size_t r = 0; r < records.size(); ++r) {
+        if (!restored[r]) continue;
+        indices.push_back(records[r].index);
+        inserted.push_back(std::move(restored[r]));
+    }
+    canvas->InsertComponentsAt(indices, std::move(inserted));
+    records.clear();
+}
+
+size_t ComponentRecords::GetMemoryUsage() const {
+    size_t bytes = records.capacity() * sizeof(Record);
+    for (const Record& record : records) {
+        bytes += (record.line.length() + 1) * sizeof(wxChar);
+        if (record.memory && !record.memory->IsMapped()) {
+            // Mapped images share the file mapping with the canvas
+            bytes += sizeof(MemoryImage) + record.memory->GetWordCount() * ((record.memory->GetDataWidth() + 7) / 8);
+        }
+    }
+    return bytes;
+}
 
 // AddComponentCommand implementation
 AddComponentCommand::AddComponentCommand(CircuitCanvas* canvas, std::unique_ptr<CircuitComponent> comp)
-    : canvas(canvas), component(std::move(comp)), executed(false) {}
+    : canvas(canvas), component(std::move(comp)), componentId(NO_COMPONENT_ID), executed(false) {}
 
 void AddComponentCommand::Execute() {
-    if (!executed && canvas && component) {
+    if (executed || !canvas) return;
+
+    if (component) {
+        // The canvas gives a new component its ID, a re-added one keeps it
+        CircuitComponent* added = component.get();
         canvas->AddComponentDirectly(std::move(component));
-        executed = true;
+        componentId = added->GetId();
+    } else {
+        undone.Restore(canvas);
     }
+    executed = true;
 }
 
 void AddComponentCommand::Undo() {
     if (executed && canvas) {
-        // Find the component that was added and extract it back
-        const auto& components = canvas->GetComponents();
-        if (!components.empty()) {
-            // Get the last added component (assuming it's the one we added)
-            component = canvas->ExtractComponent(components.back().get());
-            executed = false;
-        }
+        // Take the component that was added, whatever came after it
+        undone.Take(canvas, std::vector<ComponentId>(1, componentId));
+        executed = false;
     }
 }
 
@@ -30,27 +192,25 @@ wxString AddComponentCommand::GetDescription() const {
     return "Add Component";
 }
 
+size_t AddComponentCommand::GetMemoryUsage() const {
+    // The component itself goes to the canvas before the command is stacked
+    return sizeof(*this) + undone.GetMemoryUsage();
+}
+
 // RemoveComponentCommand implementation
 RemoveComponentCommand::RemoveComponentCommand(CircuitCanvas* canvas, CircuitComponent* comp)
-    : canvas(canvas), executed(false), originalIndex(0) {
-
-    if (canvas && comp) {
-        // Store the index first, then extract the component
-        originalIndex = canvas->GetComponentIndex(comp);
-        component = canvas->ExtractComponent(comp);
-    }
-}
+    : canvas(canvas), componentId(comp ? comp->GetId() : NO_COMPONENT_ID), executed(false) {}
 
 void RemoveComponentCommand::Execute() {
-    if (!executed && canvas && component) {
-        // Component is already extracted during construction, just mark as executed
-        executed = true;
-    }
+    if (executed || !canvas || !canvas->FindComponent(componentId)) return;
+
+    removed.Take(canvas, std::vector<ComponentId>(1, componentId));
+    executed = true;
 }
 
 void RemoveComponentCommand::Undo() {
-    if (executed && canvas && component) {
-        canvas->InsertComponentAt(originalIndex, std::move(component));
+    if (executed && canvas) {
+        removed.Restore(canvas);
         executed = false;
     }
 }
@@ -59,19 +219,24 @@ wxString RemoveComponentCommand::GetDescription() const {
     return "Remove Component";
 }
 
+size_t RemoveComponentCommand::GetMemoryUsage() const {
+    return sizeof(*this) + removed.GetMemoryUsage();
+}
+
 // MoveComponentCommand implementation
-MoveComponentCommand::MoveComponentCommand(CircuitComponent* comp, const wxPoint& oldPos, const wxPoint& newPos)
-    : component(comp), oldPosition(oldPos), newPosition(newPos) {}
+MoveComponentCommand::MoveComponentCommand(CircuitCanvas* canvas, CircuitComponent* comp,
+                                           const wxPoint& oldPos, const wxPoint& newPos)
+    : canvas(canvas), componentId(comp ? comp->GetId() : NO_COMPONENT_ID), oldPosition(oldPos), newPosition(newPos) {}
 
 void MoveComponentCommand::Execute() {
-    if (component) {
+    if (CircuitComponent* component = canvas ? canvas->FindComponent(componentId) : nullptr) {
         wxPoint offset = newPosition - component->GetPosition();
         component->Move(offset);
     }
 }
 
 void MoveComponentCommand::Undo() {
-    if (component) {
+    if (CircuitComponent* component = canvas ? canvas->FindComponent(componentId) : nullptr) {
         wxPoint offset = oldPosition - component->GetPosition();
         component->Move(offset);
     }
@@ -79,12 +244,12 @@ void MoveComponentCommand::Undo() {
 
 bool MoveComponentCommand::CanMerge(const Command* other) const {
     const MoveComponentCommand* moveCmd = dynamic_cast<const MoveComponentCommand*>(other);
-    return moveCmd && moveCmd->component == component;
+    return moveCmd && moveCmd->componentId == componentId;
 }
 
 void MoveComponentCommand::MergeWith(Command* other) {
     MoveComponentCommand* moveCmd = dynamic_cast<MoveComponentCommand*>(other);
-    if (moveCmd && moveCmd->component == component) {
+    if (moveCmd && moveCmd->componentId == componentId) {
         newPosition = moveCmd->newPosition;
     }
 }
@@ -93,21 +258,124 @@ wxString MoveComponentCommand::GetDescription() const {
     return "Move Component";
 }
 
+size_t MoveComponentCommand::GetMemoryUsage() const {
+    return sizeof(*this);
+}
+
+// MoveComponentsCommand implementation
+MoveComponentsCommand::MoveComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps,
+                                             const wxPoint& offset)
+    : canvas(canvas), componentIds(GetIds(comps)), offset(offset), executed(true) {}
+
+void MoveComponentsCommand::Execute() {
+    if (!executed && canvas) {
+        for (ComponentId id : componentIds) {
+            if (CircuitComponent* component = canvas->FindComponent(id)) {
+                component->Move(offset);
+            }
+        }
+        executed = true;
+    }
+}
+
+void MoveComponentsCommand::Undo() {
+    if (executed && canvas) {
+        for (ComponentId id : componentIds) {
+            if (CircuitComponent* component = canvas->FindComponent(id)) {
+                component->Move(-offset);
+            }
+        }
+        executed = false;
+    }
+}
+
+wxString MoveComponentsCommand::GetDescription() const {
+    return componentIds.size() == 1 ? wxString("Move Component")
+                                    : wxString::Format("Move %zu Components", componentIds.size());
+}
+
+size_t MoveComponentsCommand::GetMemoryUsage() const {
+    return sizeof(*this) + componentIds.capacity() * sizeof(ComponentId);
+}
+
+// RotateComponentsCommand implementation
+RotateComponentsCommand::RotateComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps,
+                                                 double degrees)
+    : canvas(canvas), componentIds(GetIds(comps)), degrees(degrees) {}
+
+void RotateComponentsCommand::Execute() {
+    if (!canvas) return;
+    for (ComponentId id : componentIds) {
+        if (CircuitComponent* component = canvas->FindComponent(id)) {
+            component->Rotate(degrees);
+        }
+    }
+}
+
+void RotateComponentsCommand::Undo() {
+    if (!canvas) return;
+    for (ComponentId id : componentIds) {
+        if (CircuitComponent* component = canvas->FindComponent(id)) {
+            component->Rotate(-degrees);
+        }
+    }
+}
+
+wxString RotateComponentsCommand::GetDescription() const {
+    return componentIds.size() == 1 ? wxString("Rotate Component")
+                                    : wxString::Format("Rotate %zu Components", componentIds.size());
+}
+
+size_t RotateComponentsCommand::GetMemoryUsage() const {
+    return sizeof(*this) + componentIds.capacity() * sizeof(ComponentId);
+}
+
+// RemoveComponentsCommand implementation
+RemoveComponentsCommand::RemoveComponentsCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps)
+    : canvas(canvas), componentIds(GetIds(comps)), executed(false) {}
+
+void RemoveComponentsCommand::Execute() {
+    if (executed || !canvas) return;
+
+    removed.Take(canvas, componentIds);
+    executed = true;
+}
+
+void RemoveComponentsCommand::Undo() {
+    if (executed && canvas) {
+        removed.Restore(canvas);
+        executed = false;
+    }
+}
+
+wxString RemoveComponentsCommand::GetDescription() const {
+    return componentIds.size() == 1 ? wxString("Remove Component")
+                                    : wxString::Format("Remove %zu Components", componentIds.size());
+}
+
+size_t RemoveComponentsCommand::GetMemoryUsage() const {
+    return sizeof(*this) + componentIds.capacity() * sizeof(ComponentId) + removed.GetMemoryUsage();
+}
+
 // SelectionCommand implementation
-SelectionCommand::SelectionCommand(const std::vector<CircuitComponent*>& comps,
+SelectionCommand::SelectionCommand(CircuitCanvas* canvas, const std::vector<CircuitComponent*>& comps,
                                  const std::vector<bool>& oldSel,
                                  const std::vector<bool>& newSel)
-    : components(comps), oldStates(oldSel), newStates(newSel) {}
+    : canvas(canvas), componentIds(GetIds(comps)), oldStates(oldSel), newStates(newSel) {}
 
 void SelectionCommand::Execute() {
-    for (size_t i = 0; i < components.size() && i < newStates.size(); ++i) {
-        components[i]->Select(newStates[i]);
+    for (size_t i = 0; canvas && i < componentIds.size() && i < newStates.size(); ++i) {
+        if (CircuitComponent* component = canvas->FindComponent(componentIds[i])) {
+            component->Select(newStates[i]);
+        }
     }
 }
 
 void SelectionCommand::Undo() {
-    for (size_t i = 0; i < components.size() && i < oldStates.size(); ++i) {
-        components[i]->Select(oldStates[i]);
+    for (size_t i = 0; canvas && i < componentIds.size() && i < oldStates.size(); ++i) {
+        if (CircuitComponent* component = canvas->FindComponent(componentIds[i])) {
+            component->Select(oldStates[i]);
+        }
     }
 }
 
@@ -115,6 +383,11 @@ wxString SelectionCommand::GetDescription() const {
     return "Change Selection";
 }
 
+size_t SelectionCommand::GetMemoryUsage() const {
+    return sizeof(*this) + componentIds.capacity() * sizeof(ComponentId) +
+           (oldStates.capacity() + newStates.capacity()) / 8;
+}
+
 // CompositeCommand implementation
 CompositeCommand::CompositeCommand(const wxString& desc) : description(desc) {}
 
@@ -139,9 +412,17 @@ wxString CompositeCommand::GetDescription() const {
     return description;
 }
 
+size_t CompositeCommand::GetMemoryUsage() const {
+    size_t bytes = sizeof(*this) + commands.capacity() * sizeof(std::unique_ptr<Command>);
+    for (const auto& command : commands) {
+        bytes += command->GetMemoryUsage();
+    }
+    return bytes;
+}
+
 // CommandManager implementation
-CommandManager::CommandManager(size_t maxLevels)
-    : maxUndoLevels(maxLevels), isExecuting(false) {}
+CommandManager::CommandManager(size_t budget)
+    : memoryBudget(budget), memoryUsage(0), isExecuting(false) {}
 
 void CommandManager::ExecuteCommand(std::unique_ptr<Command> command) {
     if (!command || isExecuting) return;
@@ -156,8 +437,12 @@ void CommandManager::ExecuteCommand(std::unique_ptr<Command> command) {
     }
 
     // Try to merge with the last command if possible
-    if (!undoStack.empty() && undoStack.back()->CanMerge(command.get())) {
-        undoStack.back()->MergeWith(command.get());
+    if (!undoStack.empty() && undoStack.back().command->CanMerge(command.get())) {
+        HistoryEntry& last = undoStack.back();
+        last.command->MergeWith(command.get());
+        memoryUsage -= last.memoryUsage;
+        last.memoryUsage = last.command->GetMemoryUsage();
+        memoryUsage += last.memoryUsage;
         isExecuting = false;
         return;
     }
@@ -166,13 +451,13 @@ void CommandManager::ExecuteCommand(std::unique_ptr<Command> command) {
     command->Execute();
 
     // Add to undo stack
-    undoStack.push_back(std::move(command));
+    Push(undoStack, std::move(command));
 
     // Clear redo stack
-    redoStack.clear();
+    ClearRedo();
 
-    // Limit undo stack size
-    LimitUndoStack();
+    // Keep the history within its budget
+    LimitMemory();
 
     isExecuting = false;
 }
@@ -190,11 +475,11 @@ void CommandManager::Undo() {
 
     isExecuting = true;
 
-    auto command = std::move(undoStack.back());
-    undoStack.pop_back();
-
+    // Footprints change with the direction, an undone removal gives its components back
+    auto command = Pop(undoStack);
     command->Undo();
-    redoStack.push_back(std::move(command));
+    Push(redoStack, std::move(command));
+    LimitMemory();
 
     isExecuting = false;
 }
@@ -204,11 +489,10 @@ void CommandManager::Redo() {
 
     isExecuting = true;
 
-    auto command = std::move(redoStack.back());
-    redoStack.pop_back();
-
+    auto command = Pop(redoStack);
     command->Execute();
-    undoStack.push_back(std::move(command));
+    Push(undoStack, std::move(command));
+    LimitMemory();
 
     isExecuting = false;
 }
@@ -216,17 +500,23 @@ void CommandManager::Redo() {
 void CommandManager::Clear() {
     undoStack.clear();
     redoStack.clear();
+    memoryUsage = 0;
     currentTransaction.reset();
 }
 
+void CommandManager::SetMemoryBudget(size_t budget) {
+    memoryBudget = budget;
+    LimitMemory();
+}
+
 wxString CommandManager::GetUndoDescription() const {
     if (undoStack.empty()) return "";
-    return "Undo " + undoStack.back()->GetDescription();
+    return "Undo " + undoStack.back().command->GetDescription();
 }
 
 wxString CommandManager::GetRedoDescription() const {
     if (redoStack.empty()) return "";
-    return "Redo " + redoStack.back()->GetDescription();
+    return "Redo " + redoStack.back().command->GetDescription();
 }
 
 void CommandManager::BeginTransaction(const wxString& description) {
@@ -250,9 +540,32 @@ void CommandManager::AbortTransaction() {
     currentTransaction.reset();
 }
 
-void CommandManager::LimitUndoStack() {
-    while (undoStack.size() > maxUndoLevels) {
-        undoStack.erase(undoStack.begin());
+void CommandManager::Push(std::deque<HistoryEntry>& stack, std::unique_ptr<Command> command) {
+    size_t bytes = command->GetMemoryUsage();
+    memoryUsage += bytes;
+    stack.push_back(HistoryEntry{ std::move(command), bytes });
+}
+
+std::unique_ptr<Command> CommandManager::Pop(std::deque<HistoryEntry>& stack) {
+    HistoryEntry& entry = stack.back();
+    memoryUsage -= entry.memoryUsage;
+    std::unique_ptr<Command> command = std::move(entry.command);
+    stack.pop_back();
+    return command;
+}
+
+void CommandManager::ClearRedo() {
+    for (const HistoryEntry& entry : redoStack) {
+        memoryUsage -= entry.memoryUsage;
+    }
+    redoStack.clear();
+}
+
+void CommandManager::LimitMemory() {
+    // The oldest edits go first; the latest one stays undoable however large it is
+    while (memoryUsage > memoryBudget && undoStack.size() > 1) {
+        memoryUsage -= undoStack.front().memoryUsage;
+        undoStack.pop_front();
     }
 }
 
@@ -0,0 +1,193 @@
+#include "../../include/core/component_pool.h"
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+const size_t ComponentPool::GRANULE;
+const size_t ComponentPool::MAX_POOLED;
+const size_t ComponentPool::SLAB_SIZE;
+const size_t ComponentPool::CLASS_COUNT;
+const size_t ComponentPool::HEADER_SIZE;
+
+namespace {
+
+// Spin lock over the pool's flag; it is only ever held for a few instructions
+class PoolLock {
+    std::atomic_flag& flag;
+
+public:
+    explicit PoolLock(std::atomic_flag& f) : flag(f) {
+        while (flag.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~PoolLock() { flag.clear(std::memory_order_release); }
+};
+
+// Slabs are aligned to their size, so masking a block's address finds its slab
+void* AllocateSlab(size_t size) {
+#ifdef _WIN32
+    void* slab = _aligned_malloc(size, size);
+#else
+    void* slab = nullptr;
+    if (posix_memalign(&slab, size, size) != 0) slab = nullptr;
+#endif
+    if (!slab) throw std::bad_alloc();
+    return slab;
+}
+
+void FreeSlab(void* slab) {
+#ifdef _WIN32
+    _aligned_free(slab);
+#else
+    std::free(slab);
+#endif
+}
+
+thread_local ComponentPool* currentPool = nullptr;
+
+} // namespace
+
+ComponentPool::Scope::Scope(ComponentPool* pool) : previous(currentPool) {
+    currentPool = pool;
+}
+
+ComponentPool::Scope::~Scope() {
+    currentPool = previous;
+}
+
+ComponentPool::ComponentPool() : pinCarver{ nullptr, nullptr }, slabs(nullptr), slabCount(0), blockCount(0), closed(false) {
+    lock.clear();
+    for (SizeClass& sizeClass : classes) {
+        sizeClass = SizeClass{ nullptr, nullptr, Carver{ nullptr, nullptr } };
+    }
+}
+
+ComponentPool::~ComponentPool() {
+    ReleaseSlabs();
+}
+
+ComponentPool::Owner ComponentPool::Create() {
+    return Owner(new ComponentPool());
+}
+
+ComponentPool* ComponentPool::Default() {
+    // Never destroyed: static objects holding components may outlive any static pool
+    static ComponentPool* pool = new ComponentPool();
+    return pool;
+}
+
+ComponentPool* ComponentPool::Current() {
+    return currentPool ? currentPool : Default();
+}
+
+void* ComponentPool::Allocate(size_t bytes, Region region) {
+    if (bytes == 0) bytes = 1;
+    if (bytes > MAX_POOLED) return ::operator new(bytes);
+
+    size_t blockSize = (bytes + GRANULE - 1) / GRANULE * GRANULE;
+    return AllocateBlock(blockSize, region);
+}
+
+void ComponentPool::Free(void* block, size_t bytes) {
+    if (!block) return;
+    if (bytes == 0) bytes = 1;
+    if (bytes > MAX_POOLED) {
+        ::operator delete(block);
+        return;
+    }
+
+    SlabHeader* slab = reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(block) & ~uintptr_t(SLAB_SIZE - 1));
+    ComponentPool* pool = slab->pool;
+    size_t blockSize = (bytes + GRANULE - 1) / GRANULE * GRANULE;
+    if (pool->FreeBlockTo(block, blockSize, slab->region)) {
+        delete pool;
+    }
+}
+
+void* ComponentPool::AllocateBlock(size_t blockSize, Region region) {
+    SizeClass& sizeClass = classes[blockSize / GRANULE - 1];
+
+    PoolLock guard(lock);
+    ++blockCount;
+    FreeBlock*& freeList = region == Region::PINS ? sizeClass.pinFreeList : sizeClass.freeList;
+    if (FreeBlock* block = freeList) {
+        freeList = block->next;
+        return block;
+    }
+
+    // The slab tail too small for a block is simply left unused
+    Carver& carver = region == Region::PINS ? pinCarver : sizeClass.carver;
+    if (static_cast<size_t>(carver.end - carver.cursor) < blockSize) {
+        carver.cursor = AddSlab(region) + HEADER_SIZE;
+        carver.end = carver.cursor - HEADER_SIZE + SLAB_SIZE;
+    }
+    void* block = carver.cursor;
+    carver.cursor += blockSize;
+    return block;
+}
+
+bool ComponentPool::FreeBlockTo(void* block, size_t blockSize, Region region) {
+    SizeClass& sizeClass = classes[blockSize / GRANULE - 1];
+
+    PoolLock guard(lock);
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    FreeBlock*& freeList = region == Region::PINS ? sizeClass.pinFreeList : sizeClass.freeList;
+    freed->next = freeList;
+    freeList = freed;
+    return --blockCount == 0 && closed;
+}
+
+char* ComponentPool::AddSlab(Region region) {
+    SlabHeader* slab = static_cast<SlabHeader*>(AllocateSlab(SLAB_SIZE));
+    slab->pool = this;
+    slab->next = slabs;
+    slab->region = region;
+    slabs = slab;
+    ++slabCount;
+    return reinterpret_cast<char*>(slab);
+}
+
+void ComponentPool::ReleaseSlabs() {
+    // The free lists and carvers all point into the slabs
+    while (SlabHeader* slab = slabs) {
+        slabs = slab->next;
+        FreeSlab(slab);
+    }
+    slabCount = 0;
+    pinCarver = Carver{ nullptr, nullptr };
+    for (SizeClass& sizeClass : classes) {
+        sizeClass = SizeClass{ nullptr, nullptr, Carver{ nullptr, nullptr } };
+    }
+}
+
+void ComponentPool::ReleaseIfUnused() {
+    PoolLock guard(lock);
+    if (blockCount == 0) {
+        ReleaseSlabs();
+    }
+}
+
+void ComponentPool::Close() {
+    bool unused;
+    {
+        PoolLock guard(lock);
+        closed = true;
+        unused = blockCount == 0;
+    }
+    if (unused) {
+        delete this;
+    }
+}
+
+size_t ComponentPool::GetBlockCount() const {
+    PoolLock guard(lock);
+    return blockCount;
+}
+
+size_t ComponentPool::GetSlabCount() const {
+    PoolLock guard(lock);
+    return slabCount;
+}
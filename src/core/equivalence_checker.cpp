@@ -0,0 +1,507 @@
+#include "../../include/core/equivalence_checker.h"
+#include "../../include/core/sat_solver.h"
+#include "../../include/components/io_components.h"
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace {
+
+// Lane patterns of the six low row bits, as in the truth table
+const uint64_t LOW_BIT_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull,
+    0xCCCCCCCCCCCCCCCCull,
+    0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull,
+    0xFFFF0000FFFF0000ull,
+    0xFFFFFFFF00000000ull
+};
+
+const uint32_t NO_VARIABLE = 0xFFFFFFFF;
+
+const char* SIDE_NAMES[2] = { "first", "second" };
+
+// Labels of the switches or LEDs of a circuit, which must be unique and set
+bool CollectLabels(const CircuitNetlist& netlist, bool inputs, std::vector<wxString>& labels, wxString& error) {
+    const char* kind = inputs ? "input switch" : "output LED";
+    std::set<wxString> unique;
+    for (uint32_t n : inputs ? netlist.GetInputNodes() : netlist.GetOutputNodes()) {
+        const CircuitComponent* component = netlist.GetNode(n).component;
+        wxString label = inputs ? static_cast<const InputSwitch*>(component)->GetLabel()
+                                : static_cast<const OutputLED*>(component)->GetLabel();
+        if (label.IsEmpty()) {
+            error = wxString::Format("Every %s needs a label to be matched", kind);
+            return false;
+        }
+        if (!unique.insert(label).second) {
+            error = wxString::Format("More than one %s is labeled '%s'", kind, label);
+            return false;
+        }
+        labels.push_back(label);
+    }
+    return true;
+}
+
+LogicValue LaneValue(const CircuitNetlist::LaneWord& word, unsigned lane) {
+    if ((word.undefined >> lane) & 1) return LogicValue::UNDEFINED;
+    return ((word.high >> lane) & 1) ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+const char* LogicValueName(LogicValue value) {
+    switch (value) {
+        case LogicValue::LOW:  return "0";
+        case LogicValue::HIGH: return "1";
+        default:               return "X";
+    }
+}
+
+unsigned LowestLane(uint64_t lanes) {
+    unsigned lane = 0;
+    while (!((lanes >> lane) & 1)) ++lane;
+    return lane;
+}
+
+} // namespace
+
+const size_t EquivalenceChecker::EXHAUSTIVE_INPUTS;
+const size_t EquivalenceChecker::RANDOM_PASSES;
+const size_t EquivalenceChecker::MAX_TABLE_INPUTS;
+const size_t EquivalenceChecker::CONFLICT_LIMIT;
+
+EquivalenceChecker::EquivalenceChecker()
+    : verdict(Verdict::UNKNOWN), method(Method::EXHAUSTIVE), andCount(0) {
+}
+
+bool EquivalenceChecker::Check(CircuitNetlist& first, CircuitNetlist& second) {
+    verdict = Verdict::UNKNOWN;
+    method = Method::EXHAUSTIVE;
+    counterexample.clear();
+    mismatches.clear();
+    andCount = 0;
+    unknownReason.Clear();
+    lastError.Clear();
+
+    CircuitNetlist* netlists[2] = { &first, &second };
+    for (int side = 0; side < 2; ++side) {
+        if (!netlists[side]->IsCombinational()) {
+            lastError = wxString::Format("The %s circuit has flip-flops or feedback loops; "
+                                         "only combinational circuits can be compared", SIDE_NAMES[side]);
+            return false;
+        }
+        if (netlists[side]->HasBuses()) {
+            lastError = wxString::Format("The %s circuit contains buses; only single lines can be compared",
+                                         SIDE_NAMES[side]);
+            return false;
+        }
+    }
+    if (!MatchPorts(netlists)) {
+        return false;
+    }
+
+    netlists[0]->ResetParallel(words[0]);
+    netlists[1]->ResetParallel(words[1]);
+    const size_t inputCount = inputNames.size();
+    std::vector<uint64_t> patterns(inputCount);
+
+    // Few inputs: every combination, 64 per pass
+    if (inputCount <= EXHAUSTIVE_INPUTS) {
+        size_t blocks = inputCount <= 6 ? 1 : size_t(1) << (inputCount - 6);
+        for (size_t block = 0; block < blocks; ++block) {
+            for (size_t i = 0; i < inputCount; ++i) {
+                patterns[i] = i < 6 ? LOW_BIT_PATTERNS[i] : ((block >> (i - 6)) & 1) ? ~uint64_t(0) : 0;
+            }
+            uint64_t differing = SimulatePass(netlists, patterns);
+            if (differing != 0) {
+                verdict = Verdict::DIFFERENT;
+                RecordCounterexample(netlists, patterns, LowestLane(differing));
+                return true;
+            }
+        }
+        verdict = Verdict::EQUIVALENT;
+        return true;
+    }
+
+    // Random vectors catch most differences before any proof is attempted
+    method = Method::RANDOM;
+    std::mt19937_64 random(1);
+    for (size_t pass = 0; pass < RANDOM_PASSES; ++pass) {
+        for (uint64_t& pattern : patterns) {
+            pattern = random();
+        }
+        uint64_t differing = SimulatePass(netlists, patterns);
+        if (differing != 0) {
+            verdict = Verdict::DIFFERENT;
+            RecordCounterexample(netlists, patterns, LowestLane(differing));
+            return true;
+        }
+    }
+
+    // Build both circuits over shared inputs and prove each output pair
+    method = Method::SAT;
+    AndInverterGraph graph;
+    std::vector<uint32_t> inputLiterals;
+    for (size_t i = 0; i < inputCount; ++i) {
+        inputLiterals.push_back(graph.AddInput());
+    }
+
+    std::vector<Signal> outputs[2];
+    if (!BuildGraph(first, 0, graph, inputLiterals, outputs[0]) ||
+        !BuildGraph(second, 1, graph, inputLiterals, outputs[1])) {
+        verdict = Verdict::UNKNOWN;
+        return true;
+    }
+    andCount = graph.GetAndCount();
+
+    bool unresolved = false;
+    for (size_t o = 0; o < outputNames.size(); ++o) {
+        const Signal& a = outputs[0][o];
+        const Signal& b = outputs[1][o];
+        if (a.undefined && b.undefined) continue;
+
+        uint32_t miter = a.undefined != b.undefined ? AndInverterGraph::TRUE_LITERAL
+                                                    : graph.Xor(a.literal, b.literal);
+        if (miter == AndInverterGraph::FALSE_LITERAL) continue;     // Merged by structural hashing
+
+        // Cone of the miter, in node order so fanins come first
+        std::vector<uint32_t> cone;
+        std::vector<uint8_t> visited(graph.GetNodeCount(), 0);
+        std::vector<uint32_t> stack(1, AndInverterGraph::NodeOf(miter));
+        while (!stack.empty()) {
+            uint32_t node = stack.back();
+            stack.pop_back();
+            if (visited[node]) continue;
+            visited[node] = 1;
+            cone.push_back(node);
+            if (graph.IsAnd(node)) {
+                stack.push_back(AndInverterGraph::NodeOf(graph.GetNode(node).fanin0));
+                stack.push_back(AndInverterGraph::NodeOf(graph.GetNode(node).fanin1));
+            }
+        }
+        std::sort(cone.begin(), cone.end());
+
+        // Tseitin encoding of the cone with the miter asserted
+        SatSolver solver;
+        std::vector<uint32_t> variables(graph.GetNodeCount(), NO_VARIABLE);
+        auto literalOf = [&](uint32_t literal) {
+            return SatSolver::MakeLiteral(variables[AndInverterGraph::NodeOf(literal)],
+                                          AndInverterGraph::IsComplemented(literal));
+        };
+        for (uint32_t node : cone) {
+            uint32_t variable = solver.NewVariable();
+            variables[node] = variable;
+            if (node == 0) {
+                solver.AddClause({ SatSolver::MakeLiteral(variable, true) });
+            } else if (graph.IsAnd(node)) {
+                uint32_t output = SatSolver::MakeLiteral(variable, false);
+                uint32_t fanin0 = literalOf(graph.GetNode(node).fanin0);
+                uint32_t fanin1 = literalOf(graph.GetNode(node).fanin1);
+                solver.AddClause({ SatSolver::Negate(output), fanin0 });
+                solver.AddClause({ SatSolver::Negate(output), fanin1 });
+                solver.AddClause({ output, SatSolver::Negate(fanin0), SatSolver::Negate(fanin1) });
+            }
+        }
+        solver.AddClause({ literalOf(miter) });
+
+        SatSolver::Result result = solver.Solve(CONFLICT_LIMIT);
+        if (result == SatSolver::Result::UNKNOWN) {
+            unresolved = true;
+            unknownReason = wxString::Format("the SAT solver gave up on output '%s'", outputNames[o]);
+            continue;
+        }
+        if (result == SatSolver::Result::UNSATISFIABLE) continue;
+
+        // Replay the solver's assignment in simulation for the report
+        for (size_t i = 0; i < inputCount; ++i) {
+            uint32_t variable = variables[AndInverterGraph::NodeOf(inputLiterals[i])];
+            patterns[i] = variable != NO_VARIABLE && solver.GetValue(variable) ? ~uint64_t(0) : 0;
+        }
+        if (SimulatePass(netlists, patterns) == 0) {
+            unresolved = true;
+            unknownReason = wxString::Format("the difference found on output '%s' did not show in simulation",
+                                             outputNames[o]);
+            continue;
+        }
+        verdict = Verdict::DIFFERENT;
+        RecordCounterexample(netlists, patterns, 0);
+        return true;
+    }
+
+    verdict = unresolved ? Verdict::UNKNOWN : Verdict::EQUIVALENT;
+    return true;
+}
+
+bool EquivalenceChecker::MatchPorts(CircuitNetlist* netlists[2]) {
+    inputNames.clear();
+    outputNames.clear();
+
+    std::vector<wxString> inputLabels[2];
+    std::vector<wxString> outputLabels[2];
+    for (int side = 0; side < 2; ++side) {
+        wxString error;
+        if (!CollectLabels(*netlists[side], true, inputLabels[side], error) ||
+            !CollectLabels(*netlists[side], false, outputLabels[side], error)) {
+            lastError = wxString::Format("In the %s circuit: %s", SIDE_NAMES[side], error);
+            return false;
+        }
+    }
+
+    // Every label must be found on the other side too
+    for (int side = 0; side < 2; ++side) {
+        for (const wxString& label : inputLabels[side]) {
+            if (netlists[1 - side]->FindInput(label) < 0) {
+                lastError = wxString::Format("Input switch '%s' is only in the %s circuit", label, SIDE_NAMES[side]);
+                return false;
+            }
+        }
+        for (const wxString& label : outputLabels[side]) {
+            if (netlists[1 - side]->FindOutput(label) < 0) {
+                lastError = wxString::Format("Output LED '%s' is only in the %s circuit", label, SIDE_NAMES[side]);
+                return false;
+            }
+        }
+    }
+    if (outputLabels[0].empty()) {
+        lastError = "The circuits have no output LEDs to compare";
+        return false;
+    }
+
+    inputNames = inputLabels[0];
+    outputNames = outputLabels[0];
+    for (int side = 0; side < 2; ++side) {
+        inputNets[side].clear();
+        outputNets[side].clear();
+        for (const wxString& label : inputNames) {
+            inputNets[side].push_back(netlists[side]->GetOutputNet(netlists[side]->FindInput(label), 0));
+        }
+        for (const wxString& label : outputNames) {
+            outputNets[side].push_back(netlists[side]->GetInputNet(netlists[side]->FindOutput(label), 0));
+        }
+    }
+    return true;
+}
+
+uint64_t EquivalenceChecker::SimulatePass(CircuitNetlist* netlists[2], const std::vector<uint64_t>& patterns) {
+    for (int side = 0; side < 2; ++side) {
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            CircuitNetlist::LaneWord& word = words[side][inputNets[side][i]];
+            word.high = patterns[i];
+            word.undefined = 0;
+        }
+        netlists[side]->EvaluateParallel(words[side]);
+    }
+
+    // Lanes where some output differs; two undefined values count as equal
+    uint64_t differing = 0;
+    for (size_t o = 0; o < outputNames.size(); ++o) {
+        const CircuitNetlist::LaneWord& a = words[0][outputNets[0][o]];
+        const CircuitNetlist::LaneWord& b = words[1][outputNets[1][o]];
+        differing |= (a.undefined ^ b.undefined) | (~a.undefined & ~b.undefined & (a.high ^ b.high));
+    }
+    return differing;
+}
+
+void EquivalenceChecker::RecordCounterexample(CircuitNetlist* netlists[2], const std::vector<uint64_t>& patterns,
+                                              unsigned lane) {
+    // The words still hold the pass that found the difference
+    counterexample.clear();
+    for (uint64_t pattern : patterns) {
+        counterexample.push_back((pattern >> lane) & 1);
+    }
+
+    mismatches.clear();
+    for (size_t o = 0; o < outputNames.size(); ++o) {
+        LogicValue a = LaneValue(words[0][outputNets[0][o]], lane);
+        LogicValue b = LaneValue(words[1][outputNets[1][o]], lane);
+        if (a != b) {
+            mismatches.push_back(Mismatch{ outputNames[o], a, b });
+        }
+    }
+}
+
+bool EquivalenceChecker::BuildGraph(CircuitNetlist& netlist, int side, AndInverterGraph& graph,
+                                    const std::vector<uint32_t>& inputLiterals, std::vector<Signal>& outputs) {
+    const uint32_t FALSE_LITERAL = AndInverterGraph::FALSE_LITERAL;
+    const uint32_t TRUE_LITERAL = AndInverterGraph::TRUE_LITERAL;
+    std::vector<Signal> signals(netlist.GetNetCount(), Signal{ FALSE_LITERAL, true });
+
+    // Switches are the shared inputs, other sources hold their current values
+    for (size_t i = 0; i < inputLiterals.size(); ++i) {
+        signals[inputNets[side][i]] = Signal{ inputLiterals[i], false };
+    }
+    for (uint32_t n = 0; n < netlist.GetNodeCount(); ++n) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+        if (node.op != CircuitNetlist::NodeOp::SOURCE || node.component->GetType() == ComponentType::INPUT_PIN) continue;
+
+        uint32_t output = 0;
+        for (const auto& pin : node.component->GetPins()) {
+            if (pin.isInput) continue;
+            Signal& signal = signals[netlist.GetOutputNet(n, output++)];
+            signal.undefined = pin.value == LogicValue::UNDEFINED;
+            signal.literal = pin.value == LogicValue::HIGH ? TRUE_LITERAL : FALSE_LITERAL;
+        }
+    }
+
+    // Same semantics as the simulator: gates read undefined inputs as low,
+    // except XOR and XNOR which give low for any undefined input
+    for (uint32_t n : netlist.GetLevelOrder()) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+        auto input = [&](uint32_t i) {
+            const Signal& signal = signals[netlist.GetInputNet(n, i)];
+            return signal.undefined ? FALSE_LITERAL : signal.literal;
+        };
+
+        uint32_t literal;
+        switch (node.op) {
+            case CircuitNetlist::NodeOp::AND:
+            case CircuitNetlist::NodeOp::NAND:
+                literal = TRUE_LITERAL;
+                for (uint32_t i = 0; i < node.inputCount; ++i) {
+                    literal = graph.And(literal, input(i));
+                }
+                if (node.op == CircuitNetlist::NodeOp::NAND) literal = AndInverterGraph::Not(literal);
+                break;
+            case CircuitNetlist::NodeOp::OR:
+            case CircuitNetlist::NodeOp::NOR:
+                literal = FALSE_LITERAL;
+                for (uint32_t i = 0; i < node.inputCount; ++i) {
+                    literal = graph.Or(literal, input(i));
+                }
+                if (node.op == CircuitNetlist::NodeOp::NOR) literal = AndInverterGraph::Not(literal);
+                break;
+            case CircuitNetlist::NodeOp::NOT:
+                literal = node.inputCount > 0 ? AndInverterGraph::Not(input(0)) : TRUE_LITERAL;
+                break;
+            case CircuitNetlist::NodeOp::XOR:
+            case CircuitNetlist::NodeOp::XNOR: {
+                bool anyUndefined = false;
+                literal = FALSE_LITERAL;
+                for (uint32_t i = 0; i < node.inputCount; ++i) {
+                    anyUndefined = anyUndefined || signals[netlist.GetInputNet(n, i)].undefined;
+                    literal = graph.Xor(literal, input(i));
+                }
+                if (node.op == CircuitNetlist::NodeOp::XNOR) literal = AndInverterGraph::Not(literal);
+                if (anyUndefined) literal = FALSE_LITERAL;
+                break;
+            }
+            default: {
+                // Blocks: tabulate over their variable inputs, constants stay fixed
+                std::vector<uint32_t> variableNets;
+                std::vector<uint32_t> literals;
+                std::vector<CircuitNetlist::LaneWord>& scratch = words[side];
+                for (uint32_t i = 0; i < node.inputCount; ++i) {
+                    uint32_t net = netlist.GetInputNet(n, i);
+                    const Signal& signal = signals[net];
+                    if (signal.undefined || signal.literal <= TRUE_LITERAL) {
+                        scratch[net].high = !signal.undefined && signal.literal == TRUE_LITERAL ? ~uint64_t(0) : 0;
+                        scratch[net].undefined = signal.undefined ? ~uint64_t(0) : 0;
+                    } else if (std::find(variableNets.begin(), variableNets.end(), net) == variableNets.end()) {
+                        variableNets.push_back(net);
+                        literals.push_back(signal.literal);
+                    }
+                }
+                if (variableNets.size() > MAX_TABLE_INPUTS) {
+                    unknownReason = wxString::Format("%s in the %s circuit has %zu variable inputs, more than %zu can be tabulated",
+                                                     netlist.DescribeNode(n), SIDE_NAMES[side],
+                                                     variableNets.size(), MAX_TABLE_INPUTS);
+                    return false;
+                }
+
+                const size_t rows = size_t(1) << variableNets.size();
+                std::vector<std::vector<uint8_t>> tables(node.outputCount, std::vector<uint8_t>(rows));
+                std::vector<size_t> undefinedCounts(node.outputCount, 0);
+                for (size_t block = 0; block * 64 < rows; ++block) {
+                    for (size_t v = 0; v < variableNets.size(); ++v) {
+                        scratch[variableNets[v]].high = v < 6 ? LOW_BIT_PATTERNS[v]
+                                                      : ((block >> (v - 6)) & 1) ? ~uint64_t(0) : 0;
+                        scratch[variableNets[v]].undefined = 0;
+                    }
+                    netlist.EvaluateNodeParallel(n, scratch);
+
+                    size_t lanes = std::min<size_t>(64, rows - block * 64);
+                    for (uint32_t o = 0; o < node.outputCount; ++o) {
+                        const CircuitNetlist::LaneWord& word = scratch[netlist.GetOutputNet(n, o)];
+                        for (size_t lane = 0; lane < lanes; ++lane) {
+                            tables[o][block * 64 + lane] = (word.high >> lane) & 1;
+                            undefinedCounts[o] += (word.undefined >> lane) & 1;
+                        }
+                    }
+                }
+
+                for (uint32_t o = 0; o < node.outputCount; ++o) {
+                    Signal& signal = signals[netlist.GetOutputNet(n, o)];
+                    if (undefinedCounts[o] == rows) {
+                        signal = Signal{ FALSE_LITERAL, true };
+                    } else if (undefinedCounts[o] != 0) {
+                        unknownReason = wxString::Format("%s in the %s circuit gives an undefined output for some inputs",
+                                                         netlist.DescribeNode(n), SIDE_NAMES[side]);
+                        return false;
+                    } else {
+                        signal = Signal{ TableToGraph(graph, tables[o], 0, literals, literals.size()), false };
+                    }
+                }
+                continue;
+            }
+        }
+
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            signals[netlist.GetOutputNet(n, o)] = Signal{ literal, false };
+        }
+    }
+
+    outputs.clear();
+    for (uint32_t net : outputNets[side]) {
+        outputs.push_back(signals[net]);
+    }
+    return true;
+}
+
+uint32_t EquivalenceChecker::TableToGraph(AndInverterGraph& graph, const std::vector<uint8_t>& table, size_t begin,
+                                          const std::vector<uint32_t>& literals, size_t variable) {
+    // Shannon expansion on the highest remaining variable
+    const size_t size = size_t(1) << variable;
+    if (std::all_of(table.begin() + begin, table.begin() + begin + size,
+                    [&](uint8_t value) { return value == table[begin]; })) {
+        return table[begin] ? AndInverterGraph::TRUE_LITERAL : AndInverterGraph::FALSE_LITERAL;
+    }
+
+    const size_t half = size / 2;
+    uint32_t whenLow = TableToGraph(graph, table, begin, literals, variable - 1);
+    uint32_t whenHigh = TableToGraph(graph, table, begin + half, literals, variable - 1);
+    return graph.Mux(literals[variable - 1], whenHigh, whenLow);
+}
+
+wxString EquivalenceChecker::Format() const {
+    static const char* METHOD_NAMES[] = { "exhaustive simulation", "random simulation", "SAT" };
+
+    wxString text;
+    switch (verdict) {
+        case Verdict::EQUIVALENT:
+            if (method == Method::EXHAUSTIVE) {
+                text = wxString::Format("Equivalent: all %zu outputs match for every combination of %zu inputs.\n",
+                                        outputNames.size(), inputNames.size());
+            } else {
+                text = wxString::Format("Equivalent: all %zu outputs proven equal with SAT "
+                                        "on a graph of %zu AND nodes.\n", outputNames.size(), andCount);
+            }
+            return text;
+
+        case Verdict::UNKNOWN:
+            text = wxString::Format("Not proven: %zu random vectors found no difference, but %s.\n",
+                                    RANDOM_PASSES * 64, unknownReason);
+            return text;
+
+        case Verdict::DIFFERENT:
+            break;
+    }
+
+    text = wxString::Format("Not equivalent (found by %s).\n\nInputs:\n", METHOD_NAMES[static_cast<int>(method)]);
+    for (size_t i = 0; i < inputNames.size(); ++i) {
+        text += wxString::Format("  %s = %d\n", inputNames[i], counterexample[i]);
+    }
+    text += "\nOutputs (first circuit vs second):\n";
+    for (const Mismatch& mismatch : mismatches) {
+        text += wxString::Format("  %s: %s vs %s\n", mismatch.output,
+                                 LogicValueName(mismatch.first), LogicValueName(mismatch.second));
+    }
+    return text;
+}
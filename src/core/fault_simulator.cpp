@@ -0,0 +1,196 @@
+#include "../../include/core/fault_simulator.h"
+#include <algorithm>
+
+const size_t FaultSimulator::NOT_DETECTED;
+const size_t FaultSimulator::FAULTS_PER_PASS;
+
+FaultSimulator::FaultSimulator() : detectedCount(0), vectorsRun(0), usefulVectors(0) {
+}
+
+void FaultSimulator::Clear() {
+    faults.clear();
+    detectedCount = 0;
+    vectorsRun = 0;
+    usefulVectors = 0;
+    lastError.Clear();
+}
+
+void FaultSimulator::EnumerateFaults(const CircuitNetlist& netlist) {
+    // Node order keeps the faults of one node together, as the forces need
+    for (uint32_t n = 0; n < netlist.GetNodeCount(); ++n) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+
+        uint32_t inputs = node.inputCount;
+        uint32_t outputs = node.outputCount;
+        if (node.op == CircuitNetlist::NodeOp::SOURCE) {
+            if (node.instance != 0) continue;   // Subcircuit ports, same nets as the instance pins
+            inputs = 0;
+        } else if (node.op == CircuitNetlist::NodeOp::SINK) {
+            // Only output LEDs are observed
+            if (std::find(netlist.GetOutputNodes().begin(), netlist.GetOutputNodes().end(), n) ==
+                netlist.GetOutputNodes().end()) continue;
+            outputs = 0;
+        } else if (node.op == CircuitNetlist::NodeOp::SUBCIRCUIT || node.op == CircuitNetlist::NodeOp::REMOVED) {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < inputs; ++i) {
+            faults.push_back(Fault{ n, i, false, false, NOT_DETECTED });
+            faults.push_back(Fault{ n, i, false, true, NOT_DETECTED });
+        }
+        for (uint32_t o = 0; o < outputs; ++o) {
+            faults.push_back(Fault{ n, o, true, false, NOT_DETECTED });
+            faults.push_back(Fault{ n, o, true, true, NOT_DETECTED });
+        }
+    }
+}
+
+bool FaultSimulator::Run(CircuitNetlist& netlist, const TestVectorRunner& vectors) {
+    Clear();
+
+    if (netlist.GetOutputNodes().empty()) {
+        lastError = "The circuit needs at least one output LED to observe faults";
+        return false;
+    }
+    if (!netlist.IsCombinational()) {
+        lastError = "Fault simulation needs a combinational circuit without flip-flops or feedback loops";
+        return false;
+    }
+    if (netlist.HasBuses()) {
+        lastError = "Fault simulation only supports single lines, the circuit contains buses";
+        return false;
+    }
+
+    // Input columns drive switches; LED columns are expected values, which
+    // fault simulation does not need
+    const std::vector<wxString>& columns = vectors.GetColumns();
+    std::vector<size_t> inputColumns;
+    std::vector<uint32_t> inputNets;
+    for (size_t c = 0; c < columns.size(); ++c) {
+        int node = netlist.FindInput(columns[c]);
+        if (node >= 0) {
+            inputColumns.push_back(c);
+            inputNets.push_back(netlist.GetOutputNet(node, 0));
+        } else if (netlist.FindOutput(columns[c]) < 0) {
+            lastError = wxString::Format("No input switch or output LED labeled '%s'", columns[c]);
+            return false;
+        }
+    }
+
+    const std::vector<uint32_t>& outputNodes = netlist.GetOutputNodes();
+    std::vector<uint32_t> outputNets;
+    for (uint32_t node : outputNodes) {
+        outputNets.push_back(netlist.GetInputNet(node, 0));
+    }
+
+    EnumerateFaults(netlist);
+    std::vector<uint32_t> remaining(faults.size());
+    for (size_t f = 0; f < faults.size(); ++f) {
+        remaining[f] = static_cast<uint32_t>(f);
+    }
+
+    std::vector<CircuitNetlist::LaneWord> words;
+    std::vector<CircuitNetlist::LaneForce> forces;
+    std::vector<CircuitNetlist::LaneForce> sinkForces;     // Applied when reading the LEDs
+    netlist.ResetParallel(words);
+
+    for (size_t row = 0; row < vectors.GetVectorCount() && !remaining.empty(); ++row) {
+        // Every lane sees the same vector; one full pass gives the
+        // fault-free values that the faulty passes start from
+        for (size_t i = 0; i < inputColumns.size(); ++i) {
+            uint8_t cell = vectors.GetCell(row, inputColumns[i]);
+            CircuitNetlist::LaneWord& word = words[inputNets[i]];
+            word.high = cell == TestVectorRunner::CELL_HIGH ? ~uint64_t(0) : 0;
+            word.undefined = cell == TestVectorRunner::CELL_X ? ~uint64_t(0) : 0;
+        }
+        netlist.EvaluateParallel(words);
+
+        // Remaining faults are compacted in place as they are dropped
+        size_t kept = 0;
+        bool useful = false;
+        for (size_t start = 0; start < remaining.size(); start += FAULTS_PER_PASS) {
+            size_t count = std::min(FAULTS_PER_PASS, remaining.size() - start);
+
+            forces.clear();
+            sinkForces.clear();
+            for (size_t k = 0; k < count; ++k) {
+                const Fault& fault = faults[remaining[start + k]];
+                const uint64_t lane = uint64_t(1) << (k + 1);
+                CircuitNetlist::LaneForce force = { fault.node, fault.pin, fault.output, lane, fault.stuckHigh ? lane : 0 };
+                if (netlist.GetNode(fault.node).op == CircuitNetlist::NodeOp::SINK) {
+                    sinkForces.push_back(force);
+                } else {
+                    forces.push_back(force);
+                }
+            }
+
+            netlist.EvaluateParallel(words, forces);
+
+            uint64_t detected = 0;
+            for (size_t o = 0; o < outputNets.size(); ++o) {
+                CircuitNetlist::LaneWord word = words[outputNets[o]];
+                for (const CircuitNetlist::LaneForce& force : sinkForces) {
+                    if (force.node != outputNodes[o]) continue;
+                    word.high = (word.high & ~force.lanes) | (force.high & force.lanes);
+                    word.undefined &= ~force.lanes;
+                }
+
+                // Lanes differ from the fault-free lane 0 only where both are defined
+                if (word.undefined & 1) continue;
+                uint64_t good = (word.high & 1) ? ~uint64_t(0) : 0;
+                detected |= (word.high ^ good) & ~word.undefined;
+            }
+            netlist.RestoreParallel(words);
+
+            for (size_t k = 0; k < count; ++k) {
+                uint32_t f = remaining[start + k];
+                if (detected & (uint64_t(1) << (k + 1))) {
+                    faults[f].detectedBy = row;
+                    detectedCount++;
+                    useful = true;
+                } else {
+                    remaining[kept++] = f;
+                }
+            }
+        }
+        remaining.resize(kept);
+
+        vectorsRun++;
+        if (useful) {
+            usefulVectors++;
+        }
+    }
+
+    return true;
+}
+
+double FaultSimulator::GetCoverage() const {
+    return faults.empty() ? 0.0 : 100.0 * detectedCount / faults.size();
+}
+
+wxString FaultSimulator::DescribeFault(const CircuitNetlist& netlist, const Fault& fault) {
+    return wxString::Format("%s %s %u stuck-at-%d", netlist.DescribeNode(fault.node),
+                            fault.output ? "output" : "input", fault.pin + 1, fault.stuckHigh ? 1 : 0);
+}
+
+wxString FaultSimulator::Format(const CircuitNetlist& netlist, size_t maxLines) const {
+    wxString text = wxString::Format("Fault coverage: %.1f%% (%zu of %zu stuck-at faults detected)\n",
+                                     GetCoverage(), detectedCount, faults.size());
+    text += wxString::Format("%zu vector(s) run, %zu detected new faults\n", vectorsRun, usefulVectors);
+
+    size_t undetected = faults.size() - detectedCount;
+    if (undetected == 0) return text;
+
+    text += "\nUndetected faults:\n";
+    size_t shown = 0;
+    for (const Fault& fault : faults) {
+        if (fault.detectedBy != NOT_DETECTED) continue;
+        if (shown == maxLines) break;
+        text += "  " + DescribeFault(netlist, fault) + "\n";
+        shown++;
+    }
+    if (undetected > shown) {
+        text += wxString::Format("... %zu more\n", undetected - shown);
+    }
+    return text;
+}
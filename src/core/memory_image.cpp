@@ -0,0 +1,334 @@
+#include "../../include/core/memory_image.h"
+#include "../../include/components/circuit_component.h"
+#include <wx/wfstream.h>
+#include <wx/txtstrm.h>
+#include <wx/filename.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __WXMSW__
+#include <wx/msw/wrapwin.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const size_t HEX_WORDS_PER_LINE = 8;
+const size_t MIN_HEX_RUN = 4;       // Shorter runs are written out word by word
+
+bool ParseHex(const std::string& text, uint64_t& value) {
+    if (text.empty() || text.size() > 16) return false;
+    char* end = nullptr;
+    value = std::strtoull(text.c_str(), &end, 16);
+    return *end == '\0';
+}
+
+} // namespace
+
+// Mapped File Implementation
+MappedFile::MappedFile()
+    : data(nullptr), size(0),
+#ifdef __WXMSW__
+      fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr)
+#else
+      fileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const wxString& filepath) {
+    Close();
+
+#ifdef __WXMSW__
+    fileHandle = ::CreateFileW(filepath.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER length;
+    if (!::GetFileSizeEx(fileHandle, &length) || length.QuadPart == 0) {
+        Close();
+        return false;
+    }
+
+    mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        Close();
+        return false;
+    }
+    data = static_cast<const uint8_t*>(::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    size = static_cast<size_t>(length.QuadPart);
+#else
+    fileDescriptor = ::open(filepath.fn_str(), O_RDONLY);
+    if (fileDescriptor < 0) return false;
+
+    struct stat info;
+    if (::fstat(fileDescriptor, &info) != 0 || info.st_size == 0) {
+        Close();
+        return false;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    data = view == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!data) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close() {
+#ifdef __WXMSW__
+    if (data) ::UnmapViewOfFile(data);
+    if (mappingHandle) ::CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) ::CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (data) ::munmap(const_cast<uint8_t*>(data), size);
+    if (fileDescriptor >= 0) ::close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// Memory Image Implementation
+const int MemoryImage::MIN_ADDRESS_WIDTH;
+const int MemoryImage::MAX_ADDRESS_WIDTH;
+const int MemoryImage::DEFAULT_ADDRESS_WIDTH;
+const size_t MemoryImage::MAP_THRESHOLD;
+
+MemoryImage::MemoryImage(int addressBits, int dataBits) : addressWidth(0), dataWidth(0), wordBytes(0) {
+    Resize(addressBits, dataBits);
+}
+
+const uint8_t* MemoryImage::GetBytes() const {
+    return mapping ? mapping->GetData() : bytes.data();
+}
+
+size_t MemoryImage::GetByteCount() const {
+    return std::min(mapping ? mapping->GetSize() : bytes.size(), GetWordCount() * wordBytes);
+}
+
+uint64_t MemoryImage::Read(uint64_t address) const {
+    size_t offset = static_cast<size_t>(address & (GetWordCount() - 1)) * wordBytes;
+    if (offset + wordBytes > GetByteCount()) return 0;
+
+    const uint8_t* word = GetBytes() + offset;
+    uint64_t value = 0;
+    for (size_t b = 0; b < wordBytes; ++b) {
+        value |= uint64_t(word[b]) << (8 * b);
+    }
+    return value & BusMask(dataWidth);
+}
+
+void MemoryImage::Write(uint64_t address, uint64_t value) {
+    if (mapping) Unmap();
+
+    uint8_t* word = bytes.data() + static_cast<size_t>(address & (GetWordCount() - 1)) * wordBytes;
+    value &= BusMask(dataWidth);
+    for (size_t b = 0; b < wordBytes; ++b) {
+        word[b] = static_cast<uint8_t>(value >> (8 * b));
+    }
+}
+
+void MemoryImage::Resize(int addressBits, int dataBits) {
+    addressWidth = std::max(MIN_ADDRESS_WIDTH, std::min(MAX_ADDRESS_WIDTH, addressBits));
+    dataWidth = std::max(1, std::min(64, dataBits));
+    wordBytes = (dataWidth + 7) / 8;
+    Clear();
+}
+
+void MemoryImage::Clear() {
+    mapping.reset();
+    sourcePath.Clear();
+    bytes.assign(GetWordCount() * wordBytes, 0);
+}
+
+void MemoryImage::Unmap() {
+    // Copy the mapped words so the image can be written
+    std::vector<uint8_t> copy(GetWordCount() * wordBytes, 0);
+    std::copy(GetBytes(), GetBytes() + GetByteCount(), copy.begin());
+    bytes.swap(copy);
+    mapping.reset();
+}
+
+MemoryImage::Format MemoryImage::ResolveFormat(const wxString& filepath, Format format) {
+    if (format != Format::AUTO) return format;
+
+    wxString extension = wxFileName(filepath).GetExt().Lower();
+    return (extension == "hex" || extension == "txt") ? Format::HEX : Format::BINARY;
+}
+
+bool MemoryImage::LoadFromFile(const wxString& filepath, Format format) {
+    if (!wxFileExists(filepath)) {
+        lastError = wxString::Format("File not found: %s", filepath);
+        return false;
+    }
+
+    lastError.Clear();
+    bool loaded = ResolveFormat(filepath, format) == Format::HEX ? LoadHex(filepath) : LoadBinary(filepath);
+    if (!loaded) {
+        Clear();
+        return false;
+    }
+
+    sourcePath = filepath;
+    return true;
+}
+
+bool MemoryImage::SaveToFile(const wxString& filepath, Format format) {
+    lastError.Clear();
+    return ResolveFormat(filepath, format) == Format::HEX ? SaveHex(filepath) : SaveBinary(filepath);
+}
+
+bool MemoryImage::LoadBinary(const wxString& filepath) {
+    // Big images are left in the page cache and paged in as they are read
+    if (wxFileName::GetSize(filepath).GetValue() >= MAP_THRESHOLD) {
+        std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+        if (file->Open(filepath)) {
+            bytes.clear();
+            bytes.shrink_to_fit();
+            mapping = file;
+            return true;
+        }
+    }
+
+    wxFileInputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot open %s", filepath);
+        return false;
+    }
+
+    mapping.reset();
+    bytes.assign(GetWordCount() * wordBytes, 0);
+    fileStream.Read(bytes.data(), bytes.size());
+    return true;
+}
+
+bool MemoryImage::LoadHex(const wxString& filepath) {
+    wxFileInputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot open %s", filepath);
+        return false;
+    }
+
+    mapping.reset();
+    bytes.assign(GetWordCount() * wordBytes, 0);
+
+    wxTextInputStream textStream(fileStream);
+    uint64_t address = 0;
+    size_t lineNumber = 0;
+    while (!fileStream.Eof()) {
+        wxString line = textStream.ReadLine();
+        ++lineNumber;
+
+        int comment = line.Find('#');
+        if (comment != wxNOT_FOUND) line.Truncate(comment);
+        line = line.Trim(false).Trim(true);
+        if (line.empty() || (lineNumber == 1 && line == "v2.0 raw")) continue;
+
+        std::string text = line.ToStdString();
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find_first_of(" \t,", start);
+            if (end == std::string::npos) end = text.size();
+            std::string token = text.substr(start, end - start);
+            start = end + 1;
+            if (token.empty()) continue;
+
+            uint64_t value;
+            uint64_t count = 1;
+            bool valid;
+            if (token.back() == ':') {
+                valid = ParseHex(token.substr(0, token.size() - 1), address);
+                if (valid) continue;
+            } else {
+                size_t star = token.find('*');
+                if (star == std::string::npos) {
+                    valid = ParseHex(token, value);
+                } else {
+                    char* countEnd = nullptr;
+                    count = std::strtoull(token.substr(0, star).c_str(), &countEnd, 10);
+                    valid = *countEnd == '\0' && star > 0 && ParseHex(token.substr(star + 1), value);
+                }
+            }
+            if (!valid) {
+                lastError = wxString::Format("%s:%zu: invalid word \"%s\"", filepath, lineNumber, wxString(token));
+                return false;
+            }
+            if (address + count > GetWordCount()) {
+                lastError = wxString::Format("%s:%zu: image has more than %zu words", filepath, lineNumber,
+                                             GetWordCount());
+                return false;
+            }
+
+            for (uint64_t i = 0; i < count; ++i) {
+                Write(address++, value);
+            }
+        }
+    }
+    return true;
+}
+
+bool MemoryImage::SaveBinary(const wxString& filepath) {
+    wxFileOutputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot write %s", filepath);
+        return false;
+    }
+
+    std::vector<uint8_t> zeros(GetWordCount() * wordBytes - GetByteCount(), 0);
+    fileStream.Write(GetBytes(), GetByteCount());
+    fileStream.Write(zeros.data(), zeros.size());
+    return fileStream.IsOk();
+}
+
+bool MemoryImage::SaveHex(const wxString& filepath) {
+    wxFileOutputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot write %s", filepath);
+        return false;
+    }
+
+    wxTextOutputStream textStream(fileStream);
+    textStream.WriteString("v2.0 raw\n");
+
+    // Trailing zero words are left out, they are zero after loading anyway
+    size_t wordCount = GetWordCount();
+    while (wordCount > 0 && Read(wordCount - 1) == 0) {
+        --wordCount;
+    }
+
+    size_t column = 0;
+    for (size_t address = 0; address < wordCount;) {
+        uint64_t value = Read(address);
+        size_t run = 1;
+        while (address + run < wordCount && Read(address + run) == value) {
+            ++run;
+        }
+
+        wxString token = wxString::Format("%llx", static_cast<unsigned long long>(value));
+        if (run >= MIN_HEX_RUN) {
+            token = wxString::Format("%zu*", run) + token;
+        } else {
+            run = 1;
+        }
+        address += run;
+
+        textStream.WriteString(token + (++column % HEX_WORDS_PER_LINE == 0 || address == wordCount ? "\n" : " "));
+    }
+    return fileStream.IsOk();
+}
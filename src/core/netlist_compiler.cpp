@@ -0,0 +1,229 @@
+#include "../../include/core/netlist_compiler.h"
+#include <wx/filename.h>
+#include <wx/wfstream.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+#ifdef __WXMSW__
+const char* const LIBRARY_EXTENSION = ".dll";
+#else
+const char* const LIBRARY_EXTENSION = ".so";
+#endif
+
+const char* const FUNCTION_NAME = "EvaluateNetlist";
+
+// Gates per generated function. Compilers slow down sharply on huge
+// functions, so the parts are kept small and are not inlined.
+const size_t GATES_PER_FUNCTION = 64;
+
+} // namespace
+
+NetlistCompiler::Job::~Job() {
+    library.Unload();
+    for (const wxString& path : { sourcePath, libraryPath, basePath }) {
+        if (!path.IsEmpty() && wxFileExists(path)) wxRemoveFile(path);
+    }
+#ifdef __WXMSW__
+    // cl also leaves the object file, an import library and an export file
+    for (const char* extension : { ".dll.obj", ".lib", ".exp" }) {
+        if (!basePath.IsEmpty() && wxFileExists(basePath + extension)) wxRemoveFile(basePath + extension);
+    }
+#endif
+}
+
+void NetlistCompiler::Job::Run() {
+    {
+        wxFileOutputStream stream(sourcePath);
+        std::string text = source.ToStdString();
+        if (!stream.IsOk() || !stream.Write(text.data(), text.size()).IsOk()) {
+            error = "Cannot write " + sourcePath;
+            state.store(State::FAILED);
+            return;
+        }
+    }
+
+    int status = std::system(command.ToStdString().c_str());
+    if (status != 0) {
+        error = wxString::Format("The compiler failed with status %d: %s", status, command);
+        state.store(State::FAILED);
+        return;
+    }
+
+    if (!library.Load(libraryPath, wxDL_NOW | wxDL_QUIET)) {
+        error = "Cannot load " + libraryPath;
+        state.store(State::FAILED);
+        return;
+    }
+    function = reinterpret_cast<EvaluateFunction>(library.GetSymbol(FUNCTION_NAME));
+    if (!function) {
+        error = wxString::Format("%s has no function %s", libraryPath, FUNCTION_NAME);
+        state.store(State::FAILED);
+        return;
+    }
+    state.store(State::READY);
+}
+
+bool NetlistCompiler::CanCompile(const CircuitNetlist& netlist) {
+    if (!netlist.IsCombinational() || netlist.HasBuses()) return false;
+    for (uint32_t n : netlist.GetLevelOrder()) {
+        if (!CircuitNetlist::IsGate(netlist.GetNode(n).op)) return false;
+    }
+    return true;
+}
+
+wxString NetlistCompiler::GenerateSource(const CircuitNetlist& netlist) {
+    // Same semantics as EvaluateNodeParallel: gate outputs are never
+    // undefined, and only XOR and XNOR look at the undefined masks
+    wxString text;
+    text += "// Generated by LogicSimulator from a compiled netlist\n"
+            "#include <stdint.h>\n\n"
+            "struct LaneWord { uint64_t high; uint64_t undefined; };\n\n"
+            "#ifdef _WIN32\n"
+            "#define EXPORT extern \"C\" __declspec(dllexport)\n"
+            "#define PART static __declspec(noinline) void\n"
+            "#else\n"
+            "#define EXPORT extern \"C\"\n"
+            "#define PART static __attribute__((noinline)) void\n"
+            "#endif\n";
+
+    typedef CircuitNetlist::NodeOp NodeOp;
+
+    // Nets driven only by gates are never undefined, so their masks need not be read
+    std::vector<uint8_t> maybeUndefined(netlist.GetNetCount(), 1);
+    for (int gates = 1; gates >= 0; --gates) {
+        for (uint32_t n = 0; n < netlist.GetNodeCount(); ++n) {
+            const CircuitNetlist::Node& node = netlist.GetNode(n);
+            if (CircuitNetlist::IsGate(node.op) != (gates == 1)) continue;
+            if (node.op == NodeOp::SUBCIRCUIT || node.op == NodeOp::REMOVED) continue;
+            for (uint32_t o = 0; o < node.outputCount; ++o) {
+                maybeUndefined[netlist.GetOutputNet(n, o)] = !gates;
+            }
+        }
+    }
+
+    // Within one part, results are read back from locals instead of the words
+    std::vector<size_t> localPart(netlist.GetNetCount(), ~size_t(0));
+    std::vector<size_t> localIndex(netlist.GetNetCount(), 0);
+    auto high = [&](uint32_t net, size_t part) {
+        return localPart[net] == part ? wxString::Format("v%zu", localIndex[net])
+                                      : wxString::Format("w[%u].high", net);
+    };
+
+    const std::vector<uint32_t>& order = netlist.GetLevelOrder();
+    size_t parts = 0;
+    for (size_t begin = 0; begin < order.size(); begin += GATES_PER_FUNCTION) {
+        size_t part = parts++;
+        text += wxString::Format("\nPART Evaluate%zu(LaneWord* w) {\n", part);
+
+        size_t end = std::min(order.size(), begin + GATES_PER_FUNCTION);
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t n = order[i];
+            const CircuitNetlist::Node& node = netlist.GetNode(n);
+            if (node.outputCount == 0) continue;
+
+            wxString expression;
+            switch (node.op) {
+                case NodeOp::AND:
+                case NodeOp::NAND:
+                case NodeOp::OR:
+                case NodeOp::NOR: {
+                    bool isAnd = node.op == NodeOp::AND || node.op == NodeOp::NAND;
+                    for (uint32_t in = 0; in < node.inputCount; ++in) {
+                        if (in > 0) expression += isAnd ? " & " : " | ";
+                        expression += high(netlist.GetInputNet(n, in), part);
+                    }
+                    if (node.inputCount == 0) expression = isAnd ? "~uint64_t(0)" : "uint64_t(0)";
+                    if (node.op == NodeOp::NAND || node.op == NodeOp::NOR) expression = "~(" + expression + ")";
+                    break;
+                }
+                case NodeOp::NOT:
+                    expression = node.inputCount > 0 ? "~" + high(netlist.GetInputNet(n, 0), part)
+                                                     : wxString("~uint64_t(0)");
+                    break;
+                case NodeOp::XOR:
+                case NodeOp::XNOR: {
+                    wxString undefined;
+                    wxString parity = "0";
+                    for (uint32_t in = 0; in < node.inputCount; ++in) {
+                        uint32_t net = netlist.GetInputNet(n, in);
+                        if (maybeUndefined[net]) undefined += wxString::Format(" | w[%u].undefined", net);
+                        parity += " ^ " + high(net, part);
+                    }
+                    expression = (node.op == NodeOp::XOR ? "(" : "~(") + parity + ")";
+                    if (!undefined.IsEmpty()) expression = "~(0" + undefined + ") & " + expression;
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            text += wxString::Format("    const uint64_t v%zu = ", i) + expression + ";\n";
+            for (uint32_t o = 0; o < node.outputCount; ++o) {
+                uint32_t net = netlist.GetOutputNet(n, o);
+                text += wxString::Format("    w[%u].high = v%zu;\n    w[%u].undefined = 0;\n", net, i, net);
+                localPart[net] = part;
+                localIndex[net] = i;
+            }
+        }
+        text += "}\n";
+    }
+
+    text += wxString::Format("\nEXPORT void %s(LaneWord* w) {\n", FUNCTION_NAME);
+    for (size_t part = 0; part < parts; ++part) {
+        text += wxString::Format("    Evaluate%zu(w);\n", part);
+    }
+    text += "}\n";
+    return text;
+}
+
+wxString NetlistCompiler::GetDefaultCommand() {
+#ifdef __WXMSW__
+    return "cl /nologo /O1 /LD \"{source}\" /Fe\"{library}\" /Fo\"{library}.obj\"";
+#else
+    return "c++ -O1 -shared -fPIC -o \"{library}\" \"{source}\"";
+#endif
+}
+
+NetlistCompiler::~NetlistCompiler() {
+    Join();
+}
+
+void NetlistCompiler::Join() {
+    if (worker.joinable()) worker.join();
+}
+
+NetlistCompiler::State NetlistCompiler::Wait() {
+    Join();
+    return GetState();
+}
+
+bool NetlistCompiler::Start(const CircuitNetlist& netlist, const wxString& command) {
+    // The previous build may still be writing its files or loading its library
+    Join();
+    job.reset();
+    if (!CanCompile(netlist)) return false;
+
+    std::unique_ptr<Job> next(new Job());
+    next->basePath = wxFileName::CreateTempFileName(wxFileName::GetTempDir() + wxFileName::GetPathSeparator() +
+                                                    "logisim");
+    if (next->basePath.IsEmpty()) return false;
+    next->sourcePath = next->basePath + ".cpp";
+    next->libraryPath = next->basePath + LIBRARY_EXTENSION;
+    next->source = GenerateSource(netlist);
+
+    next->command = command;
+    next->command.Replace("{source}", next->sourcePath);
+    next->command.Replace("{library}", next->libraryPath);
+
+    job = std::move(next);
+    Job* running = job.get();
+    worker = std::thread([running]() { running->Run(); });
+    return true;
+}
+
+wxString NetlistCompiler::GetLastError() const {
+    if (!job) return "The circuit cannot be compiled";
+    return job->state.load() == State::FAILED ? job->error : wxString();
+}
@@ -0,0 +1,317 @@
+#include "../../include/core/sat_solver.h"
+#include <algorithm>
+
+const uint32_t SatSolver::NO_CLAUSE;
+const uint8_t SatSolver::VALUE_FALSE;
+const uint8_t SatSolver::VALUE_TRUE;
+const uint8_t SatSolver::VALUE_UNASSIGNED;
+
+namespace {
+
+const size_t RESTART_INTERVAL = 100;    // Conflicts per unit of the Luby series
+const double ACTIVITY_DECAY = 0.95;
+const double ACTIVITY_LIMIT = 1e100;
+
+} // namespace
+
+SatSolver::SatSolver()
+    : propagated(0), inconsistent(false), activityIncrement(1.0), conflicts(0) {
+}
+
+uint32_t SatSolver::NewVariable() {
+    uint32_t variable = static_cast<uint32_t>(values.size());
+    values.push_back(VALUE_UNASSIGNED);
+    savedPhases.push_back(VALUE_FALSE);
+    levels.push_back(0);
+    reasons.push_back(NO_CLAUSE);
+    activity.push_back(0.0);
+    heapIndex.push_back(NO_CLAUSE);
+    seen.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    HeapInsert(variable);
+    return variable;
+}
+
+uint8_t SatSolver::LiteralValue(uint32_t literal) const {
+    uint8_t value = values[literal >> 1];
+    return value == VALUE_UNASSIGNED ? value : value ^ (literal & 1);
+}
+
+void SatSolver::AddClause(std::vector<uint32_t> literals) {
+    if (inconsistent) return;
+
+    // Clauses are only added before solving, at level 0
+    std::sort(literals.begin(), literals.end());
+    size_t kept = 0;
+    for (size_t i = 0; i < literals.size(); ++i) {
+        uint32_t literal = literals[i];
+        if (LiteralValue(literal) == VALUE_TRUE) return;
+        if (kept > 0 && literals[kept - 1] == Negate(literal)) return;    // Tautology
+        if (LiteralValue(literal) == VALUE_FALSE) continue;
+        if (kept > 0 && literals[kept - 1] == literal) continue;
+        literals[kept++] = literal;
+    }
+    literals.resize(kept);
+
+    if (literals.empty()) {
+        inconsistent = true;
+    } else if (literals.size() == 1) {
+        Assign(literals[0], NO_CLAUSE);
+        inconsistent = Propagate() != NO_CLAUSE;
+    } else {
+        clauses.push_back(literals);
+        AttachClause(static_cast<uint32_t>(clauses.size() - 1));
+    }
+}
+
+void SatSolver::AttachClause(uint32_t clause) {
+    watches[clauses[clause][0]].push_back(clause);
+    watches[clauses[clause][1]].push_back(clause);
+}
+
+void SatSolver::Assign(uint32_t literal, uint32_t reason) {
+    uint32_t variable = literal >> 1;
+    values[variable] = (literal & 1) ? VALUE_FALSE : VALUE_TRUE;
+    levels[variable] = DecisionLevel();
+    reasons[variable] = reason;
+    trail.push_back(literal);
+}
+
+uint32_t SatSolver::Propagate() {
+    while (propagated < trail.size()) {
+        // Clauses watching the literal that just became false
+        uint32_t falsified = Negate(trail[propagated++]);
+        std::vector<uint32_t>& watching = watches[falsified];
+
+        size_t kept = 0;
+        for (size_t w = 0; w < watching.size(); ++w) {
+            uint32_t c = watching[w];
+            std::vector<uint32_t>& clause = clauses[c];
+
+            // Keep the falsified watch in slot 1
+            if (clause[0] == falsified) std::swap(clause[0], clause[1]);
+            if (LiteralValue(clause[0]) == VALUE_TRUE) {
+                watching[kept++] = c;
+                continue;
+            }
+
+            // Look for a new literal to watch
+            bool moved = false;
+            for (size_t i = 2; i < clause.size(); ++i) {
+                if (LiteralValue(clause[i]) != VALUE_FALSE) {
+                    std::swap(clause[1], clause[i]);
+                    watches[clause[1]].push_back(c);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) continue;
+
+            watching[kept++] = c;
+            if (LiteralValue(clause[0]) == VALUE_FALSE) {
+                // Conflict; keep the remaining watches before returning
+                for (++w; w < watching.size(); ++w) {
+                    watching[kept++] = watching[w];
+                }
+                watching.resize(kept);
+                return c;
+            }
+            Assign(clause[0], c);
+        }
+        watching.resize(kept);
+    }
+    return NO_CLAUSE;
+}
+
+void SatSolver::Analyze(uint32_t conflict, std::vector<uint32_t>& learnt, uint32_t& backtrackLevel) {
+    // Resolve backwards along the trail until one literal of the current
+    // level is left; slot 0 is kept for it
+    learnt.assign(1, 0);
+    size_t pending = 0;
+    size_t index = trail.size();
+    uint32_t literal = NO_CLAUSE;
+
+    do {
+        const std::vector<uint32_t>& clause = clauses[conflict];
+        for (size_t i = (literal == NO_CLAUSE ? 0 : 1); i < clause.size(); ++i) {
+            uint32_t variable = clause[i] >> 1;
+            if (seen[variable] || levels[variable] == 0) continue;
+
+            seen[variable] = 1;
+            BumpActivity(variable);
+            if (levels[variable] == DecisionLevel()) {
+                ++pending;
+            } else {
+                learnt.push_back(clause[i]);
+            }
+        }
+
+        while (!seen[trail[--index] >> 1]) {
+        }
+        literal = trail[index];
+        conflict = reasons[literal >> 1];
+        seen[literal >> 1] = 0;
+        --pending;
+    } while (pending > 0);
+    learnt[0] = Negate(literal);
+
+    // Backtrack to the second highest level, whose literal becomes the other watch
+    backtrackLevel = 0;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        seen[learnt[i] >> 1] = 0;
+        if (levels[learnt[i] >> 1] > backtrackLevel) {
+            backtrackLevel = levels[learnt[i] >> 1];
+            std::swap(learnt[1], learnt[i]);
+        }
+    }
+
+    activityIncrement /= ACTIVITY_DECAY;
+}
+
+void SatSolver::Backtrack(uint32_t level) {
+    if (DecisionLevel() <= level) return;
+
+    for (size_t i = trail.size(); i-- > trailLimits[level];) {
+        uint32_t variable = trail[i] >> 1;
+        savedPhases[variable] = values[variable];
+        values[variable] = VALUE_UNASSIGNED;
+        reasons[variable] = NO_CLAUSE;
+        HeapInsert(variable);
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    propagated = trail.size();
+}
+
+SatSolver::Result SatSolver::Solve(size_t conflictLimit) {
+    if (inconsistent) return Result::UNSATISFIABLE;
+
+    std::vector<uint32_t> learnt;
+    size_t restarts = 0;
+    size_t restartAt = conflicts + RESTART_INTERVAL * Luby(restarts);
+    const size_t limit = conflicts + conflictLimit;
+
+    for (;;) {
+        uint32_t conflict = Propagate();
+        if (conflict != NO_CLAUSE) {
+            ++conflicts;
+            if (DecisionLevel() == 0) {
+                inconsistent = true;
+                return Result::UNSATISFIABLE;
+            }
+
+            uint32_t backtrackLevel;
+            Analyze(conflict, learnt, backtrackLevel);
+            Backtrack(backtrackLevel);
+            if (learnt.size() == 1) {
+                Assign(learnt[0], NO_CLAUSE);
+            } else {
+                clauses.push_back(learnt);
+                uint32_t clause = static_cast<uint32_t>(clauses.size() - 1);
+                AttachClause(clause);
+                Assign(learnt[0], clause);
+            }
+            continue;
+        }
+
+        if (conflicts >= limit) {
+            Backtrack(0);
+            return Result::UNKNOWN;
+        }
+        if (conflicts >= restartAt) {
+            Backtrack(0);
+            restartAt = conflicts + RESTART_INTERVAL * Luby(++restarts);
+        }
+
+        // Decide on the most active unassigned variable
+        uint32_t variable = NO_CLAUSE;
+        while (!heap.empty()) {
+            uint32_t candidate = HeapPop();
+            if (values[candidate] == VALUE_UNASSIGNED) {
+                variable = candidate;
+                break;
+            }
+        }
+        if (variable == NO_CLAUSE) {
+            return Result::SATISFIABLE;
+        }
+
+        trailLimits.push_back(static_cast<uint32_t>(trail.size()));
+        Assign(MakeLiteral(variable, savedPhases[variable] == VALUE_FALSE), NO_CLAUSE);
+    }
+}
+
+void SatSolver::BumpActivity(uint32_t variable) {
+    activity[variable] += activityIncrement;
+    if (activity[variable] > ACTIVITY_LIMIT) {
+        for (double& value : activity) value /= ACTIVITY_LIMIT;
+        activityIncrement /= ACTIVITY_LIMIT;
+    }
+    if (heapIndex[variable] != NO_CLAUSE) {
+        HeapUp(heapIndex[variable]);
+    }
+}
+
+void SatSolver::HeapInsert(uint32_t variable) {
+    if (heapIndex[variable] != NO_CLAUSE) return;
+    heapIndex[variable] = static_cast<uint32_t>(heap.size());
+    heap.push_back(variable);
+    HeapUp(heap.size() - 1);
+}
+
+uint32_t SatSolver::HeapPop() {
+    uint32_t top = heap[0];
+    heapIndex[top] = NO_CLAUSE;
+    heap[0] = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heapIndex[heap[0]] = 0;
+        HeapDown(0);
+    }
+    return top;
+}
+
+void SatSolver::HeapUp(size_t position) {
+    uint32_t variable = heap[position];
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (activity[heap[parent]] >= activity[variable]) break;
+        heap[position] = heap[parent];
+        heapIndex[heap[position]] = static_cast<uint32_t>(position);
+        position = parent;
+    }
+    heap[position] = variable;
+    heapIndex[variable] = static_cast<uint32_t>(position);
+}
+
+void SatSolver::HeapDown(size_t position) {
+    uint32_t variable = heap[position];
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= heap.size()) break;
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) ++child;
+        if (activity[heap[child]] <= activity[variable]) break;
+        heap[position] = heap[child];
+        heapIndex[heap[position]] = static_cast<uint32_t>(position);
+        position = child;
+    }
+    heap[position] = variable;
+    heapIndex[variable] = static_cast<uint32_t>(position);
+}
+
+size_t SatSolver::Luby(size_t index) {
+    // 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+    size_t size = 1;
+    size_t power = 0;
+    while (size < index + 1) {
+        size = 2 * size + 1;
+        ++power;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) / 2;
+        --power;
+        index %= size;
+    }
+    return size_t(1) << power;
+}
@@ -0,0 +1,216 @@
+#include "../../include/core/simulation_controller.h"
+#include "../../include/components/component_factory.h"
+#include <algorithm>
+
+const wxEventType SimulationController::wxEVT_SIMULATION_STOPPED = wxNewEventType();
+
+RunCondition RunCondition::Cycles(uint64_t count) {
+    RunCondition condition;
+    condition.kind = Kind::CYCLES;
+    condition.cycles = count;
+    return condition;
+}
+
+RunCondition RunCondition::NetEquals(uint32_t net, BusValue value) {
+    RunCondition condition;
+    condition.kind = Kind::NET_EQUALS;
+    condition.net = net;
+    condition.value = value;
+    return condition;
+}
+
+RunCondition RunCondition::NetChanges(uint32_t net) {
+    RunCondition condition;
+    condition.kind = Kind::NET_CHANGES;
+    condition.net = net;
+    return condition;
+}
+
+SimulationController::SimulationController(CircuitNetlist& compiled, wxEvtHandler* stopListener)
+    : netlist(compiled), listener(stopListener), recorder(nullptr), pauseRequested(false), running(false), cycle(0),
+      lastStop(SimulationStop::PAUSED) {
+}
+
+SimulationController::~SimulationController() {
+    Pause();
+}
+
+bool SimulationController::Run(const RunCondition& condition) {
+    if (running) return false;
+    if (worker.joinable()) worker.join();
+
+    pauseRequested = false;
+    running = true;
+    worker = std::thread([this, condition]() {
+        SimulationStop stop = RunCycles(condition);
+        lastStop = stop;
+
+        // The event carries the hit, the listener may only get it after the next run started
+        long firstHit = -1;
+        if (stop == SimulationStop::BREAKPOINT) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!breakpointHits.empty()) firstHit = breakpointHits[0];
+        }
+        running = false;
+
+        if (listener) {
+            wxCommandEvent* event = new wxCommandEvent(wxEVT_SIMULATION_STOPPED);
+            event->SetInt(static_cast<int>(stop));
+            event->SetExtraLong(firstHit);
+            wxQueueEvent(listener, event);
+        }
+    });
+    return true;
+}
+
+void SimulationController::Pause() {
+    pauseRequested = true;
+    if (worker.joinable()) worker.join();
+    pauseRequested = false;
+}
+
+SimulationStop SimulationController::Step(const RunCondition& condition) {
+    if (running) return SimulationStop::PAUSED;
+
+    // A step always ends by itself
+    SimulationStop stop = RunCycles(condition.kind == RunCondition::Kind::NONE ? RunCondition::Cycles(1) : condition);
+    lastStop = stop;
+    return stop;
+}
+
+SimulationStop SimulationController::RunCycles(const RunCondition& condition) {
+    const std::vector<uint32_t>& clocks = netlist.GetClockNets();
+    if (clocks.empty()) return SimulationStop::NO_CLOCK;
+
+    const LogicValue phases[] = { LogicValue::HIGH, LogicValue::LOW };
+    uint64_t done = 0;
+    BusValue watched = { 0, 0 };
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+
+        // Start undriven clocks low so the first cycle is a real rising edge
+        bool undriven = false;
+        for (uint32_t net : clocks) {
+            if (netlist.GetNetValue(net) == LogicValue::UNDEFINED) {
+                netlist.SetNetValue(net, LogicValue::LOW);
+                undriven = true;
+            }
+        }
+        if (undriven && !netlist.Settle()) return SimulationStop::OSCILLATING;
+
+        // Only changes made by this run count
+        netlist.ClearWatchpointHits();
+        breakpointHits.clear();
+
+        if (condition.kind == RunCondition::Kind::NET_CHANGES) {
+            watched = netlist.ReadNet(condition.net);
+        }
+    }
+
+    while (!pauseRequested) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+
+        for (LogicValue phase : phases) {
+            for (uint32_t net : clocks) {
+                netlist.SetNetValue(net, phase);
+            }
+            if (!netlist.Settle()) return SimulationStop::OSCILLATING;
+
+            // Watched nets were checked as they changed; stop after the phase
+            if (netlist.HasWatchpointHits()) {
+                breakpointHits = netlist.GetWatchpointHits();
+                return SimulationStop::BREAKPOINT;
+            }
+
+            // Breakpoints stop right after the phase that changed the net
+            if (condition.kind == RunCondition::Kind::NET_CHANGES) {
+                BusValue value = netlist.ReadNet(condition.net);
+                if (value.bits != watched.bits || value.undefined != watched.undefined) {
+                    return SimulationStop::NET_CHANGED;
+                }
+            }
+        }
+        ++cycle;
+        ++done;
+        if (recorder) {
+            recorder->Sample(netlist);
+        }
+
+        if (condition.kind == RunCondition::Kind::CYCLES && done >= condition.cycles) {
+            return SimulationStop::CYCLES_DONE;
+        }
+        if (condition.kind == RunCondition::Kind::NET_EQUALS) {
+            BusValue value = netlist.ReadNet(condition.net);
+            if (value.bits == condition.value.bits && value.undefined == condition.value.undefined) {
+                return SimulationStop::NET_EQUAL;
+            }
+        }
+    }
+    return SimulationStop::PAUSED;
+}
+
+wxString SimulationController::DescribeStop(SimulationStop reason) {
+    switch (reason) {
+        case SimulationStop::PAUSED:      return "Paused";
+        case SimulationStop::CYCLES_DONE: return "Cycle count reached";
+        case SimulationStop::NET_EQUAL:   return "Net reached the value";
+        case SimulationStop::NET_CHANGED: return "Breakpoint: net changed";
+        case SimulationStop::OSCILLATING: return "Circuit is oscillating";
+        case SimulationStop::NO_CLOCK:    return "No clock generator to step";
+        case SimulationStop::BREAKPOINT:  return "Breakpoint hit";
+    }
+    return wxEmptyString;
+}
+
+void SimulationController::AddBreakpoint(const Breakpoint& breakpoint) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    breakpoints.push_back(breakpoint);
+    ApplyBreakpoints();
+}
+
+void SimulationController::RemoveBreakpoint(size_t index) {
+    if (index >= breakpoints.size()) return;
+
+    std::lock_guard<std::mutex> lock(stateMutex);
+    breakpoints.erase(breakpoints.begin() + index);
+    ApplyBreakpoints();
+}
+
+void SimulationController::ClearBreakpoints() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    breakpoints.clear();
+    ApplyBreakpoints();
+}
+
+std::vector<uint32_t> SimulationController::GetBreakpointHits() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return breakpointHits;
+}
+
+void SimulationController::ApplyBreakpoints() {
+    netlist.ClearWatchpoints();
+    for (size_t i = 0; i < breakpoints.size(); ++i) {
+        const Breakpoint& breakpoint = breakpoints[i];
+        const CircuitComponent* component = findComponent ? findComponent(breakpoint.componentId) : nullptr;
+        if (!breakpoint.enabled || !component) continue;
+
+        uint32_t net = netlist.FindPinNet(component, breakpoint.pinIndex);
+        if (net == CircuitNetlist::NO_NET) continue;
+
+        CircuitNetlist::Watchpoint watchpoint = { net, breakpoint.kind, breakpoint.value, static_cast<uint32_t>(i) };
+        netlist.AddWatchpoint(watchpoint);
+    }
+}
+
+wxString SimulationController::DescribeBreakpoint(const Breakpoint& breakpoint) {
+    wxString pin = wxString::Format("%s pin %zu", ComponentFactory::GetTypeName(breakpoint.componentType),
+                                    breakpoint.pinIndex);
+    switch (breakpoint.kind) {
+        case CircuitNetlist::Watchpoint::Kind::CHANGES:   return pin + " changes";
+        case CircuitNetlist::Watchpoint::Kind::GOES_HIGH: return pin + " goes HIGH";
+        case CircuitNetlist::Watchpoint::Kind::GOES_LOW:  return pin + " goes LOW";
+        case CircuitNetlist::Watchpoint::Kind::EQUALS:
+            return pin + wxString::Format(" equals 0x%llX", static_cast<unsigned long long>(breakpoint.value.bits));
+    }
+    return pin;
+}
@@ -0,0 +1,46 @@
+#include "../../include/core/subcircuit_library.h"
+#include "../../include/core/circuit_document.h"
+#include <wx/filename.h>
+#include <algorithm>
+
+SubcircuitLibrary& SubcircuitLibrary::GetInstance() {
+    static SubcircuitLibrary instance;
+    return instance;
+}
+
+std::shared_ptr<const SubcircuitDefinition> SubcircuitLibrary::Load(const wxString& filepath, wxString& error) {
+    wxFileName file(filepath);
+    file.MakeAbsolute();
+    wxString key = file.GetFullPath();
+
+    auto cached = definitions.find(key);
+    if (cached != definitions.end()) {
+        return cached->second;
+    }
+
+    if (std::find(loading.begin(), loading.end(), key) != loading.end()) {
+        error = wxString::Format("%s contains itself as a subcircuit", file.GetFullName());
+        return nullptr;
+    }
+
+    // Nested subcircuits are loaded while the document is read
+    loading.push_back(key);
+    CircuitDocument document;
+    bool loaded = document.LoadFromFile(key);
+    loading.pop_back();
+
+    if (!loaded) {
+        error = document.GetLastError().IsEmpty() ? wxString::Format("Cannot load %s", file.GetFullName())
+                                                   : document.GetLastError();
+        return nullptr;
+    }
+
+    auto definition = std::make_shared<const SubcircuitDefinition>(file.GetName(), key, document.ReleaseComponents());
+    if (definition->GetInputCount() == 0 && definition->GetOutputCount() == 0) {
+        error = wxString::Format("%s has no input switches or output LEDs to use as pins", file.GetFullName());
+        return nullptr;
+    }
+
+    definitions[key] = definition;
+    return definition;
+}
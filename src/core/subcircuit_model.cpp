@@ -0,0 +1,162 @@
+#include "../../include/core/subcircuit_model.h"
+#include "../../include/core/circuit_netlist.h"
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/components/io_components.h"
+#include <algorithm>
+
+namespace {
+
+// Lane patterns of the six lowest input bits within a 64-row block
+const uint64_t LOW_BIT_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull,
+    0xCCCCCCCCCCCCCCCCull,
+    0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull,
+    0xFFFF0000FFFF0000ull,
+    0xFFFFFFFF00000000ull
+};
+
+} // namespace
+
+SubcircuitCache::SubcircuitCache(size_t maxEntries) : capacity(maxEntries) {
+}
+
+bool SubcircuitCache::Find(uint64_t key, uint64_t& value) {
+    auto it = index.find(key);
+    if (it == index.end()) return false;
+
+    // Move to the front so it is evicted last
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->value;
+    return true;
+}
+
+void SubcircuitCache::Insert(uint64_t key, uint64_t value) {
+    if (capacity == 0) return;
+
+    if (index.size() >= capacity) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+
+    Entry entry = { key, value };
+    entries.push_front(entry);
+    index[key] = entries.begin();
+}
+
+void SubcircuitCache::Clear() {
+    entries.clear();
+    index.clear();
+}
+
+const size_t SubcircuitModel::MAX_PORTS;
+
+SubcircuitModel::SubcircuitModel(std::shared_ptr<const SubcircuitDefinition> def, std::unique_ptr<CircuitNetlist> compiled,
+                                 size_t cacheEntries, size_t maxTableInputs)
+    : definition(std::move(def)), netlist(std::move(compiled)), cache(cacheEntries), hits(0), misses(0) {
+
+    for (size_t i = 0; i < definition->GetInputCount(); ++i) {
+        inputNets.push_back(netlist->GetOutputNet(netlist->FindNode(definition->GetInputPort(i)), 0));
+    }
+    for (size_t o = 0; o < definition->GetOutputCount(); ++o) {
+        outputNets.push_back(netlist->GetInputNet(netlist->FindNode(definition->GetOutputPort(o)), 0));
+    }
+
+    netlist->Reset();
+    netlist->Settle();
+
+    if (inputNets.size() <= maxTableInputs) {
+        BuildTable();
+    }
+}
+
+SubcircuitModel::~SubcircuitModel() {
+}
+
+bool SubcircuitModel::IsEligible(const SubcircuitDefinition& def, const CircuitNetlist& compiled) {
+    if (def.GetInputCount() > MAX_PORTS || def.GetOutputCount() > MAX_PORTS) return false;
+    if (!compiled.IsCombinational() || compiled.HasBuses()) return false;
+
+    // Clocks and other free-running sources make the outputs depend on more than the pins
+    for (size_t n = 0; n < compiled.GetNodeCount(); ++n) {
+        const CircuitNetlist::Node& node = compiled.GetNode(n);
+        if (node.op == CircuitNetlist::NodeOp::SOURCE && node.component->GetType() != ComponentType::INPUT_PIN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t SubcircuitModel::Evaluate(uint64_t high, uint64_t undefined) {
+    if (undefined == 0 && !table.empty()) {
+        ++hits;
+        return table[high];
+    }
+
+    uint64_t key = high | (undefined << 32);
+    uint64_t outputs;
+    if (cache.Find(key, outputs)) {
+        ++hits;
+        return outputs;
+    }
+
+    ++misses;
+    outputs = Simulate(high, undefined);
+    cache.Insert(key, outputs);
+    return outputs;
+}
+
+uint64_t SubcircuitModel::Simulate(uint64_t high, uint64_t undefined) {
+    for (size_t i = 0; i < inputNets.size(); ++i) {
+        uint64_t bit = uint64_t(1) << i;
+        netlist->SetNetValue(inputNets[i], (undefined & bit) ? LogicValue::UNDEFINED
+                                         : (high & bit) ? LogicValue::HIGH : LogicValue::LOW);
+    }
+    netlist->Settle();
+
+    uint64_t outputs = 0;
+    for (size_t o = 0; o < outputNets.size(); ++o) {
+        LogicValue value = netlist->GetNetValue(outputNets[o]);
+        if (value == LogicValue::HIGH) {
+            outputs |= uint64_t(1) << o;
+        } else if (value == LogicValue::UNDEFINED) {
+            outputs |= uint64_t(1) << (o + 32);
+        }
+    }
+    return outputs;
+}
+
+void SubcircuitModel::BuildTable() {
+    // Same 64-rows-per-pass evaluation as the truth table
+    const size_t inputCount = inputNets.size();
+    const size_t rowCount = size_t(1) << inputCount;
+    table.assign(rowCount, 0);
+
+    std::vector<CircuitNetlist::LaneWord> words;
+    netlist->ResetParallel(words);
+
+    for (size_t block = 0; block * 64 < rowCount; ++block) {
+        // Input i is bit i of the row number
+        for (size_t i = 0; i < inputCount; ++i) {
+            uint64_t pattern = i < 6 ? LOW_BIT_PATTERNS[i]
+                             : ((block >> (i - 6)) & 1) ? ~uint64_t(0) : 0;
+            CircuitNetlist::LaneWord& word = words[inputNets[i]];
+            word.high = pattern;
+            word.undefined = 0;
+        }
+
+        netlist->EvaluateParallel(words);
+
+        size_t lanes = std::min<size_t>(64, rowCount - block * 64);
+        for (size_t o = 0; o < outputNets.size(); ++o) {
+            const CircuitNetlist::LaneWord& word = words[outputNets[o]];
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                if ((word.undefined >> lane) & 1) {
+                    table[block * 64 + lane] |= uint64_t(1) << (o + 32);
+                } else if ((word.high >> lane) & 1) {
+                    table[block * 64 + lane] |= uint64_t(1) << o;
+                }
+            }
+        }
+    }
+}
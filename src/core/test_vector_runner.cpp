@@ -0,0 +1,241 @@
+#include "../../include/core/test_vector_runner.h"
+#include <wx/wfstream.h>
+#include <wx/txtstrm.h>
+#include <algorithm>
+
+namespace {
+
+LogicValue CellToLogicValue(uint8_t cell) {
+    switch (cell) {
+        case TestVectorRunner::CELL_LOW:  return LogicValue::LOW;
+        case TestVectorRunner::CELL_HIGH: return LogicValue::HIGH;
+        default:                          return LogicValue::UNDEFINED;
+    }
+}
+
+const char* LogicValueName(LogicValue value) {
+    switch (value) {
+        case LogicValue::LOW:  return "0";
+        case LogicValue::HIGH: return "1";
+        default:               return "X";
+    }
+}
+
+} // namespace
+
+const uint8_t TestVectorRunner::CELL_LOW;
+const uint8_t TestVectorRunner::CELL_HIGH;
+const uint8_t TestVectorRunner::CELL_X;
+
+wxString TestVectorReport::Format(size_t maxLines) const {
+    wxString text = wxString::Format("%zu vector(s) run, %zu failed", vectorsRun, vectorsFailed);
+    if (unstableVectors > 0) {
+        text += wxString::Format(", %zu did not settle", unstableVectors);
+    }
+    text += "\n";
+
+    size_t shown = std::min(maxLines, mismatches.size());
+    for (size_t i = 0; i < shown; ++i) {
+        const TestVectorMismatch& mismatch = mismatches[i];
+        text += wxString::Format("line %zu: %s expected %s, got %s\n",
+                                 mismatch.line, mismatch.signal,
+                                 LogicValueName(mismatch.expected), LogicValueName(mismatch.actual));
+    }
+    if (mismatchCount > shown) {
+        text += wxString::Format("... %zu more mismatch(es)\n", mismatchCount - shown);
+    }
+
+    return text;
+}
+
+TestVectorRunner::TestVectorRunner() {
+}
+
+bool TestVectorRunner::LoadFromFile(const wxString& filepath) {
+    if (!wxFileExists(filepath)) {
+        lastError = wxString::Format("File not found: %s", filepath);
+        return false;
+    }
+
+    wxFileInputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        lastError = wxString::Format("Cannot open %s", filepath);
+        return false;
+    }
+
+    columns.clear();
+    cells.clear();
+    lineNumbers.clear();
+    lastError.Clear();
+
+    wxTextInputStream textStream(fileStream);
+    size_t lineNumber = 0;
+    while (!fileStream.Eof()) {
+        wxString line = textStream.ReadLine();
+        if (!ParseLine(line, ++lineNumber)) {
+            return false;
+        }
+    }
+
+    if (columns.empty()) {
+        lastError = "No header line with signal names";
+        return false;
+    }
+    return true;
+}
+
+bool TestVectorRunner::LoadFromString(const wxString& text) {
+    columns.clear();
+    cells.clear();
+    lineNumbers.clear();
+    lastError.Clear();
+
+    size_t lineNumber = 0;
+    size_t start = 0;
+    while (start <= text.length()) {
+        size_t end = text.find('\n', start);
+        if (end == wxString::npos) end = text.length();
+
+        if (!ParseLine(text.substr(start, end - start), ++lineNumber)) {
+            return false;
+        }
+        start = end + 1;
+    }
+
+    if (columns.empty()) {
+        lastError = "No header line with signal names";
+        return false;
+    }
+    return true;
+}
+
+void TestVectorRunner::SplitFields(const wxString& line, std::vector<wxString>& fields) {
+    fields.clear();
+
+    wxString field;
+    for (wxUniChar ch : line) {
+        if (ch == ',' || ch == ';' || ch == ' ' || ch == '\t' || ch == '\r') {
+            if (!field.IsEmpty()) {
+                fields.push_back(field);
+                field.Clear();
+            }
+        } else {
+            field += ch;
+        }
+    }
+    if (!field.IsEmpty()) {
+        fields.push_back(field);
+    }
+}
+
+bool TestVectorRunner::ParseLine(const wxString& line, size_t lineNumber) {
+    // Strip comments
+    wxString content = line;
+    int comment = content.Find('#');
+    if (comment != wxNOT_FOUND) {
+        content.Truncate(comment);
+    }
+
+    std::vector<wxString> fields;
+    SplitFields(content, fields);
+    if (fields.empty()) return true;
+
+    // The first non-empty line is the header
+    if (columns.empty()) {
+        columns = fields;
+        return true;
+    }
+
+    if (fields.size() != columns.size()) {
+        lastError = wxString::Format("Line %zu: expected %zu values, found %zu",
+                                     lineNumber, columns.size(), fields.size());
+        return false;
+    }
+
+    for (const wxString& field : fields) {
+        if (field == "0") {
+            cells.push_back(CELL_LOW);
+        } else if (field == "1") {
+            cells.push_back(CELL_HIGH);
+        } else if (field == "x" || field == "X" || field == "-") {
+            cells.push_back(CELL_X);
+        } else {
+            lastError = wxString::Format("Line %zu: invalid value '%s'", lineNumber, field);
+            return false;
+        }
+    }
+    lineNumbers.push_back(lineNumber);
+    return true;
+}
+
+bool TestVectorRunner::Run(CircuitNetlist& netlist, TestVectorReport& report, size_t maxMismatches) {
+    report = TestVectorReport();
+
+    // Resolve every column to a switch or an LED once, before the first row
+    std::vector<size_t> inputColumns;
+    std::vector<uint32_t> inputNets;
+    std::vector<size_t> outputColumns;
+    std::vector<uint32_t> outputNets;
+
+    for (size_t c = 0; c < columns.size(); ++c) {
+        int node = netlist.FindInput(columns[c]);
+        if (node >= 0) {
+            inputColumns.push_back(c);
+            inputNets.push_back(netlist.GetOutputNet(node, 0));
+            continue;
+        }
+
+        node = netlist.FindOutput(columns[c]);
+        if (node >= 0) {
+            outputColumns.push_back(c);
+            outputNets.push_back(netlist.GetInputNet(node, 0));
+            continue;
+        }
+
+        lastError = wxString::Format("No input switch or output LED labeled '%s'", columns[c]);
+        return false;
+    }
+
+    netlist.Reset();
+    netlist.Settle();
+
+    const size_t width = columns.size();
+    for (size_t row = 0; row < lineNumbers.size(); ++row) {
+        const uint8_t* values = cells.data() + row * width;
+
+        // Only inputs that differ from the previous row schedule any work
+        for (size_t i = 0; i < inputColumns.size(); ++i) {
+            netlist.SetNetValue(inputNets[i], CellToLogicValue(values[inputColumns[i]]));
+        }
+
+        if (!netlist.Settle()) {
+            report.unstableVectors++;
+        }
+        report.vectorsRun++;
+
+        bool failed = false;
+        for (size_t o = 0; o < outputColumns.size(); ++o) {
+            uint8_t expected = values[outputColumns[o]];
+            if (expected == CELL_X) continue;
+
+            LogicValue actual = netlist.GetNetValue(outputNets[o]);
+            if (actual != CellToLogicValue(expected)) {
+                failed = true;
+                report.mismatchCount++;
+                if (report.mismatches.size() < maxMismatches) {
+                    TestVectorMismatch mismatch;
+                    mismatch.line = lineNumbers[row];
+                    mismatch.signal = columns[outputColumns[o]];
+                    mismatch.expected = CellToLogicValue(expected);
+                    mismatch.actual = actual;
+                    report.mismatches.push_back(mismatch);
+                }
+            }
+        }
+        if (failed) {
+            report.vectorsFailed++;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,157 @@
+#include "../../include/core/timing_analysis.h"
+#include "../../include/components/subcircuit_component.h"
+#include <algorithm>
+
+namespace {
+
+uint64_t NodeDelay(const CircuitNetlist::Node& node) {
+    return std::max(node.delay.rise, node.delay.fall);
+}
+
+} // namespace
+
+const uint32_t TimingAnalysis::NO_NODE;
+
+TimingAnalysis::TimingAnalysis() : brokenLoops(false) {
+}
+
+void TimingAnalysis::Clear() {
+    netArrival.clear();
+    netDriver.clear();
+    paths.clear();
+    brokenLoops = false;
+}
+
+bool TimingAnalysis::IsStartPoint(const CircuitNetlist::Node& node) {
+    return node.op == CircuitNetlist::NodeOp::SOURCE || node.op == CircuitNetlist::NodeOp::SEQUENTIAL;
+}
+
+void TimingAnalysis::Analyze(const CircuitNetlist& netlist, size_t pathCount) {
+    Clear();
+
+    size_t netCount = netlist.GetNetCount();
+    netArrival.assign(netCount, 0);
+    netDriver.assign(netCount, NO_NODE);
+    std::vector<uint8_t> ready(netCount, 0);
+
+    // Sources drive at time 0, nets nobody drives count as ready
+    for (uint32_t n = 0; n < netlist.GetNodeCount(); ++n) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+        if (node.op == CircuitNetlist::NodeOp::SINK || node.op == CircuitNetlist::NodeOp::SUBCIRCUIT ||
+            node.op == CircuitNetlist::NodeOp::REMOVED) continue;
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            netDriver[netlist.GetOutputNet(n, o)] = n;
+        }
+    }
+    for (size_t net = 0; net < netCount; ++net) {
+        uint32_t driver = netDriver[net];
+        if (driver == NO_NODE || netlist.GetNode(driver).op == CircuitNetlist::NodeOp::SOURCE) {
+            ready[net] = 1;
+        }
+    }
+
+    // One pass in level order; nodes on loops come last and see partial arrivals
+    for (uint32_t n : netlist.GetLevelOrder()) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+        uint64_t arrival = NodeDelay(node);
+        if (node.op != CircuitNetlist::NodeOp::SEQUENTIAL) {
+            uint64_t latest = 0;
+            for (uint32_t i = 0; i < node.inputCount; ++i) {
+                uint32_t net = netlist.GetInputNet(n, i);
+                brokenLoops = brokenLoops || !ready[net];
+                latest = std::max(latest, netArrival[net]);
+            }
+            arrival += latest;
+        }
+
+        for (uint32_t o = 0; o < node.outputCount; ++o) {
+            uint32_t net = netlist.GetOutputNet(n, o);
+            netArrival[net] = std::max(netArrival[net], arrival);
+            ready[net] = 1;
+        }
+    }
+
+    // End points: top level sinks and the data inputs of flip-flops
+    std::vector<std::pair<uint64_t, uint32_t>> endPoints;
+    for (uint32_t n = 0; n < netlist.GetNodeCount(); ++n) {
+        const CircuitNetlist::Node& node = netlist.GetNode(n);
+        bool isEnd = (node.op == CircuitNetlist::NodeOp::SINK && node.instance == 0) ||
+                     node.op == CircuitNetlist::NodeOp::SEQUENTIAL;
+        if (!isEnd || node.inputCount == 0) continue;
+
+        endPoints.emplace_back(netArrival[netlist.GetInputNet(n, WorstInput(netlist, n))], n);
+    }
+
+    size_t count = std::min(pathCount, endPoints.size());
+    std::partial_sort(endPoints.begin(), endPoints.begin() + count, endPoints.end(),
+                      [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                          return a.first > b.first;
+                      });
+
+    // Walk back along the latest input of every node
+    for (size_t p = 0; p < count; ++p) {
+        Path path;
+        path.arrival = endPoints[p].first;
+        uint32_t n = endPoints[p].second;
+        path.nodes.push_back(n);
+
+        while (path.nodes.size() <= netlist.GetNodeCount()) {
+            const CircuitNetlist::Node& node = netlist.GetNode(n);
+            if (node.inputCount == 0) break;
+
+            uint32_t driver = netDriver[netlist.GetInputNet(n, WorstInput(netlist, n))];
+            if (driver == NO_NODE) break;
+            path.nodes.push_back(driver);
+            if (IsStartPoint(netlist.GetNode(driver))) break;
+            n = driver;
+        }
+
+        std::reverse(path.nodes.begin(), path.nodes.end());
+        paths.push_back(path);
+    }
+}
+
+uint32_t TimingAnalysis::WorstInput(const CircuitNetlist& netlist, uint32_t node) const {
+    const CircuitNetlist::Node& entry = netlist.GetNode(node);
+    uint32_t worst = 0;
+    for (uint32_t i = 1; i < entry.inputCount; ++i) {
+        if (netArrival[netlist.GetInputNet(node, i)] > netArrival[netlist.GetInputNet(node, worst)]) {
+            worst = i;
+        }
+    }
+    return worst;
+}
+
+wxString TimingAnalysis::Format(const CircuitNetlist& netlist) const {
+    if (paths.empty()) return "No timing end points in the circuit.\n";
+
+    wxString text = wxString::Format("Critical delay: %llu\n", static_cast<unsigned long long>(GetCriticalDelay()));
+    if (brokenLoops) {
+        text += "Combinational loops were cut, their arrival times are lower bounds.\n";
+    }
+
+    for (size_t p = 0; p < paths.size(); ++p) {
+        const Path& path = paths[p];
+        text += wxString::Format("\nPath %zu, arrival %llu:\n", p + 1, static_cast<unsigned long long>(path.arrival));
+        for (size_t i = 0; i < path.nodes.size(); ++i) {
+            uint32_t n = path.nodes[i];
+            const CircuitNetlist::Node& node = netlist.GetNode(n);
+
+            // End points show when their input arrives, others when their output does
+            uint64_t arrival = (i + 1 == path.nodes.size() || node.outputCount == 0)
+                             ? path.arrival : netArrival[netlist.GetOutputNet(n, 0)];
+            text += wxString::Format("  %6llu  %s\n", static_cast<unsigned long long>(arrival), netlist.DescribeNode(n));
+        }
+    }
+    return text;
+}
+
+const CircuitComponent* TimingAnalysis::GetTopLevelComponent(const CircuitNetlist& netlist, uint32_t node) {
+    uint32_t instance = netlist.GetNode(node).instance;
+    if (instance == 0) return netlist.GetNode(node).component;
+
+    while (netlist.GetInstance(instance).parent != 0) {
+        instance = netlist.GetInstance(instance).parent;
+    }
+    return netlist.GetInstance(instance).component;
+}
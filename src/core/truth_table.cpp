@@ -0,0 +1,197 @@
+#include "../../include/core/truth_table.h"
+#include "../../include/components/io_components.h"
+#include <wx/wfstream.h>
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// Lane patterns of the six lowest row bits within a 64-row block
+const uint64_t LOW_BIT_PATTERNS[6] = {
+    0xAAAAAAAAAAAAAAAAull,
+    0xCCCCCCCCCCCCCCCCull,
+    0xF0F0F0F0F0F0F0F0ull,
+    0xFF00FF00FF00FF00ull,
+    0xFFFF0000FFFF0000ull,
+    0xFFFFFFFF00000000ull
+};
+
+// Write in large chunks, a table can have millions of lines
+const size_t CSV_FLUSH_SIZE = 64 * 1024;
+
+} // namespace
+
+const size_t TruthTable::MAX_INPUTS;
+
+TruthTable::TruthTable() : rowCount(0), wordsPerColumn(0) {
+}
+
+void TruthTable::Clear() {
+    inputNames.clear();
+    outputNames.clear();
+    rowCount = 0;
+    wordsPerColumn = 0;
+    outputHigh.clear();
+    outputUndefined.clear();
+}
+
+bool TruthTable::Generate(CircuitNetlist& netlist, const std::vector<ComponentId>& selection) {
+    Clear();
+    lastError.Clear();
+
+    std::vector<ComponentId> selected(selection);
+    std::sort(selected.begin(), selected.end());
+    auto isSelected = [&](uint32_t n) {
+        return selected.empty() ||
+               std::binary_search(selected.begin(), selected.end(), netlist.GetNode(n).component->GetId());
+    };
+
+    std::vector<uint32_t> inputNodes;
+    std::vector<uint32_t> heldNodes;    // Switches outside the selection
+    for (uint32_t n : netlist.GetInputNodes()) {
+        (isSelected(n) ? inputNodes : heldNodes).push_back(n);
+    }
+    std::vector<uint32_t> outputNodes;
+    for (uint32_t n : netlist.GetOutputNodes()) {
+        if (isSelected(n)) outputNodes.push_back(n);
+    }
+
+    if (inputNodes.empty() || outputNodes.empty()) {
+        lastError = selected.empty() ? "The circuit needs at least one input switch and one output LED"
+                                     : "The selection needs at least one input switch and one output LED";
+        return false;
+    }
+    if (inputNodes.size() > MAX_INPUTS) {
+        lastError = wxString::Format("Too many inputs (%zu), the limit is %zu",
+                                     inputNodes.size(), MAX_INPUTS);
+        return false;
+    }
+    if (!netlist.IsCombinational()) {
+        lastError = "Truth tables need a combinational circuit without flip-flops or feedback loops";
+        return false;
+    }
+    if (netlist.HasBuses()) {
+        lastError = "Truth tables only support single lines, the circuit contains buses";
+        return false;
+    }
+
+    // Column names come from the labels, unlabeled pins get a number
+    std::vector<uint32_t> inputNets;
+    for (size_t i = 0; i < inputNodes.size(); ++i) {
+        const InputSwitch* input = static_cast<const InputSwitch*>(netlist.GetNode(inputNodes[i]).component);
+        inputNames.push_back(input->GetLabel().IsEmpty() ? wxString::Format("in%zu", i) : input->GetLabel());
+        inputNets.push_back(netlist.GetOutputNet(inputNodes[i], 0));
+    }
+
+    std::vector<uint32_t> outputNets;
+    for (size_t o = 0; o < outputNodes.size(); ++o) {
+        const OutputLED* output = static_cast<const OutputLED*>(netlist.GetNode(outputNodes[o]).component);
+        outputNames.push_back(output->GetLabel().IsEmpty() ? wxString::Format("out%zu", o) : output->GetLabel());
+        outputNets.push_back(netlist.GetInputNet(outputNodes[o], 0));
+    }
+
+    const size_t inputCount = inputNames.size();
+    rowCount = size_t(1) << inputCount;
+    wordsPerColumn = (rowCount + 63) / 64;
+    outputHigh.assign(wordsPerColumn * outputNames.size(), 0);
+    outputUndefined.assign(wordsPerColumn * outputNames.size(), 0);
+
+    std::vector<CircuitNetlist::LaneWord> words;
+    netlist.ResetParallel(words);
+    for (uint32_t n : heldNodes) {
+        const InputSwitch* input = static_cast<const InputSwitch*>(netlist.GetNode(n).component);
+        CircuitNetlist::LaneWord& word = words[netlist.GetOutputNet(n, 0)];
+        word.high = input->GetValue() == LogicValue::HIGH ? ~uint64_t(0) : 0;
+        word.undefined = 0;
+    }
+
+    for (size_t block = 0; block < wordsPerColumn; ++block) {
+        // Input i is row bit (inputCount - 1 - i)
+        for (size_t i = 0; i < inputCount; ++i) {
+            size_t bit = inputCount - 1 - i;
+            uint64_t pattern = bit < 6 ? LOW_BIT_PATTERNS[bit]
+                             : ((block >> (bit - 6)) & 1) ? ~uint64_t(0) : 0;
+            CircuitNetlist::LaneWord& word = words[inputNets[i]];
+            word.high = pattern;
+            word.undefined = 0;
+        }
+
+        netlist.EvaluateParallel(words);
+
+        for (size_t o = 0; o < outputNets.size(); ++o) {
+            const CircuitNetlist::LaneWord& word = words[outputNets[o]];
+            outputHigh[o * wordsPerColumn + block] = word.high;
+            outputUndefined[o * wordsPerColumn + block] = word.undefined;
+        }
+    }
+
+    return true;
+}
+
+const wxString& TruthTable::GetColumnName(size_t column) const {
+    return column < inputNames.size() ? inputNames[column] : outputNames[column - inputNames.size()];
+}
+
+bool TruthTable::GetInput(size_t row, size_t input) const {
+    return ((row >> (inputNames.size() - 1 - input)) & 1) != 0;
+}
+
+LogicValue TruthTable::GetOutput(size_t row, size_t output) const {
+    size_t word = output * wordsPerColumn + row / 64;
+    uint64_t bit = uint64_t(1) << (row % 64);
+    if (outputUndefined[word] & bit) return LogicValue::UNDEFINED;
+    return (outputHigh[word] & bit) ? LogicValue::HIGH : LogicValue::LOW;
+}
+
+wxString TruthTable::GetCellText(size_t row, size_t column) const {
+    if (column < inputNames.size()) {
+        return GetInput(row, column) ? "1" : "0";
+    }
+
+    switch (GetOutput(row, column - inputNames.size())) {
+        case LogicValue::LOW:  return "0";
+        case LogicValue::HIGH: return "1";
+        default:               return "X";
+    }
+}
+
+bool TruthTable::WriteCSV(wxOutputStream& stream) const {
+    std::string buffer;
+    const size_t columns = GetColumnCount();
+
+    for (size_t c = 0; c < columns; ++c) {
+        if (c > 0) buffer += ',';
+        buffer += GetColumnName(c).ToStdString();
+    }
+    buffer += '\n';
+
+    for (size_t row = 0; row < rowCount; ++row) {
+        for (size_t i = 0; i < inputNames.size(); ++i) {
+            if (i > 0) buffer += ',';
+            buffer += GetInput(row, i) ? '1' : '0';
+        }
+        for (size_t o = 0; o < outputNames.size(); ++o) {
+            LogicValue value = GetOutput(row, o);
+            buffer += ',';
+            buffer += value == LogicValue::HIGH ? '1' : value == LogicValue::LOW ? '0' : 'X';
+        }
+        buffer += '\n';
+
+        if (buffer.size() >= CSV_FLUSH_SIZE) {
+            stream.Write(buffer.data(), buffer.size());
+            buffer.clear();
+            if (!stream.IsOk()) return false;
+        }
+    }
+
+    stream.Write(buffer.data(), buffer.size());
+    return stream.IsOk();
+}
+
+bool TruthTable::SaveCSV(const wxString& filepath) const {
+    wxFileOutputStream fileStream(filepath);
+    if (!fileStream.IsOk()) {
+        return false;
+    }
+    return WriteCSV(fileStream);
+}
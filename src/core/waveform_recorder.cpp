@@ -0,0 +1,119 @@
+#include "../../include/core/waveform_recorder.h"
+#include <algorithm>
+
+// WaveformTrace implementation
+void WaveformTrace::Record(uint64_t time, const BusValue& value) {
+    // Only transitions are stored
+    if (!values.empty() && values.back().bits == value.bits && values.back().undefined == value.undefined) {
+        return;
+    }
+    times.push_back(time);
+    values.push_back(value);
+}
+
+BusValue WaveformTrace::ValueAt(uint64_t time) const {
+    // Last transition at or before the requested time
+    auto it = std::upper_bound(times.begin(), times.end(), time);
+    if (it == times.begin()) {
+        BusValue undefined = { 0, BusMask(width) };
+        return undefined;
+    }
+    return values[std::distance(times.begin(), it) - 1];
+}
+
+size_t WaveformTrace::LowerBound(uint64_t time, size_t from) const {
+    if (from >= times.size()) {
+        return times.size();
+    }
+    auto it = std::lower_bound(times.begin() + from, times.end(), time);
+    return std::distance(times.begin(), it);
+}
+
+// WaveformRecorder implementation
+WaveformRecorder::WaveformRecorder() : currentTime(0), revision(0) {}
+
+bool WaveformRecorder::AddProbe(const CircuitComponent* component, size_t pinIndex, const wxString& name) {
+    if (!component || pinIndex >= component->GetPins().size()) return false;
+    if (HasProbe(component->GetId(), pinIndex)) return false;
+
+    // The net comes with the next ResolveNets, until then the pin is read
+    std::lock_guard<std::mutex> lock(mutex);
+    traces.emplace_back(component->GetId(), pinIndex, component->GetPins()[pinIndex].width, name);
+    traces.back().component = component;
+    ++revision;
+    return true;
+}
+
+void WaveformRecorder::RemoveProbe(size_t traceIndex) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (traceIndex < traces.size()) {
+        traces.erase(traces.begin() + traceIndex);
+        ++revision;
+    }
+}
+
+void WaveformRecorder::RemoveAllProbes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    traces.clear();
+    currentTime = 0;
+    ++revision;
+}
+
+bool WaveformRecorder::HasProbe(ComponentId componentId, size_t pinIndex) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::any_of(traces.begin(), traces.end(),
+        [componentId, pinIndex](const WaveformTrace& trace) {
+            return trace.componentId == componentId && trace.pinIndex == pinIndex;
+        });
+}
+
+void WaveformRecorder::ResolveNets(const CircuitNetlist& netlist, const ComponentLookup& findComponent) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& trace : traces) {
+        trace.component = findComponent ? findComponent(trace.componentId) : nullptr;
+        trace.net = trace.component ? netlist.FindPinNet(trace.component, trace.pinIndex) : CircuitNetlist::NO_NET;
+    }
+}
+
+void WaveformRecorder::DetachComponent(ComponentId componentId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& trace : traces) {
+        if (trace.componentId == componentId) {
+            trace.net = CircuitNetlist::NO_NET;
+            trace.component = nullptr;
+        }
+    }
+}
+
+void WaveformRecorder::Sample(const CircuitNetlist& netlist) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (traces.empty()) return;
+
+    uint64_t time = currentTime;
+    for (auto& trace : traces) {
+        if (trace.net != CircuitNetlist::NO_NET) {
+            trace.Record(time, netlist.ReadNet(trace.net));
+            continue;
+        }
+        if (trace.component && trace.pinIndex < trace.component->GetPins().size()) {
+            trace.Record(time, ReadBus(trace.component->GetPins()[trace.pinIndex]));
+        } else {
+            // Undefined while the component is not placed
+            BusValue undefined = { 0, BusMask(trace.width) };
+            trace.Record(time, undefined);
+        }
+    }
+
+    currentTime = time + 1;
+    ++revision;
+}
+
+void WaveformRecorder::ClearSamples() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& trace : traces) {
+        trace.times.clear();
+        trace.values.clear();
+    }
+    currentTime = 0;
+    ++revision;
+}
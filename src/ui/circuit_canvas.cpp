@@ -6,13 +6,17 @@
 #include "../../include/components/sequential_components.h"
 #include "../../include/components/decoder_encoder_components.h"
 #include "../../include/components/display_components.h"
+#include "../../include/components/component_factory.h"
 #include "../../include/core/command_system.h"
 #include <wx/dcbuffer.h>
+#include <wx/affinematrix2d.h>
+#include <set>
 #include <cmath>
 #include <algorithm>
 
 // Define custom event
 const wxEventType CircuitCanvas::wxEVT_COMPONENT_SELECTED = wxNewEventType();
+const wxEventType CircuitCanvas::wxEVT_SIMULATION_UPDATED = wxNewEventType();
 
 wxBEGIN_EVENT_TABLE(CircuitCanvas, wxWindow)
     EVT_PAINT(CircuitCanvas::OnPaint)
@@ -34,12 +38,21 @@ wxEND_EVENT_TABLE()
 CircuitCanvas::CircuitCanvas(wxWindow* parent)
     : wxWindow(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize,
               wxFULL_REPAINT_ON_RESIZE | wxWANTS_CHARS),
+      pool(ComponentPool::Create()),
+      nextComponentId(1),
       selectedComponent(nullptr),
       currentTool(ComponentType::SELECT),
       dragStart(0, 0),
       dragStartPos(0, 0),
+      dragOffset(0, 0),
+      dragTarget(0, 0),
+      dragMotionPending(false),
       isDragging(false),
       isPanning(false),
+      isRubberBanding(false),
+      netlistDirty(true),
+      simulation(netlist, this),
+      showCriticalPath(false),
       zoomFactor(1.0),
       panOffset(0, 0),
       showGrid(true),
@@ -51,6 +64,9 @@ CircuitCanvas::CircuitCanvas(wxWindow* parent)
 
     SetBackgroundStyle(wxBG_STYLE_PAINT);
     SetCanFocus(true);
+    simulation.SetRecorder(&waveformRecorder);
+    simulation.SetComponentLookup(GetComponentLookup());
+    timingNetlist.SetSubcircuitCaching(false);
 
     // Set up accelerator table for keyboard shortcuts
     wxAcceleratorEntry entries[5];
@@ -67,6 +83,9 @@ CircuitCanvas::CircuitCanvas(wxWindow* parent)
 void CircuitCanvas::OnPaint(wxPaintEvent& event) {
     wxAutoBufferedPaintDC dc(this);
 
+    // Motion since the last frame moves the selection once, however many events it took
+    ApplyPendingDrag();
+
     // Clear background
     dc.SetBackground(wxBrush(backgroundColor));
     dc.Clear();
@@ -80,15 +99,19 @@ void CircuitCanvas::OnPaint(wxPaintEvent& event) {
         DrawGrid(dc);
     }
 
-    // Draw components
-    DrawComponents(dc);
+    // Draw components; a running worker is writing the pins of blocks it evaluates
+    {
+        std::lock_guard<std::mutex> lock(simulation.GetStateMutex());
+        DrawComponents(dc);
+    }
 
     // Draw current wire being created
     if (currentWire) {
         currentWire->Draw(dc);
     }
 
-    // Draw selection highlight
+    // Draw critical path and selection highlights
+    DrawCriticalPath(dc);
     DrawSelection(dc);
 
     // Reset transformations for UI elements
@@ -102,6 +125,7 @@ void CircuitCanvas::OnPaint(wxPaintEvent& event) {
 }
 
 void CircuitCanvas::OnLeftDown(wxMouseEvent& event) {
+    PauseSimulation(); // Editing needs the circuit to stand still
     SetFocus(); // Ensure canvas can receive keyboard events
     CaptureMouse(); // Capture mouse for proper dragging
 
@@ -129,21 +153,30 @@ void CircuitCanvas::OnLeftDown(wxMouseEvent& event) {
         wxLogDebug("No component clicked at world position (%d,%d)", worldPos.x, worldPos.y);
     }
 
-    // Deselect all components first
-    for (auto& component : components) {
-        component->Select(false);
-    }
+    bool extend = event.ControlDown() || event.ShiftDown();
 
     if (clickedComponent) {
-        // Select the clicked component
-        SelectComponent(clickedComponent);
+        if (currentTool == ComponentType::SELECT && extend) {
+            // Ctrl or Shift click adds the component to the selection or takes it out
+            ToggleSelection(clickedComponent);
+        } else if (currentTool != ComponentType::SELECT || !clickedComponent->IsSelected()) {
+            SelectComponent(clickedComponent);
+        } else if (clickedComponent != selectedComponent) {
+            // Grabbing one of several selected components keeps them all and makes it primary
+            std::vector<CircuitComponent*> reordered = selection;
+            reordered.erase(std::find(reordered.begin(), reordered.end(), clickedComponent));
+            reordered.push_back(clickedComponent);
+            SetSelection(reordered);
+        }
 
         // Handle different tools
-        if (currentTool == ComponentType::SELECT) {
-            // In SELECT mode, always allow dragging the component
+        if (currentTool == ComponentType::SELECT && clickedComponent->IsSelected()) {
+            // In SELECT mode, drag the whole selection along with the clicked component
             // Store original position for undo system
             dragStartPos = selectedComponent->GetPosition();
             dragStart = worldPos; // Store world click position for delta calculation
+            dragOffset = wxPoint(0, 0);
+            dragMotionPending = false;
             isDragging = true;
 
             // Debug output
@@ -156,7 +189,8 @@ void CircuitCanvas::OnLeftDown(wxMouseEvent& event) {
             Pin* pin = selectedComponent->GetPinAt(worldPos);
             if (pin) {
                 // Start creating a wire from this pin
-                currentWire = std::make_unique<Wire>(pin);
+                ComponentPool::Scope scope(pool.get());
+                currentWire = std::make_unique<Wire>(pin, selectedComponent->GetPinPosition(*pin));
                 pin->isConnected = true;
             }
         }
@@ -174,8 +208,15 @@ void CircuitCanvas::OnLeftDown(wxMouseEvent& event) {
             SelectComponent(newComponent);
         }
     } else {
-        // Clicked on empty space - clear selection
-        ClearSelection();
+        // Clicked on empty space - clear selection and, with the select tool, start a rectangle
+        if (!extend) {
+            ClearSelection();
+        }
+        if (currentTool == ComponentType::SELECT) {
+            isRubberBanding = true;
+            rubberBandStart = worldPos;
+            rubberBandEnd = worldPos;
+        }
     }
 
     Refresh();
@@ -190,27 +231,56 @@ void CircuitCanvas::OnLeftUp(wxMouseEvent& event) {
     wxPoint worldPos = ScreenToWorld(screenPos);
 
     if (isDragging && selectedComponent) {
-        // Create a move command for undo/redo support
-        wxPoint currentPos = selectedComponent->GetPosition();
-        if (dragStartPos != currentPos) { // Only create command if component actually moved
-            auto moveCommand = std::make_unique<MoveComponentCommand>(
-                selectedComponent, dragStartPos, currentPos);
+        // Motion not yet painted still counts towards the command
+        dragTarget = worldPos;
+        dragMotionPending = true;
+        ApplyPendingDrag();
+
+        // One command for the whole selection, holding the offset it was dragged by
+        if (dragOffset != wxPoint(0, 0)) { // Only create command if the selection actually moved
+            auto moveCommand = std::make_unique<MoveComponentsCommand>(this, selection, dragOffset);
             commandManager.ExecuteCommand(std::move(moveCommand));
         }
         isDragging = false;
     }
 
+    if (isRubberBanding) {
+        isRubberBanding = false;
+        wxPoint topLeft(std::min(rubberBandStart.x, worldPos.x), std::min(rubberBandStart.y, worldPos.y));
+        wxPoint bottomRight(std::max(rubberBandStart.x, worldPos.x), std::max(rubberBandStart.y, worldPos.y));
+        if (topLeft != bottomRight) {
+            SelectInRectangle(wxRect(topLeft, wxSize(bottomRight.x - topLeft.x, bottomRight.y - topLeft.y)),
+                              event.ControlDown() || event.ShiftDown());
+        }
+    }
+
     if (currentWire) {
         // Check if we're connecting to another pin
         bool connected = false;
         for (auto& component : components) {
             Pin* pin = component->GetPinAt(worldPos);
             if (pin && pin != currentWire->GetStartPin()) {
+                // Buses only connect to pins of the same width
+                if (pin->width != currentWire->GetStartPin()->width) {
+                    wxWindow* parent = GetParent();
+                    while (parent && !wxDynamicCast(parent, wxFrame)) {
+                        parent = parent->GetParent();
+                    }
+                    wxFrame* frame = parent ? wxDynamicCast(parent, wxFrame) : nullptr;
+                    if (frame && frame->GetStatusBar()) {
+                        frame->SetStatusText(wxString::Format("Cannot connect a %d-bit pin to a %d-bit pin",
+                                                              currentWire->GetStartPin()->width, pin->width), 0);
+                    }
+                    break;
+                }
+
                 // Connect the wire to this pin
-                currentWire->SetEndPin(pin);
+                currentWire->SetEndPin(pin, component->GetPinPosition(*pin));
                 pin->isConnected = true;
                 connected = true;
+                RegisterComponent(currentWire.get());
                 components.push_back(std::move(currentWire));
+                netlistDirty = true;
                 break;
             }
         }
@@ -226,19 +296,30 @@ void CircuitCanvas::OnLeftUp(wxMouseEvent& event) {
     Refresh();
 }
 
+void CircuitCanvas::ApplyPendingDrag() {
+    if (!dragMotionPending) return;
+    dragMotionPending = false;
+    if (!isDragging || !selectedComponent) return;
+
+    // The offset is taken from the drag start, so skipped events lose nothing
+    wxPoint targetPos = dragStartPos + (dragTarget - dragStart);
+    if (snapToGrid) {
+        targetPos = SnapToGrid(targetPos);
+    }
+
+    wxPoint moveOffset = targetPos - dragStartPos - dragOffset;
+    if (moveOffset.x != 0 || moveOffset.y != 0) {
+        for (CircuitComponent* component : selection) {
+            component->Move(moveOffset);
+        }
+        dragOffset += moveOffset;
+    }
+}
+
 void CircuitCanvas::OnMouseMove(wxMouseEvent& event) {
     wxPoint screenPos = event.GetPosition();
     wxPoint worldPos = ScreenToWorld(screenPos);
 
-    // Debug output for mouse move
-    static int debugCounter = 0;
-    if (++debugCounter % 10 == 0) { // Only print every 10th move to avoid spam
-        wxLogDebug("OnMouseMove: isPanning=%s, isDragging=%s, selectedComponent=%s",
-                  isPanning ? "true" : "false",
-                  isDragging ? "true" : "false",
-                  selectedComponent ? "valid" : "null");
-    }
-
     if (isPanning) {
         // Pan the view
         wxPoint delta = screenPos - lastPanPoint;
@@ -249,32 +330,19 @@ void CircuitCanvas::OnMouseMove(wxMouseEvent& event) {
     }
 
     if (isDragging && selectedComponent) {
-        // Calculate the total offset from the original drag start position
-        wxPoint totalOffset = worldPos - dragStart;
-        wxPoint targetPos = dragStartPos + totalOffset;
-
-        // Apply grid snapping if enabled
-        if (snapToGrid) {
-            targetPos = SnapToGrid(targetPos);
-        }
-
-        // Calculate the offset needed to reach the target position
-        wxPoint currentPos = selectedComponent->GetPosition();
-        wxPoint moveOffset = targetPos - currentPos;
-
-        // Debug output
-        wxLogDebug("Dragging: worldPos=(%d,%d), dragStart=(%d,%d), dragStartPos=(%d,%d), totalOffset=(%d,%d), targetPos=(%d,%d), currentPos=(%d,%d), moveOffset=(%d,%d)",
-                  worldPos.x, worldPos.y, dragStart.x, dragStart.y, dragStartPos.x, dragStartPos.y,
-                  totalOffset.x, totalOffset.y, targetPos.x, targetPos.y, currentPos.x, currentPos.y, moveOffset.x, moveOffset.y);
-
-        // Move the component by the calculated offset
-        if (moveOffset.x != 0 || moveOffset.y != 0) {
-            selectedComponent->Move(moveOffset);
-            wxLogDebug("Component moved by offset (%d,%d)", moveOffset.x, moveOffset.y);
+        // Only the pointer is recorded here; the next paint moves the selection
+        dragTarget = worldPos;
+        if (!dragMotionPending) {
+            dragMotionPending = true;
             Refresh();
         }
     }
 
+    if (isRubberBanding) {
+        rubberBandEnd = worldPos;
+        Refresh();
+    }
+
     if (currentWire) {
         // Update the end point of the wire being created
         currentWire->AddPoint(worldPos);
@@ -306,7 +374,9 @@ void CircuitCanvas::SetTool(ComponentType tool) {
     // Reset ongoing operations when tool changes, but only if it's actually changing
     if (oldTool != tool) {
         isDragging = false;
+        dragMotionPending = false;
         isPanning = false;
+        isRubberBanding = false;
         // Only clear selection if switching away from SELECT tool
         if (oldTool == ComponentType::SELECT && tool != ComponentType::SELECT) {
             ClearSelection();
@@ -318,153 +388,208 @@ void CircuitCanvas::SetTool(ComponentType tool) {
 }
 
 CircuitComponent* CircuitCanvas::CreateComponent(ComponentType type, const wxPoint& pos) {
-    switch (type) {
-        case ComponentType::AND_GATE:
-            return new AndGate(pos);
-        case ComponentType::OR_GATE:
-            return new OrGate(pos);
-        case ComponentType::NOT_GATE:
-            return new NotGate(pos);
-        case ComponentType::NAND_GATE:
-            return new NandGate(pos);
-        case ComponentType::NOR_GATE:
-            return new NorGate(pos);
-        case ComponentType::XOR_GATE:
-            return new XorGate(pos);
-        case ComponentType::XNOR_GATE:
-            return new XnorGate(pos);
-        case ComponentType::INPUT_PIN:
-            return new InputSwitch(pos);
-        case ComponentType::OUTPUT_PIN:
-            return new OutputLED(pos);
-        case ComponentType::HALF_ADDER:
-            return new HalfAdder(pos);
-        case ComponentType::FULL_ADDER:
-            return new FullAdder(pos);
-        case ComponentType::ADDER_4BIT:
-            return new Adder4Bit(pos);
-        case ComponentType::MULTIPLEXER_2TO1:
-            return new Multiplexer2to1(pos);
-        case ComponentType::MULTIPLEXER_4TO1:
-            return new Multiplexer4to1(pos);
-        case ComponentType::DEMULTIPLEXER_1TO2:
-            return new Demultiplexer1to2(pos);
-        case ComponentType::DEMULTIPLEXER_1TO4:
-            return new Demultiplexer1to4(pos);
-        // Sequential Logic Components
-        case ComponentType::D_FLIPFLOP:
-            return new DFlipFlop(pos);
-        case ComponentType::JK_FLIPFLOP:
-            return new JKFlipFlop(pos);
-        case ComponentType::SR_LATCH:
-            return new SRLatch(pos);
-        case ComponentType::CLOCK_GENERATOR:
-            return new ClockGenerator(pos);
-        // Encoder/Decoder components
-        case ComponentType::DECODER_3TO8:
-            return new Decoder3to8(pos);
-        case ComponentType::BCD_TO_7SEGMENT:
-            return new BCDTo7SegmentDecoder(pos);
-        case ComponentType::PRIORITY_ENCODER:
-            return new PriorityEncoder8to3(pos);
-        // Display Components
-        case ComponentType::SEVEN_SEGMENT_DISPLAY:
-            return new SevenSegmentDisplay(pos);
-        case ComponentType::LED_MATRIX_8X8:
-            return new LEDMatrix8x8(pos);
-        case ComponentType::HEX_DISPLAY:
-            return new HexDisplay(pos);
-        case ComponentType::BINARY_DISPLAY:
-            return new BinaryDisplay8Bit(pos);
+    ComponentPool::Scope scope(pool.get());
+    return ComponentFactory::Create(type, pos);
+}
 
-        default:
-            return nullptr;
+void CircuitCanvas::PrepareNetlist() {
+    // Recompile only when components or wires were added or removed.
+    // Otherwise only changed inputs propagate, so flip-flops see real edges.
+    if (netlistDirty) {
+        netlist.Build(components);
+        netlist.Reset();
+        simulation.ApplyBreakpoints();
+        waveformRecorder.ResolveNets(netlist, GetComponentLookup());
+        simulation.ResetCycleCount();
+        netlistDirty = false;
+
+        if (showCriticalPath) {
+            AnalyzeTiming();
+        }
+    } else {
+        netlist.UpdateSources();
     }
 }
 
 void CircuitCanvas::SimulateCircuit() {
-    // Reset all non-input values
-    for (auto& component : components) {
-        if (component->GetType() != ComponentType::INPUT_PIN) {
-            for (auto& pin : component->GetPins()) {
-                if (pin.isInput) {
-                    pin.value = LogicValue::UNDEFINED;
-                }
-            }
+    // A structural change stops the run, switches may be toggled while it goes on
+    if (netlistDirty) {
+        PauseSimulation();
+    }
+    {
+        std::lock_guard<std::mutex> lock(simulation.GetStateMutex());
+        PrepareNetlist();
+
+        // Subcircuits only simulate through the flattened netlist
+        netlist.Settle();
+        netlist.WriteBack();
+
+        // A run records its own cycles, the edit shows up in the next one
+        if (!simulation.IsRunning()) {
+            waveformRecorder.Sample(netlist);
         }
     }
 
-    // Propagate values through the circuit
-    bool changed = true;
-    while (changed) {
-        changed = false;
+    wxCommandEvent simulationEvent(wxEVT_SIMULATION_UPDATED, GetId());
+    simulationEvent.SetEventObject(this);
+    ProcessEvent(simulationEvent);
+}
 
-        // Process all wires to propagate values
-        for (auto& component : components) {
-            if (component->GetType() == ComponentType::WIRE) {
-                Wire* wire = static_cast<Wire*>(component.get());
-                Pin* startPin = wire->GetStartPin();
-                Pin* endPin = wire->GetEndPin();
-
-                if (startPin && endPin) {
-                    // Propagate from output to input
-                    if (!startPin->isInput && endPin->isInput) {
-                        if (endPin->value != startPin->value) {
-                            endPin->value = startPin->value;
-                            changed = true;
-                        }
-                    }
-                    // Propagate from input to output
-                    else if (startPin->isInput && !endPin->isInput) {
-                        if (startPin->value != endPin->value) {
-                            startPin->value = endPin->value;
-                            changed = true;
-                        }
-                    }
-                }
-            }
+bool CircuitCanvas::RunSimulation(const RunCondition& condition) {
+    if (simulation.IsRunning()) return false;
+
+    PrepareNetlist();
+    netlist.Settle();
+    return simulation.Run(condition);
+}
+
+void CircuitCanvas::PauseSimulation() {
+    simulation.Pause();
+}
+
+SimulationStop CircuitCanvas::StepSimulation(const RunCondition& condition) {
+    PauseSimulation();
+    PrepareNetlist();
+    netlist.Settle();
+
+    SimulationStop stop = simulation.Step(condition);
+    SampleSimulation();
+    return stop;
+}
+
+void CircuitCanvas::SampleSimulation() {
+    // Runs flat out; the display only catches up when sampled. The worker
+    // records the waveforms itself, every cycle.
+    {
+        std::lock_guard<std::mutex> lock(simulation.GetStateMutex());
+        netlist.WriteBack();
+    }
+    Refresh();
+
+    wxCommandEvent simulationEvent(wxEVT_SIMULATION_UPDATED, GetId());
+    simulationEvent.SetEventObject(this);
+    ProcessEvent(simulationEvent);
+}
+
+void CircuitCanvas::AnalyzeTiming() {
+    if (netlistDirty) {
+        SimulateCircuit();
+    }
+    // Delays belong to the gates as drawn, including those inside subcircuits
+    if (NeedsTimingNetlist()) {
+        timingNetlist.Build(components);
+    }
+    const CircuitNetlist& analyzed = GetTimingNetlist();
+    timing.Analyze(analyzed);
+
+    // Highlight the worst path, nodes inside subcircuits show as their instance
+    criticalComponents.clear();
+    criticalWires.clear();
+    if (timing.GetPaths().empty()) return;
+
+    std::set<const CircuitComponent*> onPath;
+    for (uint32_t node : timing.GetPaths()[0].nodes) {
+        const CircuitComponent* component = TimingAnalysis::GetTopLevelComponent(analyzed, node);
+        if (onPath.insert(component).second) {
+            criticalComponents.push_back(component);
         }
+    }
 
-        // Evaluate logic gates
-        for (auto& component : components) {
-            if (auto gate = dynamic_cast<LogicGate*>(component.get())) {
-                LogicValue result = gate->Evaluate();
-
-                // Find the output pin and update its value
-                for (auto& pin : gate->GetPins()) {
-                    if (!pin.isInput && pin.value != result) {
-                        pin.value = result;
-                        changed = true;
-                    }
-                }
-            }
-            // Evaluate arithmetic components
-            else if (auto arithComp = dynamic_cast<ArithmeticComponent*>(component.get())) {
-                // Store old output values to detect changes
-                std::vector<LogicValue> oldOutputs;
-                for (const auto& pin : arithComp->GetPins()) {
-                    if (!pin.isInput) {
-                        oldOutputs.push_back(pin.value);
-                    }
-                }
+    // Wires joining two components of the path
+    std::set<const Pin*> pathPins;
+    for (const CircuitComponent* component : criticalComponents) {
+        for (const Pin& pin : component->GetPins()) {
+            pathPins.insert(&pin);
+        }
+    }
+    for (const auto& component : components) {
+        if (component->GetType() != ComponentType::WIRE) continue;
+        const Wire* wire = static_cast<const Wire*>(component.get());
+        if (pathPins.count(wire->GetStartPin()) && pathPins.count(wire->GetEndPin())) {
+            criticalWires.push_back(wire);
+        }
+    }
+}
+
+void CircuitCanvas::SetShowCriticalPath(bool show) {
+    showCriticalPath = show;
+    if (show) {
+        AnalyzeTiming();
+    }
+    Refresh();
+}
 
-                arithComp->ComputeOutputs();
+void CircuitCanvas::DrawCriticalPath(wxDC& dc) {
+    // Pointers are only good until the next edit recompiles the circuit
+    if (!showCriticalPath || netlistDirty) return;
 
-                // Check if any output changed
-                int outputIndex = 0;
-                for (const auto& pin : arithComp->GetPins()) {
-                    if (!pin.isInput) {
-                        if (outputIndex < oldOutputs.size() && pin.value != oldOutputs[outputIndex]) {
-                            changed = true;
-                        }
-                        outputIndex++;
-                    }
-                }
-            }
+    wxColour pathColour(255, 140, 0);
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.SetPen(wxPen(pathColour, 3));
+    for (const CircuitComponent* component : criticalComponents) {
+        wxPoint pos = component->GetPosition();
+        wxSize size = component->GetEffectiveSize();
+        dc.DrawRoundedRectangle(pos.x - 3, pos.y - 3, size.x + 6, size.y + 6, 4);
+    }
+
+    for (const Wire* wire : criticalWires) {
+        const WireRoute& route = wire->GetPoints();
+        for (size_t i = 1; i < route.size(); ++i) {
+            dc.DrawLine(route[i - 1], route[i]);
         }
     }
 }
 
+void CircuitCanvas::SetTimedMode(bool enabled) {
+    PauseSimulation();
+    netlist.SetTimedMode(enabled);
+    netlistDirty = true;
+}
+
+void CircuitCanvas::SetOptimization(bool enabled) {
+    PauseSimulation();
+    netlist.SetOptimization(enabled);
+    netlistDirty = true;
+}
+
+uint32_t CircuitCanvas::FindPinNet(const CircuitComponent* component, size_t pinIndex) {
+    if (netlistDirty) {
+        SimulateCircuit();
+    }
+    return netlist.FindPinNet(component, pinIndex);
+}
+
+int CircuitCanvas::AddWaveformProbes(CircuitComponent* component) {
+    if (!component || component->GetType() == ComponentType::WIRE) return 0;
+
+    // Probe the outputs, or the inputs of sink components such as LEDs
+    const auto& pins = component->GetPins();
+    bool hasOutputs = std::any_of(pins.begin(), pins.end(),
+                                  [](const Pin& pin) { return !pin.isInput; });
+
+    int added = 0;
+    for (size_t i = 0; i < pins.size(); ++i) {
+        if (pins[i].isInput == hasOutputs) continue;
+
+        wxString name = wxString::Format("(%d,%d) %s%zu",
+                                         component->GetPosition().x, component->GetPosition().y,
+                                         pins[i].isInput ? "in" : "out", i);
+        if (pins[i].width > 1) {
+            name += wxString::Format("[%d]", pins[i].width);
+        }
+        if (waveformRecorder.AddProbe(component, i, name)) {
+            added++;
+        }
+    }
+
+    // New probes need their nets; a dirty netlist resolves them when rebuilt
+    if (added > 0 && !netlistDirty) {
+        waveformRecorder.ResolveNets(netlist, GetComponentLookup());
+    }
+
+    return added;
+}
+
 // New event handlers for enhanced functionality
 void CircuitCanvas::OnMouseWheel(wxMouseEvent& event) {
     int rotation = event.GetWheelRotation();
@@ -497,13 +622,8 @@ void CircuitCanvas::OnKeyDown(wxKeyEvent& event) {
     switch (keyCode) {
         case WXK_DELETE:
         case WXK_BACK:
-            // Delete selected component using command system
-            if (selectedComponent) {
-                auto deleteCommand = std::make_unique<RemoveComponentCommand>(this, selectedComponent);
-                commandManager.ExecuteCommand(std::move(deleteCommand));
-                selectedComponent = nullptr;
-                Refresh();
-            }
+            // Delete the selection using command system
+            DeleteSelection();
             break;
 
         case WXK_ESCAPE:
@@ -518,34 +638,37 @@ void CircuitCanvas::OnKeyDown(wxKeyEvent& event) {
 
         case 'R':
         case 'r':
-            // Rotate selected component
-            if (selectedComponent) {
-                selectedComponent->Rotate(90.0);
-                Refresh();
-            }
+            // Rotate the selection
+            RotateSelection(90.0);
             break;
 
         case WXK_PAGEUP:
-            // Scale up selected component
-            if (selectedComponent) {
-                selectedComponent->Scale(1.25, 1.25);
+            // Scale up the selection
+            if (HasSelection()) {
+                for (CircuitComponent* component : selection) {
+                    component->Scale(1.25, 1.25);
+                }
                 Refresh();
             }
             break;
 
         case WXK_PAGEDOWN:
-            // Scale down selected component
-            if (selectedComponent) {
-                selectedComponent->Scale(0.8, 0.8);
+            // Scale down the selection
+            if (HasSelection()) {
+                for (CircuitComponent* component : selection) {
+                    component->Scale(0.8, 0.8);
+                }
                 Refresh();
             }
             break;
 
         case '1':
             // Reset scale and rotation to default
-            if (selectedComponent) {
-                selectedComponent->SetScale(1.0, 1.0);
-                selectedComponent->SetRotation(0.0);
+            if (HasSelection()) {
+                for (CircuitComponent* component : selection) {
+                    component->SetScale(1.0, 1.0);
+                    component->SetRotation(0.0);
+                }
                 Refresh();
             }
             break;
@@ -565,6 +688,13 @@ void CircuitCanvas::OnKeyDown(wxKeyEvent& event) {
             ResetZoom();
             break;
 
+        case 'A':
+        case 'a':
+            if (event.ControlDown()) {
+                SelectAll();
+            }
+            break;
+
         case 'G':
         case 'g':
             if (event.ControlDown()) {
@@ -631,11 +761,10 @@ void CircuitCanvas::OnRedoCommand(wxCommandEvent& event) {
 }
 
 void CircuitCanvas::OnDeleteCommand(wxCommandEvent& event) {
-    // Delete selected component using command system
-    if (selectedComponent) {
-        auto deleteCommand = std::make_unique<RemoveComponentCommand>(this, selectedComponent);
-        commandManager.ExecuteCommand(std::move(deleteCommand));
-        selectedComponent = nullptr;
+    // Delete the selection using command system
+    if (HasSelection()) {
+        size_t count = selection.size();
+        DeleteSelection();
 
         // Update status bar
         wxWindow* parent = GetParent();
@@ -645,7 +774,8 @@ void CircuitCanvas::OnDeleteCommand(wxCommandEvent& event) {
         if (parent) {
             wxFrame* frame = wxDynamicCast(parent, wxFrame);
             if (frame && frame->GetStatusBar()) {
-                frame->SetStatusText("Component deleted", 0);
+                frame->SetStatusText(count == 1 ? wxString("Component deleted")
+                                                : wxString::Format("%zu components deleted", count), 0);
             }
         }
 
@@ -679,9 +809,7 @@ void CircuitCanvas::FitToWindow() {
     bool first = true;
 
     for (const auto& component : components) {
-        wxPoint pos = component->GetPosition();
-        wxSize size = component->GetSize();
-        wxRect compRect(pos, size);
+        wxRect compRect = component->GetBounds();
 
         if (first) {
             bounds = compRect;
@@ -732,47 +860,111 @@ wxPoint CircuitCanvas::SnapToGrid(const wxPoint& point) const {
 
 // Selection methods
 void CircuitCanvas::SelectComponent(CircuitComponent* component) {
+    std::vector<CircuitComponent*> selected;
+    if (component) {
+        selected.push_back(component);
+    }
+    SetSelection(selected);
+}
+
+void CircuitCanvas::SetSelection(const std::vector<CircuitComponent*>& selected) {
     // Deselect all components
     for (auto& comp : components) {
         comp->Select(false);
     }
 
-    // Select the specified component
-    selectedComponent = component;
-    if (component) {
+    selection = selected;
+    for (CircuitComponent* component : selection) {
         component->Select(true);
+    }
+    selectedComponent = selection.empty() ? nullptr : selection.back();
 
-        // Debug: Update parent window's status bar if available
-        wxWindow* parent = GetParent();
-        while (parent && !wxDynamicCast(parent, wxFrame)) {
-            parent = parent->GetParent();
-        }
-        if (parent) {
-            wxFrame* frame = wxDynamicCast(parent, wxFrame);
-            if (frame && frame->GetStatusBar()) {
-                frame->SetStatusText(wxString::Format("Selected: Component at (%d, %d)",
-                                                    component->GetPosition().x,
-                                                    component->GetPosition().y), 0);
+    NotifySelectionChanged();
+}
+
+void CircuitCanvas::ToggleSelection(CircuitComponent* component) {
+    std::vector<CircuitComponent*> selected = selection;
+    auto it = std::find(selected.begin(), selected.end(), component);
+    if (it != selected.end()) {
+        selected.erase(it);
+    } else {
+        selected.push_back(component);
+    }
+    SetSelection(selected);
+}
+
+void CircuitCanvas::SelectAll() {
+    std::vector<CircuitComponent*> selected;
+    selected.reserve(components.size());
+    for (const auto& component : components) {
+        selected.push_back(component.get());
+    }
+    SetSelection(selected);
+}
+
+void CircuitCanvas::SelectInRectangle(const wxRect& rect, bool add) {
+    std::vector<CircuitComponent*> selected;
+    if (add) {
+        selected = selection;
+    }
+
+    // There is no spatial index; one pass over the bounds is cheap next to repainting them
+    for (const auto& component : components) {
+        if (component->IsSelected()) continue;
+        bool inside = true;
+        if (component->GetType() == ComponentType::WIRE) {
+            for (const wxPoint& point : static_cast<const Wire*>(component.get())->GetPoints()) {
+                inside = inside && rect.Contains(point);
             }
+        } else {
+            inside = rect.Contains(component->GetBounds());
         }
-    } else {
-        // Clear status when no component selected
-        wxWindow* parent = GetParent();
-        while (parent && !wxDynamicCast(parent, wxFrame)) {
-            parent = parent->GetParent();
+        if (inside) {
+            selected.push_back(component.get());
         }
-        if (parent) {
-            wxFrame* frame = wxDynamicCast(parent, wxFrame);
-            if (frame && frame->GetStatusBar()) {
-                frame->SetStatusText("No component selected", 0);
-            }
+    }
+    SetSelection(selected);
+}
+
+void CircuitCanvas::DeleteSelection() {
+    if (selection.empty()) return;
+
+    auto deleteCommand = std::make_unique<RemoveComponentsCommand>(this, selection);
+    commandManager.ExecuteCommand(std::move(deleteCommand));
+    ClearSelection();
+}
+
+void CircuitCanvas::RotateSelection(double degrees) {
+    if (selection.empty()) return;
+
+    auto rotateCommand = std::make_unique<RotateComponentsCommand>(this, selection, degrees);
+    commandManager.ExecuteCommand(std::move(rotateCommand));
+    Refresh();
+}
+
+void CircuitCanvas::NotifySelectionChanged() {
+    wxWindow* parent = GetParent();
+    while (parent && !wxDynamicCast(parent, wxFrame)) {
+        parent = parent->GetParent();
+    }
+    wxFrame* frame = parent ? wxDynamicCast(parent, wxFrame) : nullptr;
+    if (frame && frame->GetStatusBar()) {
+        if (selection.size() > 1) {
+            frame->SetStatusText(wxString::Format("%zu components selected", selection.size()), 0);
+        } else if (selectedComponent) {
+            frame->SetStatusText(wxString::Format("Selected: Component at (%d, %d)",
+                                                selectedComponent->GetPosition().x,
+                                                selectedComponent->GetPosition().y), 0);
+        } else {
+            // Clear status when no component selected
+            frame->SetStatusText("No component selected", 0);
         }
     }
 
-    // Send selection event
+    // Send selection event; the properties show the primary component
     wxCommandEvent selectionEvent(wxEVT_COMPONENT_SELECTED, GetId());
     selectionEvent.SetEventObject(this);
-    selectionEvent.SetClientData(component);
+    selectionEvent.SetClientData(selectedComponent);
     ProcessEvent(selectionEvent);
 
     Refresh();
@@ -810,15 +1002,50 @@ void CircuitCanvas::DrawGrid(wxDC& dc) {
 }
 
 void CircuitCanvas::DrawComponents(wxDC& dc) {
+    // Components draw their untransformed layout; rotation and scale are
+    // applied by the device context with the same transform as their pins
+    bool canTransform = dc.CanUseTransformMatrix();
     for (const auto& component : components) {
+        if (!canTransform || !component->IsTransformed()) {
+            component->Draw(dc);
+            continue;
+        }
+
+        // The layout is drawn at the position, the transform works relative to it
+        const ComponentTransform& transform = component->GetTransform();
+        wxPoint pos = component->GetPosition();
+        wxAffineMatrix2D matrix;
+        matrix.Set(wxMatrix2D(transform.xx, transform.yx, transform.xy, transform.yy),
+                   wxPoint2DDouble(transform.dx - transform.xx * pos.x - transform.xy * pos.y,
+                                   transform.dy - transform.yx * pos.x - transform.yy * pos.y));
+        dc.SetTransformMatrix(matrix);
         component->Draw(dc);
+        dc.ResetTransformMatrix();
     }
 }
 
 void CircuitCanvas::DrawSelection(wxDC& dc) {
-    if (selectedComponent) {
+    if (isRubberBanding) {
+        dc.SetPen(wxPen(selectionColor, 1, wxPENSTYLE_DOT));
+        dc.SetBrush(*wxTRANSPARENT_BRUSH);
+        dc.DrawRectangle(wxRect(std::min(rubberBandStart.x, rubberBandEnd.x),
+                                std::min(rubberBandStart.y, rubberBandEnd.y),
+                                std::abs(rubberBandEnd.x - rubberBandStart.x),
+                                std::abs(rubberBandEnd.y - rubberBandStart.y)));
+    }
+
+    if (selection.size() > 1) {
+        // Outlines only; handles would clutter a large selection
+        dc.SetPen(wxPen(selectionColor, 2, wxPENSTYLE_DOT));
+        dc.SetBrush(*wxTRANSPARENT_BRUSH);
+        for (const CircuitComponent* component : selection) {
+            if (component->GetType() == ComponentType::WIRE) continue;  // Drawn red already
+            wxRect bounds = component->GetBounds();
+            dc.DrawRectangle(bounds.Inflate(5));
+        }
+    } else if (selectedComponent) {
         wxPoint pos = selectedComponent->GetPosition();
-        wxSize size = selectedComponent->GetSize();
+        wxSize size = selectedComponent->GetEffectiveSize();
 
         dc.SetPen(wxPen(selectionColor, 2, wxPENSTYLE_DOT));
         dc.SetBrush(*wxTRANSPARENT_BRUSH);
@@ -842,65 +1069,80 @@ void CircuitCanvas::DrawSelection(wxDC& dc) {
 
 // Document integration methods
 void CircuitCanvas::ClearComponents() {
+    PauseSimulation();
+    waveformRecorder.RemoveAllProbes();
+    simulation.ClearBreakpoints();
+    // The history refers to the components and holds removed ones
+    commandManager.Clear();
     components.clear();
+    componentsById.clear();
     selectedComponent = nullptr;
+    selection.clear();
     currentWire.reset();
+    pool->ReleaseIfUnused();
+    netlistDirty = true;
     Refresh();
 }
 
 void CircuitCanvas::AddComponentCopy(const CircuitComponent* component) {
+    PauseSimulation();
     if (!component) return;
 
     std::unique_ptr<CircuitComponent> newComponent = CloneComponent(component);
     if (newComponent) {
+        // A copy is a component of its own
+        newComponent->SetId(NO_COMPONENT_ID);
+        RegisterComponent(newComponent.get());
         components.push_back(std::move(newComponent));
+        netlistDirty = true;
     }
 }
 
 std::unique_ptr<CircuitComponent> CircuitCanvas::CloneComponent(const CircuitComponent* component) const {
     if (!component) return nullptr;
 
-    ComponentType type = component->GetType();
-    wxPoint pos = component->GetPosition();
-
-    return std::unique_ptr<CircuitComponent>(const_cast<CircuitCanvas*>(this)->CreateComponent(type, pos));
+    ComponentPool::Scope scope(pool.get());
+    return ComponentFactory::Clone(component);
 }
 
 // Command system methods
 void CircuitCanvas::AddComponentDirectly(std::unique_ptr<CircuitComponent> component) {
+    PauseSimulation();
     if (component) {
+        RegisterComponent(component.get());
         components.push_back(std::move(component));
+        netlistDirty = true;
         Refresh();
     }
 }
 
 void CircuitCanvas::RemoveComponentDirectly(CircuitComponent* component) {
+    PauseSimulation();
     auto it = std::find_if(components.begin(), components.end(),
         [component](const std::unique_ptr<CircuitComponent>& ptr) {
             return ptr.get() == component;
         });
 
     if (it != components.end()) {
-        if (selectedComponent == component) {
-            selectedComponent = nullptr;
-        }
+        ForgetComponent(component);
         components.erase(it);
+        netlistDirty = true;
         Refresh();
     }
 }
 
 std::unique_ptr<CircuitComponent> CircuitCanvas::ExtractComponent(CircuitComponent* component) {
+    PauseSimulation();
     auto it = std::find_if(components.begin(), components.end(),
         [component](const std::unique_ptr<CircuitComponent>& ptr) {
             return ptr.get() == component;
         });
 
     if (it != components.end()) {
-        if (selectedComponent == component) {
-            selectedComponent = nullptr;
-        }
+        ForgetComponent(component);
         std::unique_ptr<CircuitComponent> extracted = std::move(*it);
         components.erase(it);
+        netlistDirty = true;
         return extracted;
     }
 
@@ -920,9 +1162,86 @@ size_t CircuitCanvas::GetComponentIndex(CircuitComponent* component) const {
     return components.size(); // Return invalid index if not found
 }
 
+std::vector<std::unique_ptr<CircuitComponent>> CircuitCanvas::ExtractComponents(const std::vector<size_t>& indices) {
+    PauseSimulation();
+    std::vector<std::unique_ptr<CircuitComponent>> extracted;
+    extracted.reserve(indices.size());
+
+    // Compact the survivors in place instead of erasing one at a time
+    size_t next = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < components.size(); ++i) {
+        if (next < indices.size() && indices[next] == i) {
+            ForgetComponent(components[i].get());
+            extracted.push_back(std::move(components[i]));
+            ++next;
+        } else {
+            components[kept++] = std::move(components[i]);
+        }
+    }
+    components.resize(kept);
+    netlistDirty = true;
+    Refresh();
+    return extracted;
+}
+
+void CircuitCanvas::InsertComponentsAt(const std::vector<size_t>& indices,
+                                       std::vector<std::unique_ptr<CircuitComponent>> inserted) {
+    PauseSimulation();
+    size_t total = components.size() + inserted.size();
+    std::vector<std::unique_ptr<CircuitComponent>> merged;
+    merged.reserve(total);
+    for (const auto& component : inserted) {
+        RegisterComponent(component.get());
+    }
+
+    size_t next = 0;
+    size_t rest = 0;
+    while (merged.size() < total) {
+        bool takeInserted = next < inserted.size() &&
+                            (indices[next] <= merged.size() || rest == components.size());
+        merged.push_back(std::move(takeInserted ? inserted[next++] : components[rest++]));
+    }
+    components.swap(merged);
+    netlistDirty = true;
+    Refresh();
+}
+
+CircuitComponent* CircuitCanvas::FindComponent(ComponentId id) const {
+    auto it = componentsById.find(id);
+    return it != componentsById.end() ? it->second : nullptr;
+}
+
+void CircuitCanvas::RegisterComponent(CircuitComponent* component) {
+    // Components coming back through undo or from a file keep their ID;
+    // new ones, and any whose ID is taken, get the next unused one
+    ComponentId id = component->GetId();
+    auto taken = componentsById.find(id);
+    if (id == NO_COMPONENT_ID || (taken != componentsById.end() && taken->second != component)) {
+        id = nextComponentId;
+        component->SetId(id);
+    }
+    nextComponentId = std::max(nextComponentId, id + 1);
+    componentsById[id] = component;
+}
+
+void CircuitCanvas::ForgetComponent(CircuitComponent* component) {
+    componentsById.erase(component->GetId());
+    auto selected = std::find(selection.begin(), selection.end(), component);
+    if (selected != selection.end()) {
+        selection.erase(selected);
+        selectedComponent = selection.empty() ? nullptr : selection.back();
+    }
+    // Probes and breakpoints stay, so undoing a deletion brings them back
+    waveformRecorder.DetachComponent(component->GetId());
+}
+
 void CircuitCanvas::InsertComponentAt(size_t index, std::unique_ptr<CircuitComponent> component) {
+    PauseSimulation();
     if (component && index <= components.size()) {
+        RegisterComponent(component.get());
         components.insert(components.begin() + index, std::move(component));
+        netlistDirty = true;
         Refresh();
     }
 }
\ No newline at end of file
@@ -110,6 +110,24 @@ void ComponentLibraryPanel::PopulateTree() {
     treeCtrl->AppendItem(dataSelectionId, "1:2 Demultiplexer", 12);
     treeCtrl->AppendItem(dataSelectionId, "1:4 Demultiplexer", 12);
 
+    // Buses category
+    busesId = treeCtrl->AppendItem(rootId, "Buses", 0);
+    treeCtrl->AppendItem(busesId, "Bus Splitter", 15);
+    treeCtrl->AppendItem(busesId, "Bus Joiner", 15);
+    treeCtrl->AppendItem(busesId, "N-bit Adder", 10);
+    treeCtrl->AppendItem(busesId, "N-bit 4:1 Multiplexer", 11);
+    treeCtrl->AppendItem(busesId, "N-bit Register", 1);
+    treeCtrl->AppendItem(busesId, "N-bit Comparator", 1);
+    treeCtrl->AppendItem(busesId, "N-bit Subtractor", 10);
+    treeCtrl->AppendItem(busesId, "N-bit Multiplier", 10);
+    treeCtrl->AppendItem(busesId, "N-bit Shifter", 1);
+    treeCtrl->AppendItem(busesId, "N-bit ALU", 10);
+
+    // Memory category
+    memoryId = treeCtrl->AppendItem(rootId, "Memory", 0);
+    treeCtrl->AppendItem(memoryId, "RAM", 1);
+    treeCtrl->AppendItem(memoryId, "ROM", 1);
+
     // Sequential Logic category
     sequentialId = treeCtrl->AppendItem(rootId, "Sequential Logic", 0);
     treeCtrl->AppendItem(sequentialId, "D Flip-Flop", 1);
@@ -177,6 +195,20 @@ void ComponentLibraryPanel::PopulateTree() {
             else if (itemText == "4:1 Multiplexer") type = ComponentType::MULTIPLEXER_4TO1;
             else if (itemText == "1:2 Demultiplexer") type = ComponentType::DEMULTIPLEXER_1TO2;
             else if (itemText == "1:4 Demultiplexer") type = ComponentType::DEMULTIPLEXER_1TO4;
+            // Bus Components
+            else if (itemText == "Bus Splitter") type = ComponentType::BUS_SPLITTER;
+            else if (itemText == "Bus Joiner") type = ComponentType::BUS_JOINER;
+            else if (itemText == "N-bit Adder") type = ComponentType::BUS_ADDER;
+            else if (itemText == "N-bit 4:1 Multiplexer") type = ComponentType::BUS_MULTIPLEXER_4TO1;
+            else if (itemText == "N-bit Register") type = ComponentType::BUS_REGISTER;
+            else if (itemText == "N-bit Comparator") type = ComponentType::BUS_COMPARATOR;
+            else if (itemText == "N-bit Subtractor") type = ComponentType::BUS_SUBTRACTOR;
+            else if (itemText == "N-bit Multiplier") type = ComponentType::BUS_MULTIPLIER;
+            else if (itemText == "N-bit Shifter") type = ComponentType::BUS_SHIFTER;
+            else if (itemText == "N-bit ALU") type = ComponentType::BUS_ALU;
+            // Memory Components
+            else if (itemText == "RAM") type = ComponentType::RAM;
+            else if (itemText == "ROM") type = ComponentType::ROM;
             // Sequential Logic Components
             else if (itemText == "D Flip-Flop") type = ComponentType::D_FLIPFLOP;
             else if (itemText == "JK Flip-Flop") type = ComponentType::JK_FLIPFLOP;
@@ -1,10 +1,169 @@
 #include "../../include/ui/logisim_app.h"
 #include "../../include/ui/logisim_main_frame.h"
+#include "../../include/core/circuit_document.h"
+#include "../../include/core/circuit_netlist.h"
+#include "../../include/core/test_vector_runner.h"
+#include "../../include/core/truth_table.h"
+#include "../../include/core/equivalence_checker.h"
+#include <wx/wfstream.h>
+#include <memory>
+
+namespace {
+
+// Batch mode exit codes
+const int EXIT_BATCH_PASSED = 0;
+const int EXIT_BATCH_FAILED = 1;    // Test vectors did not match, or circuits not proven equivalent
+const int EXIT_BATCH_ERROR = 2;     // Bad file or unusable circuit
+
+// A batch run is over before a background build would be, so it waits for
+// the native code; without it the circuit is interpreted as usual
+void WaitForNativeCode(CircuitNetlist& netlist, const wxString& file) {
+    wxString error;
+    if (!netlist.WaitForNativeCode(error)) {
+        wxFprintf(stderr, "Native code not used for %s: %s\n", file, error);
+    }
+}
+
+} // namespace
+
+LogisimApp::LogisimApp()
+    : batchMode(false), printTruthTable(false), nativeCode(false) {
+}
 
 bool LogisimApp::OnInit() {
+    // Parses the command line
+    if (!wxApp::OnInit()) {
+        return false;
+    }
+
+    if (batchMode) {
+        return true;
+    }
+
     LogisimMainFrame* frame = new LogisimMainFrame();
     frame->Show(true);
     return true;
 }
 
-wxIMPLEMENT_APP(LogisimApp);
\ No newline at end of file
+int LogisimApp::OnRun() {
+    if (batchMode) {
+        return RunBatch();
+    }
+    return wxApp::OnRun();
+}
+
+void LogisimApp::OnInitCmdLine(wxCmdLineParser& parser) {
+    wxApp::OnInitCmdLine(parser);
+
+    parser.AddSwitch("t", "truth-table", "print the truth table of the circuit as CSV and exit");
+    parser.AddOption("v", "vectors", "run a test vector file against the circuit and exit");
+    parser.AddOption("e", "equivalent", "check the circuit for equivalence with another circuit file and exit");
+    parser.AddOption("o", "output", "write the batch result to a file instead of standard output");
+    parser.AddSwitch("n", "native", "compile the gates to native code with the system compiler for long runs");
+    parser.AddParam("circuit file", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
+}
+
+bool LogisimApp::OnCmdLineParsed(wxCmdLineParser& parser) {
+    if (!wxApp::OnCmdLineParsed(parser)) {
+        return false;
+    }
+
+    printTruthTable = parser.Found("truth-table");
+    nativeCode = parser.Found("native");
+    parser.Found("vectors", &vectorsFile);
+    parser.Found("equivalent", &referenceFile);
+    parser.Found("output", &outputFile);
+    if (parser.GetParamCount() > 0) {
+        circuitFile = parser.GetParam(0);
+    }
+
+    batchMode = printTruthTable || !vectorsFile.IsEmpty() || !referenceFile.IsEmpty();
+    if (batchMode == circuitFile.IsEmpty()) {
+        // Batch options need a circuit, and a circuit alone has nothing to do
+        parser.Usage();
+        return false;
+    }
+    return true;
+}
+
+int LogisimApp::RunBatch() {
+    CircuitDocument document;
+    if (!document.LoadFromFile(circuitFile)) {
+        wxFprintf(stderr, "Cannot load circuit file %s: %s\n", circuitFile, document.GetLastError());
+        return EXIT_BATCH_ERROR;
+    }
+
+    CircuitNetlist netlist;
+    netlist.SetNativeCode(nativeCode);
+    netlist.Build(document.GetComponents());
+    if (nativeCode) {
+        WaitForNativeCode(netlist, circuitFile);
+    }
+
+    std::unique_ptr<wxOutputStream> output;
+    if (outputFile.IsEmpty()) {
+        output.reset(new wxFFileOutputStream(stdout));
+    } else {
+        output.reset(new wxFileOutputStream(outputFile));
+    }
+    if (!output->IsOk()) {
+        wxFprintf(stderr, "Cannot write %s\n", outputFile);
+        return EXIT_BATCH_ERROR;
+    }
+
+    if (printTruthTable) {
+        TruthTable table;
+        if (!table.Generate(netlist)) {
+            wxFprintf(stderr, "%s\n", table.GetLastError());
+            return EXIT_BATCH_ERROR;
+        }
+        if (!table.WriteCSV(*output)) {
+            return EXIT_BATCH_ERROR;
+        }
+    }
+
+    if (!vectorsFile.IsEmpty()) {
+        TestVectorRunner runner;
+        TestVectorReport report;
+        if (!runner.LoadFromFile(vectorsFile) || !runner.Run(netlist, report)) {
+            wxFprintf(stderr, "%s\n", runner.GetLastError());
+            return EXIT_BATCH_ERROR;
+        }
+
+        std::string text = report.Format(report.mismatches.size()).ToStdString();
+        output->Write(text.data(), text.size());
+        if (!report.Passed()) {
+            return EXIT_BATCH_FAILED;
+        }
+    }
+
+    if (!referenceFile.IsEmpty()) {
+        CircuitDocument reference;
+        if (!reference.LoadFromFile(referenceFile)) {
+            wxFprintf(stderr, "Cannot load circuit file %s: %s\n", referenceFile, reference.GetLastError());
+            return EXIT_BATCH_ERROR;
+        }
+        CircuitNetlist referenceNetlist;
+        referenceNetlist.SetNativeCode(nativeCode);
+        referenceNetlist.Build(reference.GetComponents());
+        if (nativeCode) {
+            WaitForNativeCode(referenceNetlist, referenceFile);
+        }
+
+        EquivalenceChecker checker;
+        if (!checker.Check(netlist, referenceNetlist)) {
+            wxFprintf(stderr, "%s\n", checker.GetLastError());
+            return EXIT_BATCH_ERROR;
+        }
+
+        std::string text = checker.Format().ToStdString();
+        output->Write(text.data(), text.size());
+        if (checker.GetVerdict() != EquivalenceChecker::Verdict::EQUIVALENT) {
+            return EXIT_BATCH_FAILED;
+        }
+    }
+
+    return EXIT_BATCH_PASSED;
+}
+
+wxIMPLEMENT_APP(LogisimApp);
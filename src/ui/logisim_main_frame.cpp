@@ -1,5 +1,14 @@
 #include "../../include/ui/logisim_main_frame.h"
 #include "../../include/ui/icon_factory.h"
+#include "../../include/core/circuit_netlist.h"
+#include "../../include/core/test_vector_runner.h"
+#include "../../include/core/fault_simulator.h"
+#include "../../include/core/truth_table.h"
+#include "../../include/core/equivalence_checker.h"
+#include "../../include/ui/truth_table_dialog.h"
+#include "../../include/core/subcircuit_library.h"
+#include "../../include/components/subcircuit_component.h"
+#include "../../include/components/component_factory.h"
 #include <wx/clipbrd.h>
 #include <wx/tokenzr.h>
 #include <wx/filename.h>
@@ -8,6 +17,24 @@
 wxBEGIN_EVENT_TABLE(LogisimMainFrame, wxFrame)
     // Menu events MUST come BEFORE tool events to avoid interception
     EVT_MENU(wxID_FORWARD, LogisimMainFrame::OnSimulate)
+    EVT_MENU(ID_ADD_WAVEFORM_PROBE, LogisimMainFrame::OnAddWaveformProbe)
+    EVT_MENU(ID_RUN_TEST_VECTORS, LogisimMainFrame::OnRunTestVectors)
+    EVT_MENU(ID_FAULT_COVERAGE, LogisimMainFrame::OnFaultCoverage)
+    EVT_MENU(ID_TRUTH_TABLE, LogisimMainFrame::OnTruthTable)
+    EVT_MENU(ID_CHECK_EQUIVALENCE, LogisimMainFrame::OnCheckEquivalence)
+    EVT_MENU(ID_TIMED_MODE, LogisimMainFrame::OnTimedMode)
+    EVT_MENU(ID_OPTIMIZE_NETLIST, LogisimMainFrame::OnOptimizeNetlist)
+    EVT_MENU(ID_SHOW_CRITICAL_PATH, LogisimMainFrame::OnShowCriticalPath)
+    EVT_MENU(ID_TIMING_REPORT, LogisimMainFrame::OnTimingReport)
+    EVT_MENU(ID_RUN_SIMULATION, LogisimMainFrame::OnRunSimulation)
+    EVT_MENU(ID_PAUSE_SIMULATION, LogisimMainFrame::OnPauseSimulation)
+    EVT_MENU(ID_STEP_CYCLE, LogisimMainFrame::OnStepCycle)
+    EVT_MENU(ID_STEP_CYCLES, LogisimMainFrame::OnStepCycles)
+    EVT_MENU(ID_RUN_UNTIL, LogisimMainFrame::OnRunUntil)
+    EVT_MENU(ID_ADD_BREAKPOINT, LogisimMainFrame::OnAddBreakpoint)
+    EVT_MENU(ID_REMOVE_BREAKPOINT, LogisimMainFrame::OnRemoveBreakpoint)
+    EVT_MENU(ID_CLEAR_BREAKPOINTS, LogisimMainFrame::OnClearBreakpoints)
+    EVT_TIMER(ID_SIMULATION_TIMER, LogisimMainFrame::OnSimulationTimer)
     EVT_MENU(wxID_ABOUT, LogisimMainFrame::OnAbout)
     EVT_MENU(wxID_EXIT, LogisimMainFrame::OnExit)
 
@@ -16,6 +43,7 @@ wxBEGIN_EVENT_TABLE(LogisimMainFrame, wxFrame)
     EVT_MENU(wxID_OPEN, LogisimMainFrame::OnOpenFile)
     EVT_MENU(wxID_SAVE, LogisimMainFrame::OnSaveFile)
     EVT_MENU(ID_SAVEAS, LogisimMainFrame::OnSaveAsFile)
+    EVT_MENU(ID_PLACE_SUBCIRCUIT, LogisimMainFrame::OnPlaceSubcircuit)
     EVT_MENU_RANGE(ID_RECENT_FILE_START, ID_RECENT_FILE_START + 10, LogisimMainFrame::OnRecentFile)
 
     // Edit menu events
@@ -24,12 +52,14 @@ wxBEGIN_EVENT_TABLE(LogisimMainFrame, wxFrame)
     EVT_MENU(wxID_COPY, LogisimMainFrame::OnCopy)
     EVT_MENU(wxID_PASTE, LogisimMainFrame::OnPaste)
     EVT_MENU(wxID_DELETE, LogisimMainFrame::OnDelete)
+    EVT_MENU(wxID_SELECTALL, LogisimMainFrame::OnSelectAll)
 
     // View menu events
     EVT_MENU(ID_SHOW_GRID, LogisimMainFrame::OnShowGrid)
     EVT_MENU(ID_SNAP_TO_GRID, LogisimMainFrame::OnSnapToGrid)
     EVT_MENU(ID_SHOW_PROPERTIES, LogisimMainFrame::OnShowProperties)
     EVT_MENU(ID_SHOW_LIBRARY, LogisimMainFrame::OnShowLibrary)
+    EVT_MENU(ID_SHOW_WAVEFORM, LogisimMainFrame::OnShowWaveform)
     EVT_MENU(ID_ZOOM_IN, LogisimMainFrame::OnZoomIn)
     EVT_MENU(ID_ZOOM_OUT, LogisimMainFrame::OnZoomOut)
     EVT_MENU(ID_ZOOM_RESET, LogisimMainFrame::OnZoomReset)
@@ -41,6 +71,10 @@ wxBEGIN_EVENT_TABLE(LogisimMainFrame, wxFrame)
 
     EVT_COMMAND(wxID_ANY, ComponentLibraryPanel::wxEVT_COMPONENT_SELECTED, LogisimMainFrame::OnComponentSelected)
     EVT_COMMAND(wxID_ANY, CircuitCanvas::wxEVT_COMPONENT_SELECTED, LogisimMainFrame::OnCanvasComponentSelected)
+    EVT_COMMAND(wxID_ANY, CircuitCanvas::wxEVT_SIMULATION_UPDATED, LogisimMainFrame::OnSimulationUpdated)
+    EVT_COMMAND(wxID_ANY, PropertiesPanel::wxEVT_COMPONENT_CHANGING, LogisimMainFrame::OnComponentPropertiesChanging)
+    EVT_COMMAND(wxID_ANY, PropertiesPanel::wxEVT_COMPONENT_CHANGED, LogisimMainFrame::OnComponentPropertiesChanged)
+    EVT_COMMAND(wxID_ANY, SimulationController::wxEVT_SIMULATION_STOPPED, LogisimMainFrame::OnSimulationStopped)
 
     // Toolbar events - using specific range to avoid intercepting menu events
     EVT_TOOL_RANGE(static_cast<int>(ComponentType::SELECT), static_cast<int>(ComponentType::WIRE), LogisimMainFrame::OnToolSelected)
@@ -49,7 +83,10 @@ wxEND_EVENT_TABLE()
 LogisimMainFrame::LogisimMainFrame()
     : wxFrame(nullptr, wxID_ANY, "Enhanced Logic Circuit Simulator",
               wxDefaultPosition, wxSize(1200, 800)),
-      recentFilesMenu(nullptr) {
+      recentFilesMenu(nullptr),
+      nativeCodeMenuItem(nullptr),
+      simulationTimer(this, ID_SIMULATION_TIMER),
+      lastSampleCycle(0) {
 
     // Initialize document
     document = std::make_unique<CircuitDocument>();
@@ -68,6 +105,8 @@ LogisimMainFrame::LogisimMainFrame()
 }
 
 LogisimMainFrame::~LogisimMainFrame() {
+    simulationTimer.Stop();
+    canvas->PauseSimulation();
     auiManager.UnInit();
 }
 
@@ -90,6 +129,8 @@ void LogisimMainFrame::CreateUI() {
     canvas = new CircuitCanvas(this);
     propertiesPanel = new PropertiesPanel(this);
     libraryPanel = new ComponentLibraryPanel(this);
+    waveformPanel = new WaveformPanel(this);
+    waveformPanel->SetRecorder(&canvas->GetWaveformRecorder());
 
     // Initialize canvas tool AFTER canvas is created
     InitializeCanvasTools();
@@ -180,6 +221,8 @@ void LogisimMainFrame::CreateMenuBar() {
     fileMenu->Append(wxID_SAVE, "&Save Circuit\tCtrl+S", "Save the current circuit");
     fileMenu->Append(ID_SAVEAS, "Save &As...\tCtrl+Shift+S", "Save the circuit with a new name");
     fileMenu->AppendSeparator();
+    fileMenu->Append(ID_PLACE_SUBCIRCUIT, "Place S&ubcircuit...", "Use a saved circuit as a component");
+    fileMenu->AppendSeparator();
 
     // Recent files submenu
     recentFilesMenu = new wxMenu;
@@ -197,6 +240,7 @@ void LogisimMainFrame::CreateMenuBar() {
     editMenu->Append(wxID_COPY, "&Copy\tCtrl+C", "Copy selection");
     editMenu->Append(wxID_PASTE, "&Paste\tCtrl+V", "Paste from clipboard");
     editMenu->Append(wxID_DELETE, "&Delete\tDel", "Delete selection");
+    editMenu->Append(wxID_SELECTALL, "Select &All\tCtrl+A", "Select all components");
 
     // View menu
     wxMenu* viewMenu = new wxMenu;
@@ -214,8 +258,10 @@ void LogisimMainFrame::CreateMenuBar() {
 
     showPropertiesMenuItem = viewMenu->AppendCheckItem(ID_SHOW_PROPERTIES, "&Properties Panel", "Show/hide properties panel");
     showLibraryMenuItem = viewMenu->AppendCheckItem(ID_SHOW_LIBRARY, "&Component Library", "Show/hide component library");
+    showWaveformMenuItem = viewMenu->AppendCheckItem(ID_SHOW_WAVEFORM, "&Waveform Viewer", "Show/hide waveform viewer");
     showPropertiesMenuItem->Check(true);
     showLibraryMenuItem->Check(true);
+    showWaveformMenuItem->Check(true);
 
     // Theme menu
     wxMenu* themeMenu = new wxMenu;
@@ -226,6 +272,31 @@ void LogisimMainFrame::CreateMenuBar() {
     // Simulation menu
     wxMenu* simulationMenu = new wxMenu;
     simulationMenu->Append(wxID_FORWARD, "&Simulate\tF5", "Simulate the circuit");
+    simulationMenu->AppendCheckItem(ID_TIMED_MODE, "T&imed Mode", "Simulate with the propagation delays of the components");
+    simulationMenu->AppendCheckItem(ID_OPTIMIZE_NETLIST, "&Optimize Netlist",
+                                    "Fold constants and merge duplicate gates before simulating");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(ID_RUN_SIMULATION, "&Run\tF6", "Run clock cycles as fast as possible");
+    simulationMenu->Append(ID_PAUSE_SIMULATION, "&Pause\tShift+F6", "Pause the running simulation");
+    simulationMenu->Append(ID_STEP_CYCLE, "Step &Cycle\tF7", "Run one clock cycle");
+    simulationMenu->Append(ID_STEP_CYCLES, "Step &N Cycles...", "Run a number of clock cycles");
+    simulationMenu->Append(ID_RUN_UNTIL, "Run &Until...", "Run until a net of the selected component reaches a value or changes");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(ID_ADD_BREAKPOINT, "Add &Breakpoint...\tF9", "Pause when a pin of the selected component meets a condition");
+    simulationMenu->Append(ID_REMOVE_BREAKPOINT, "R&emove Breakpoint...", "Remove one breakpoint");
+    simulationMenu->Append(ID_CLEAR_BREAKPOINTS, "C&lear Breakpoints", "Remove all breakpoints");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(ID_ADD_WAVEFORM_PROBE, "Add to &Waveform\tCtrl+W", "Trace the selected component's signals in the waveform viewer");
+    simulationMenu->AppendSeparator();
+    simulationMenu->Append(ID_RUN_TEST_VECTORS, "Run &Test Vectors...", "Apply a table of input vectors and compare the outputs");
+    simulationMenu->Append(ID_FAULT_COVERAGE, "&Fault Coverage...", "Stuck-at fault coverage of a table of input vectors");
+    simulationMenu->Append(ID_TRUTH_TABLE, "Truth T&able...", "Enumerate every input combination of the circuit");
+    simulationMenu->Append(ID_CHECK_EQUIVALENCE, "Check &Equivalence...", "Compare the circuit with another circuit file by switch and LED labels");
+    nativeCodeMenuItem = simulationMenu->AppendCheckItem(ID_NATIVE_CODE, "Compile to Nati&ve Code",
+                                                         "Build the gates with the system compiler for long truth tables and fault runs");
+    simulationMenu->AppendSeparator();
+    simulationMenu->AppendCheckItem(ID_SHOW_CRITICAL_PATH, "Show &Critical Path", "Highlight the slowest path, updated after every edit");
+    simulationMenu->Append(ID_TIMING_REPORT, "Timin&g Report...", "Static timing of the slowest paths through the circuit");
 
     // Help menu
     wxMenu* helpMenu = new wxMenu;
@@ -243,7 +314,7 @@ void LogisimMainFrame::CreateMenuBar() {
 
 void LogisimMainFrame::SetupAcceleratorTable() {
     // Create accelerator entries for keyboard shortcuts
-    wxAcceleratorEntry entries[15];
+    wxAcceleratorEntry entries[16];
     int entryIndex = 0;
 
     // File menu shortcuts
@@ -259,6 +330,7 @@ void LogisimMainFrame::SetupAcceleratorTable() {
     entries[entryIndex++].Set(wxACCEL_CTRL, (int) 'C', wxID_COPY);
     entries[entryIndex++].Set(wxACCEL_CTRL, (int) 'V', wxID_PASTE);
     entries[entryIndex++].Set(wxACCEL_NORMAL, WXK_DELETE, wxID_DELETE);
+    entries[entryIndex++].Set(wxACCEL_CTRL, (int) 'A', wxID_SELECTALL);
 
     // View menu shortcuts
     entries[entryIndex++].Set(wxACCEL_CTRL, (int) 'G', ID_SHOW_GRID);
@@ -296,6 +368,14 @@ void LogisimMainFrame::SetupAUI() {
                        .MinSize(200, -1)
                        .BestSize(220, -1));
 
+    // Add waveform viewer at the bottom
+    auiManager.AddPane(waveformPanel, wxAuiPaneInfo()
+                       .Bottom()
+                       .Name("waveform")
+                       .Caption("Waveform")
+                       .MinSize(-1, 120)
+                       .BestSize(-1, 180));
+
     auiManager.Update();
 
     // Ensure this frame can receive menu events properly
@@ -426,7 +506,431 @@ void LogisimMainFrame::OnCanvasComponentSelected(wxCommandEvent& event) {
 void LogisimMainFrame::OnSimulate(wxCommandEvent& event) {
     canvas->SimulateCircuit();
     canvas->Refresh();
-    SetStatusText("Circuit simulated");
+
+    const CircuitNetlist& netlist = canvas->GetNetlist();
+    if (netlist.IsTimedMode()) {
+        SetStatusText(wxString::Format("Circuit simulated: settled at t=%llu, %zu glitch transition(s)",
+                                       static_cast<unsigned long long>(netlist.GetTime()),
+                                       netlist.GetGlitchCount()));
+    } else {
+        SetStatusText("Circuit simulated");
+    }
+}
+
+void LogisimMainFrame::OnTimedMode(wxCommandEvent& event) {
+    canvas->SetTimedMode(event.IsChecked());
+    canvas->SimulateCircuit();
+    canvas->Refresh();
+    SetStatusText(event.IsChecked() ? "Timed mode: outputs change after their rise and fall delays"
+                                    : "Zero-delay mode", 0);
+}
+
+void LogisimMainFrame::OnOptimizeNetlist(wxCommandEvent& event) {
+    canvas->SetOptimization(event.IsChecked());
+    canvas->SimulateCircuit();
+    canvas->Refresh();
+
+    const CircuitNetlist& netlist = canvas->GetNetlist();
+    if (!event.IsChecked()) {
+        SetStatusText("Netlist optimization off", 0);
+    } else if (netlist.IsTimedMode()) {
+        SetStatusText("Netlist optimization applies outside timed mode", 0);
+    } else {
+        const CircuitNetlist::OptimizationStats& stats = netlist.GetOptimizationStats();
+        SetStatusText(wxString::Format("Optimized netlist: %zu gate(s) removed (%zu constant, %zu buffer, "
+                                       "%zu duplicate, %zu unused)",
+                                       stats.Total(), stats.constantGates, stats.bufferGates,
+                                       stats.mergedGates, stats.deadGates), 0);
+    }
+}
+
+void LogisimMainFrame::OnSimulationUpdated(wxCommandEvent& event) {
+    waveformPanel->RefreshTraces();
+}
+
+void LogisimMainFrame::OnComponentPropertiesChanging(wxCommandEvent& event) {
+    // The worker evaluates on the pins that are about to be recreated
+    canvas->PauseSimulation();
+}
+
+void LogisimMainFrame::OnComponentPropertiesChanged(wxCommandEvent& event) {
+    canvas->InvalidateNetlist();
+    canvas->SimulateCircuit();
+    canvas->Refresh();
+    document->SetModified(true);
+}
+
+void LogisimMainFrame::OnAddWaveformProbe(wxCommandEvent& event) {
+    CircuitComponent* selected = canvas->GetSelectedComponent();
+    if (!selected) {
+        SetStatusText("No component selected to trace", 0);
+        return;
+    }
+
+    int added = canvas->AddWaveformProbes(selected);
+    waveformPanel->RefreshTraces();
+
+    // Make sure the viewer is visible
+    wxAuiPaneInfo& pane = auiManager.GetPane("waveform");
+    if (!pane.IsShown()) {
+        pane.Show(true);
+        auiManager.Update();
+        UpdateMenus();
+    }
+
+    SetStatusText(wxString::Format("%d signal(s) added to waveform", added), 0);
+}
+
+void LogisimMainFrame::OnRunTestVectors(wxCommandEvent& event) {
+    wxFileDialog openFileDialog(this, "Run Test Vectors", "", "",
+                               "Test vectors (*.csv;*.txt)|*.csv;*.txt|All files (*.*)|*.*",
+                               wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+    if (openFileDialog.ShowModal() == wxID_CANCEL) return;
+
+    TestVectorRunner runner;
+    if (!runner.LoadFromFile(openFileDialog.GetPath())) {
+        wxMessageBox(runner.GetLastError(), "Test Vectors", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    // Vectors clock the flip-flops and registers they run on, so they run
+    // on a copy and leave the state shown in the editor alone
+    canvas->PauseSimulation();
+    std::vector<std::unique_ptr<CircuitComponent>> copies;
+    ComponentFactory::CloneCircuit(canvas->GetComponents(), copies);
+
+    // Compile once and run every vector against the same netlist
+    CircuitNetlist netlist;
+    netlist.Build(copies);
+
+    TestVectorReport report;
+    if (!runner.Run(netlist, report)) {
+        wxMessageBox(runner.GetLastError(), "Test Vectors", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    SetStatusText(wxString::Format("Test vectors: %zu run, %zu failed",
+                                   report.vectorsRun, report.vectorsFailed), 0);
+    wxMessageBox(report.Format(), "Test Vectors",
+                 wxOK | (report.Passed() ? wxICON_INFORMATION : wxICON_WARNING), this);
+}
+
+void LogisimMainFrame::OnFaultCoverage(wxCommandEvent& event) {
+    wxFileDialog openFileDialog(this, "Fault Coverage", "", "",
+                               "Test vectors (*.csv;*.txt)|*.csv;*.txt|All files (*.*)|*.*",
+                               wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+    if (openFileDialog.ShowModal() == wxID_CANCEL) return;
+
+    TestVectorRunner vectors;
+    if (!vectors.LoadFromFile(openFileDialog.GetPath())) {
+        wxMessageBox(vectors.GetLastError(), "Fault Coverage", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    // Blocks are evaluated on the pins of the components they run on, so the
+    // faults are injected into a copy and the editor keeps its state
+    canvas->PauseSimulation();
+    std::vector<std::unique_ptr<CircuitComponent>> copies;
+    ComponentFactory::CloneCircuit(canvas->GetComponents(), copies);
+    CircuitNetlist netlist;
+    netlist.SetNativeCode(nativeCodeMenuItem->IsChecked());
+    netlist.Build(copies);
+
+    FaultSimulator simulator;
+    bool simulated;
+    {
+        wxBusyCursor busy;
+        simulated = simulator.Run(netlist, vectors);
+    }
+    if (!simulated) {
+        wxMessageBox(simulator.GetLastError(), "Fault Coverage", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    SetStatusText(wxString::Format("Fault coverage: %.1f%%", simulator.GetCoverage()), 0);
+    wxMessageBox(simulator.Format(netlist), "Fault Coverage", wxOK | wxICON_INFORMATION, this);
+}
+
+void LogisimMainFrame::OnTruthTable(wxCommandEvent& event) {
+    // Every row drives the inputs of the components it runs on, so the
+    // table is generated on a copy and the editor keeps its state
+    canvas->PauseSimulation();
+    std::vector<std::unique_ptr<CircuitComponent>> copies;
+    ComponentFactory::CloneCircuit(canvas->GetComponents(), copies);
+    CircuitNetlist netlist;
+    netlist.SetNativeCode(nativeCodeMenuItem->IsChecked());
+    netlist.Build(copies);
+
+    // With a selection, the table covers only the selected switches and
+    // LEDs; the copies keep their IDs, so the selection carries over
+    std::vector<ComponentId> selection;
+    for (const CircuitComponent* component : canvas->GetSelection()) {
+        selection.push_back(component->GetId());
+    }
+
+    TruthTable table;
+    bool generated;
+    {
+        wxBusyCursor busy;
+        generated = table.Generate(netlist, selection);
+    }
+    if (!generated) {
+        wxMessageBox(table.GetLastError(), "Truth Table", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    SetStatusText(wxString::Format("Truth table: %zu row(s)", table.GetRowCount()), 0);
+    TruthTableDialog dialog(this, table);
+    dialog.ShowModal();
+}
+
+void LogisimMainFrame::OnCheckEquivalence(wxCommandEvent& event) {
+    wxFileDialog openFileDialog(this, "Check Equivalence", "", "",
+                               "Circuit files (*.lcf)|*.lcf|All files (*.*)|*.*",
+                               wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+    if (openFileDialog.ShowModal() == wxID_CANCEL) return;
+
+    CircuitDocument reference;
+    if (!reference.LoadFromFile(openFileDialog.GetPath())) {
+        wxMessageBox(reference.GetLastError(), "Check Equivalence", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    // The checker drives the inputs of both circuits, so the current one is
+    // checked as a copy and the editor keeps its state
+    canvas->PauseSimulation();
+    std::vector<std::unique_ptr<CircuitComponent>> copies;
+    ComponentFactory::CloneCircuit(canvas->GetComponents(), copies);
+    CircuitNetlist netlist;
+    netlist.SetNativeCode(nativeCodeMenuItem->IsChecked());
+    netlist.Build(copies);
+    CircuitNetlist referenceNetlist;
+    referenceNetlist.SetNativeCode(nativeCodeMenuItem->IsChecked());
+    referenceNetlist.Build(reference.GetComponents());
+
+    EquivalenceChecker checker;
+    bool checked;
+    {
+        wxBusyCursor busy;
+        checked = checker.Check(netlist, referenceNetlist);
+    }
+    if (!checked) {
+        wxMessageBox(checker.GetLastError(), "Check Equivalence", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    bool equivalent = checker.GetVerdict() == EquivalenceChecker::Verdict::EQUIVALENT;
+    SetStatusText(equivalent ? "Circuits are equivalent" : "Circuits are not proven equivalent", 0);
+    wxMessageBox(checker.Format(), "Check Equivalence",
+                 wxOK | (equivalent ? wxICON_INFORMATION : wxICON_WARNING), this);
+}
+
+void LogisimMainFrame::StartSimulation(const RunCondition& condition) {
+    if (!canvas->RunSimulation(condition)) {
+        SetStatusText("Simulation is already running", 0);
+        return;
+    }
+
+    // Properties edit the components the worker is evaluating
+    propertiesPanel->Enable(false);
+    lastSampleCycle = canvas->GetSimulationCycle();
+    lastSampleTime = std::chrono::steady_clock::now();
+    simulationTimer.Start(SIMULATION_REFRESH_MS);
+    SetStatusText("Running...", 0);
+}
+
+bool LogisimMainFrame::ChoosePin(const wxString& title, CircuitComponent*& selected, size_t& pinIndex, uint32_t& net) {
+    selected = canvas->GetSelectedComponent();
+    if (!selected || selected->GetType() == ComponentType::WIRE) {
+        wxMessageBox("Select the component whose pin should be watched.", title, wxOK | wxICON_INFORMATION, this);
+        return false;
+    }
+
+    wxArrayString choices;
+    for (size_t i = 0; i < selected->GetPins().size(); ++i) {
+        const Pin& pin = selected->GetPins()[i];
+        choices.Add(wxString::Format("%s %zu (%d bit)", pin.isInput ? "Input" : "Output", i, pin.width));
+    }
+    int choice = wxGetSingleChoiceIndex("Pin to watch:", title, choices, this);
+    if (choice < 0) return false;
+
+    pinIndex = static_cast<size_t>(choice);
+    net = canvas->FindPinNet(selected, pinIndex);
+    if (net == CircuitNetlist::NO_NET) {
+        wxMessageBox("The pin is not part of the simulated circuit.", title, wxOK | wxICON_ERROR, this);
+        return false;
+    }
+    return true;
+}
+
+void LogisimMainFrame::OnShowCriticalPath(wxCommandEvent& event) {
+    canvas->SetShowCriticalPath(event.IsChecked());
+    if (event.IsChecked()) {
+        SetStatusText(wxString::Format("Critical delay: %llu",
+                                       static_cast<unsigned long long>(canvas->GetTimingAnalysis().GetCriticalDelay())), 0);
+    }
+}
+
+void LogisimMainFrame::OnTimingReport(wxCommandEvent& event) {
+    canvas->AnalyzeTiming();
+    canvas->Refresh();
+
+    const TimingAnalysis& timing = canvas->GetTimingAnalysis();
+    SetStatusText(wxString::Format("Critical delay: %llu", static_cast<unsigned long long>(timing.GetCriticalDelay())), 0);
+    wxMessageBox(timing.Format(canvas->GetTimingNetlist()), "Timing Report", wxOK | wxICON_INFORMATION, this);
+}
+
+void LogisimMainFrame::OnRunSimulation(wxCommandEvent& event) {
+    StartSimulation(RunCondition());
+}
+
+void LogisimMainFrame::OnPauseSimulation(wxCommandEvent& event) {
+    // The stop event finishes the run
+    canvas->PauseSimulation();
+}
+
+void LogisimMainFrame::OnStepCycle(wxCommandEvent& event) {
+    SimulationStop stop = canvas->StepSimulation(RunCondition::Cycles(1));
+    SetStatusText(wxString::Format("%s - cycle %llu", SimulationController::DescribeStop(stop),
+                                   static_cast<unsigned long long>(canvas->GetSimulationCycle())), 0);
+}
+
+void LogisimMainFrame::OnStepCycles(wxCommandEvent& event) {
+    wxString text = wxGetTextFromUser("Number of clock cycles to run:", "Step N Cycles", "100", this);
+    if (text.IsEmpty()) return;
+
+    unsigned long long count;
+    if (!text.ToULongLong(&count) || count == 0) {
+        wxMessageBox("Enter a positive number of cycles.", "Step N Cycles", wxOK | wxICON_ERROR, this);
+        return;
+    }
+    StartSimulation(RunCondition::Cycles(count));
+}
+
+void LogisimMainFrame::OnRunUntil(wxCommandEvent& event) {
+    const wxString title = "Run Until";
+    CircuitComponent* component;
+    size_t pinIndex;
+    uint32_t net;
+    if (!ChoosePin(title, component, pinIndex, net)) return;
+
+    // An empty value breaks on any change of the net
+    wxString text = wxGetTextFromUser("Hexadecimal value to stop at, or empty to stop when the net changes:",
+                                      title, "", this);
+    text = text.Trim(false).Trim(true);
+    if (text.IsEmpty()) {
+        StartSimulation(RunCondition::NetChanges(net));
+        return;
+    }
+
+    unsigned long long value;
+    if (!text.ToULongLong(&value, 16)) {
+        wxMessageBox(wxString::Format("\"%s\" is not a hexadecimal value.", text), title, wxOK | wxICON_ERROR, this);
+        return;
+    }
+    BusValue target = { value, 0 };
+    StartSimulation(RunCondition::NetEquals(net, target));
+}
+
+void LogisimMainFrame::OnAddBreakpoint(wxCommandEvent& event) {
+    const wxString title = "Add Breakpoint";
+    Breakpoint breakpoint;
+    CircuitComponent* component;
+    uint32_t net;
+    if (!ChoosePin(title, component, breakpoint.pinIndex, net)) return;
+    breakpoint.componentId = component->GetId();
+    breakpoint.componentType = component->GetType();
+    breakpoint.value = BusValue{ 0, 0 };
+    breakpoint.enabled = true;
+
+    // Rising and falling only make sense on single lines
+    bool singleLine = component->GetPins()[breakpoint.pinIndex].width <= 1;
+    wxArrayString conditions;
+    conditions.Add("Changes");
+    conditions.Add("Equals value...");
+    if (singleLine) {
+        conditions.Add("Goes HIGH");
+        conditions.Add("Goes LOW");
+    }
+    int condition = wxGetSingleChoiceIndex("Pause the simulation when the pin:", title, conditions, this);
+    switch (condition) {
+        case 0: breakpoint.kind = CircuitNetlist::Watchpoint::Kind::CHANGES; break;
+        case 1: breakpoint.kind = CircuitNetlist::Watchpoint::Kind::EQUALS; break;
+        case 2: breakpoint.kind = CircuitNetlist::Watchpoint::Kind::GOES_HIGH; break;
+        case 3: breakpoint.kind = CircuitNetlist::Watchpoint::Kind::GOES_LOW; break;
+        default: return;
+    }
+
+    if (breakpoint.kind == CircuitNetlist::Watchpoint::Kind::EQUALS) {
+        wxString text = wxGetTextFromUser("Hexadecimal value:", title, "", this);
+        text = text.Trim(false).Trim(true);
+        unsigned long long value;
+        if (text.IsEmpty()) return;
+        if (!text.ToULongLong(&value, 16)) {
+            wxMessageBox(wxString::Format("\"%s\" is not a hexadecimal value.", text), title, wxOK | wxICON_ERROR, this);
+            return;
+        }
+        breakpoint.value.bits = value;
+    }
+
+    canvas->GetSimulation().AddBreakpoint(breakpoint);
+    SetStatusText("Breakpoint: " + SimulationController::DescribeBreakpoint(breakpoint), 0);
+}
+
+void LogisimMainFrame::OnRemoveBreakpoint(wxCommandEvent& event) {
+    SimulationController& simulation = canvas->GetSimulation();
+    if (simulation.GetBreakpoints().empty()) {
+        SetStatusText("No breakpoints set", 0);
+        return;
+    }
+
+    wxArrayString choices;
+    for (const Breakpoint& breakpoint : simulation.GetBreakpoints()) {
+        choices.Add(SimulationController::DescribeBreakpoint(breakpoint));
+    }
+    int choice = wxGetSingleChoiceIndex("Breakpoint to remove:", "Remove Breakpoint", choices, this);
+    if (choice < 0) return;
+
+    simulation.RemoveBreakpoint(static_cast<size_t>(choice));
+    SetStatusText(wxString::Format("%zu breakpoint(s) set", simulation.GetBreakpoints().size()), 0);
+}
+
+void LogisimMainFrame::OnClearBreakpoints(wxCommandEvent& event) {
+    canvas->GetSimulation().ClearBreakpoints();
+    SetStatusText("Breakpoints cleared", 0);
+}
+
+void LogisimMainFrame::OnSimulationTimer(wxTimerEvent& event) {
+    canvas->SampleSimulation();
+
+    uint64_t cycle = canvas->GetSimulationCycle();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - lastSampleTime).count();
+    if (seconds > 0) {
+        SetStatusText(wxString::Format("Running - cycle %llu, %.0f cycles/s", static_cast<unsigned long long>(cycle),
+                                       (cycle - lastSampleCycle) / seconds), 0);
+    }
+    lastSampleCycle = cycle;
+    lastSampleTime = now;
+}
+
+void LogisimMainFrame::OnSimulationStopped(wxCommandEvent& event) {
+    simulationTimer.Stop();
+    canvas->SampleSimulation();
+    propertiesPanel->Enable(true);
+
+    SimulationStop stop = static_cast<SimulationStop>(event.GetInt());
+    wxString reason = SimulationController::DescribeStop(stop);
+    const std::vector<Breakpoint>& breakpoints = canvas->GetSimulation().GetBreakpoints();
+    long hit = event.GetExtraLong();
+    if (stop == SimulationStop::BREAKPOINT && hit >= 0 && static_cast<size_t>(hit) < breakpoints.size()) {
+        reason += ": " + SimulationController::DescribeBreakpoint(breakpoints[hit]);
+    }
+    SetStatusText(wxString::Format("%s - cycle %llu", reason,
+                                   static_cast<unsigned long long>(canvas->GetSimulationCycle())), 0);
 }
 
 void LogisimMainFrame::OnAbout(wxCommandEvent& event) {
@@ -486,6 +990,12 @@ void LogisimMainFrame::OnShowLibrary(wxCommandEvent& event) {
     auiManager.Update();
 }
 
+void LogisimMainFrame::OnShowWaveform(wxCommandEvent& event) {
+    wxAuiPaneInfo& pane = auiManager.GetPane("waveform");
+    pane.Show(event.IsChecked());
+    auiManager.Update();
+}
+
 void LogisimMainFrame::OnZoomIn(wxCommandEvent& event) {
     canvas->ZoomIn();
     UpdateMenus(); // Update status bar zoom
@@ -632,6 +1142,40 @@ void LogisimMainFrame::OnSaveAsFile(wxCommandEvent& event) {
     }
 }
 
+void LogisimMainFrame::OnPlaceSubcircuit(wxCommandEvent& event) {
+    wxFileDialog openFileDialog(this, "Place Subcircuit", "", "",
+                               "Circuit files (*.lcf)|*.lcf|All files (*.*)|*.*",
+                               wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+
+    if (openFileDialog.ShowModal() == wxID_CANCEL) return;
+
+    // Every instance of the same file shares one definition
+    wxString error;
+    auto definition = SubcircuitLibrary::GetInstance().Load(openFileDialog.GetPath(), error);
+    if (!definition) {
+        wxMessageBox(error, "Place Subcircuit", wxOK | wxICON_ERROR, this);
+        return;
+    }
+
+    // Drop the instance in the middle of the view
+    wxSize clientSize = canvas->GetClientSize();
+    wxPoint pos = canvas->ScreenToWorld(wxPoint(clientSize.x / 2, clientSize.y / 2));
+    if (canvas->GetSnapToGrid()) {
+        pos = canvas->SnapToGrid(pos);
+    }
+
+    SubcircuitComponent* instance = new SubcircuitComponent(pos, definition);
+    auto addCommand = std::make_unique<AddComponentCommand>(canvas,
+        std::unique_ptr<CircuitComponent>(instance));
+    canvas->GetCommandManager().ExecuteCommand(std::move(addCommand));
+    canvas->SelectComponent(instance);
+    canvas->SimulateCircuit();
+    canvas->Refresh();
+
+    UpdateMenus();
+    SetStatusText("Subcircuit placed: " + definition->GetName(), 0);
+}
+
 // Edit menu handlers
 void LogisimMainFrame::OnUndo(wxCommandEvent& event) {
     if (canvas) {
@@ -653,14 +1197,14 @@ void LogisimMainFrame::OnRedo(wxCommandEvent& event) {
 
 void LogisimMainFrame::OnCopy(wxCommandEvent& event) {
     if (canvas && canvas->GetSelectedComponent()) {
-        // Store the selected component type and position for copy/paste
+        // Store the selected component's ID, type and position for copy/paste
         CircuitComponent* selected = canvas->GetSelectedComponent();
         ComponentType type = selected->GetType();
         wxPoint pos = selected->GetPosition();
 
         // Save to clipboard as string representation
-        wxString clipboardData = wxString::Format("%d,%d,%d",
-            static_cast<int>(type), pos.x, pos.y);
+        wxString clipboardData = wxString::Format("%u,%d,%d,%d",
+            selected->GetId(), static_cast<int>(type), pos.x, pos.y);
 
         if (wxTheClipboard->Open()) {
             wxTheClipboard->SetData(new wxTextDataObject(clipboardData));
@@ -681,11 +1225,14 @@ void LogisimMainFrame::OnPaste(wxCommandEvent& event) {
             wxTheClipboard->GetData(data);
             wxString clipboardText = data.GetText();
 
-            // Parse clipboard data
+            // Parse clipboard data; text copied before IDs has no ID in front
             wxStringTokenizer tokenizer(clipboardText, ",");
-            if (tokenizer.CountTokens() == 3) {
+            size_t tokens = tokenizer.CountTokens();
+            if (tokens == 3 || tokens == 4) {
+                unsigned long id = NO_COMPONENT_ID;
                 long typeValue, x, y;
-                if (tokenizer.GetNextToken().ToLong(&typeValue) &&
+                if ((tokens == 3 || tokenizer.GetNextToken().ToULong(&id)) &&
+                    tokenizer.GetNextToken().ToLong(&typeValue) &&
                     tokenizer.GetNextToken().ToLong(&x) &&
                     tokenizer.GetNextToken().ToLong(&y)) {
 
@@ -694,8 +1241,21 @@ void LogisimMainFrame::OnPaste(wxCommandEvent& event) {
                     // Offset the paste position slightly to avoid overlap
                     wxPoint pastePos(x + 20, y + 20);
 
-                    // Directly create and add the component using canvas methods
-                    CircuitComponent* newComponent = canvas->CreateComponent(type, pastePos);
+                    // A copy of the original while it is still placed, so its settings come along
+                    CircuitComponent* newComponent = nullptr;
+                    CircuitComponent* original = canvas->FindComponent(static_cast<ComponentId>(id));
+                    if (original && original->GetType() == type) {
+                        std::unique_ptr<CircuitComponent> copy = canvas->CloneComponent(original);
+                        if (copy) {
+                            copy->SetId(NO_COMPONENT_ID);
+                            copy->Move(pastePos - copy->GetPosition());
+                            newComponent = copy.release();
+                        }
+                    }
+                    if (!newComponent) {
+                        // Directly create and add the component using canvas methods
+                        newComponent = canvas->CreateComponent(type, pastePos);
+                    }
                     if (newComponent) {
                         auto addCommand = std::make_unique<AddComponentCommand>(canvas,
                             std::unique_ptr<CircuitComponent>(newComponent));
@@ -727,7 +1287,13 @@ void LogisimMainFrame::OnDelete(wxCommandEvent& event) {
         wxKeyEvent keyEvent(wxEVT_KEY_DOWN);
         keyEvent.m_keyCode = WXK_DELETE;
         canvas->GetEventHandler()->ProcessEvent(keyEvent);
-        SetStatusText("Selected component deleted", 0);
+        SetStatusText("Selection deleted", 0);
+    }
+}
+
+void LogisimMainFrame::OnSelectAll(wxCommandEvent& event) {
+    if (canvas) {
+        canvas->SelectAll();
     }
 }
 
@@ -837,13 +1403,16 @@ void LogisimMainFrame::UpdateMenus() {
     if (showLibraryMenuItem) {
         showLibraryMenuItem->Check(auiManager.GetPane("library").IsShown());
     }
+    if (showWaveformMenuItem) {
+        showWaveformMenuItem->Check(auiManager.GetPane("waveform").IsShown());
+    }
 
     // Update Edit menu items based on command manager state
     wxMenuBar* menuBar = GetMenuBar();
     if (menuBar) {
         menuBar->Enable(wxID_UNDO, canvas->GetCommandManager().CanUndo());
         menuBar->Enable(wxID_REDO, canvas->GetCommandManager().CanRedo());
-        menuBar->Enable(wxID_DELETE, canvas->GetSelectedComponent() != nullptr);
+        menuBar->Enable(wxID_DELETE, canvas->HasSelection());
         menuBar->Enable(wxID_COPY, canvas->GetSelectedComponent() != nullptr);
     }
 
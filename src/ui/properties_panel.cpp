@@ -1,4 +1,13 @@
 #include "../../include/ui/properties_panel.h"
+#include "../../include/components/io_components.h"
+#include "../../include/components/logic_gates.h"
+#include "../../include/components/bus_components.h"
+#include "../../include/core/memory_image.h"
+#include <algorithm>
+
+// Define custom events
+const wxEventType PropertiesPanel::wxEVT_COMPONENT_CHANGING = wxNewEventType();
+const wxEventType PropertiesPanel::wxEVT_COMPONENT_CHANGED = wxNewEventType();
 
 wxBEGIN_EVENT_TABLE(PropertiesPanel, wxPanel)
     EVT_PG_CHANGED(wxID_ANY, PropertiesPanel::OnPropertyChanged)
@@ -82,6 +91,9 @@ void PropertiesPanel::PopulateProperties() {
     // Type-specific properties
     PopulateTypeSpecificProperties();
 
+    // Propagation delays
+    PopulateTimingProperties();
+
     // Pin information
     PopulatePinProperties();
 }
@@ -177,6 +189,22 @@ void PropertiesPanel::PopulateTypeSpecificProperties() {
         case ComponentType::LED_MATRIX_8X8:
             PopulateDisplayProperties();
             break;
+        case ComponentType::BUS_SPLITTER:
+        case ComponentType::BUS_JOINER:
+        case ComponentType::BUS_ADDER:
+        case ComponentType::BUS_MULTIPLEXER_4TO1:
+        case ComponentType::BUS_REGISTER:
+        case ComponentType::BUS_COMPARATOR:
+        case ComponentType::BUS_SUBTRACTOR:
+        case ComponentType::BUS_MULTIPLIER:
+        case ComponentType::BUS_SHIFTER:
+        case ComponentType::BUS_ALU:
+            PopulateBusProperties();
+            break;
+        case ComponentType::RAM:
+        case ComponentType::ROM:
+            PopulateMemoryProperties();
+            break;
         default:
             PopulateDefaultProperties();
             break;
@@ -254,7 +282,8 @@ void PropertiesPanel::PopulateInputProperties() {
     propGrid->SetPropertyReadOnly("hex_value");
 
     // Component identification and display
-    propGrid->Append(new wxStringProperty("Label", "label", ""));
+    InputSwitch* inputSwitch = static_cast<InputSwitch*>(currentComponent);
+    propGrid->Append(new wxStringProperty("Label", "label", inputSwitch->GetLabel()));
     wxFont defaultFont = wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
     propGrid->Append(new wxFontProperty("Label Font", "label_font", defaultFont));
 
@@ -353,15 +382,14 @@ void PropertiesPanel::PopulateOutputProperties() {
     propGrid->SetPropertyReadOnly("power_consumption");
 
     // Component identification and display
-    propGrid->Append(new wxStringProperty("Label", "label", ""));
+    OutputLED* outputLED = static_cast<OutputLED*>(currentComponent);
+    propGrid->Append(new wxStringProperty("Label", "label", outputLED->GetLabel()));
     wxFont defaultFont = wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL);
     propGrid->Append(new wxFontProperty("Label Font", "label_font", defaultFont));
 }
 
 void PropertiesPanel::PopulateLogicGateProperties() {
     // Logic gate specific properties based on real electronic characteristics
-    ComponentType type = currentComponent->GetType();
-
     // Facing direction - affects pin orientation
     wxArrayString facingChoices;
     facingChoices.Add("East");
@@ -370,14 +398,23 @@ void PropertiesPanel::PopulateLogicGateProperties() {
     facingChoices.Add("South");
     propGrid->Append(new wxEnumProperty("Facing", "facing", facingChoices, wxArrayInt(), 0));
 
-    // Input Count - varies by gate type
-    int defaultInputs = (type == ComponentType::NOT_GATE || type == ComponentType::BUFFER) ? 1 : 2;
-    int maxInputs = (type == ComponentType::NOT_GATE || type == ComponentType::BUFFER) ? 1 : 8;
-    wxPGProperty* inputCountProp = propGrid->Append(new wxIntProperty("Input Count", "input_count", defaultInputs));
-    inputCountProp->SetAttribute(wxPG_ATTR_MIN, 1);
-    inputCountProp->SetAttribute(wxPG_ATTR_MAX, maxInputs);
-    if (type == ComponentType::NOT_GATE || type == ComponentType::BUFFER) {
-        propGrid->SetPropertyReadOnly("input_count"); // NOT gate always has 1 input
+    // Input Count - NOT gates and buffers always have 1 input
+    int inputCount = currentComponent->GetInputCount();
+    if (inputCount > 0) {
+        wxPGProperty* inputCountProp = propGrid->Append(new wxIntProperty("Input Count", "input_count", inputCount));
+        inputCountProp->SetAttribute(wxPG_ATTR_MIN, LogicGate::MIN_INPUTS);
+        inputCountProp->SetAttribute(wxPG_ATTR_MAX, LogicGate::MAX_INPUTS);
+
+        // The pins are recreated on a change, so wires would be left dangling
+        const auto& pins = currentComponent->GetPins();
+        bool connected = std::any_of(pins.begin(), pins.end(), [](const Pin& pin) { return pin.isConnected; });
+        if (connected) {
+            propGrid->SetPropertyReadOnly("input_count");
+            propGrid->SetPropertyHelpString("input_count", "Disconnect all wires to change the input count");
+        }
+    } else {
+        propGrid->Append(new wxIntProperty("Input Count", "input_count", 1));
+        propGrid->SetPropertyReadOnly("input_count");
     }
 
     // Logic Family - affects electrical characteristics
@@ -893,6 +930,79 @@ void PropertiesPanel::PopulateDisplayProperties() {
     propGrid->Append(new wxFontProperty("Label Font", "label_font", defaultFont));
 }
 
+void PropertiesPanel::PopulateBusProperties() {
+    // Width-parametric bus components
+    wxPGProperty* widthProp = propGrid->Append(new wxIntProperty("Data Width", "data_width",
+                                                                 currentComponent->GetDataWidth()));
+    widthProp->SetAttribute(wxPG_ATTR_MIN, BusComponent::MIN_WIDTH);
+    widthProp->SetAttribute(wxPG_ATTR_MAX, BusComponent::MAX_WIDTH);
+
+    // The pins are recreated on a width change, so wires would be left dangling
+    const auto& pins = currentComponent->GetPins();
+    bool connected = std::any_of(pins.begin(), pins.end(), [](const Pin& pin) { return pin.isConnected; });
+    if (connected) {
+        propGrid->SetPropertyReadOnly("data_width");
+        propGrid->SetPropertyHelpString("data_width", "Disconnect all wires to change the width");
+    }
+}
+
+void PropertiesPanel::PopulateMemoryProperties() {
+    // RAM and ROM geometry and contents
+    MemoryImage* memory = currentComponent->GetMemory();
+
+    wxPGProperty* addressProp = propGrid->Append(new wxIntProperty("Address Width", "address_width",
+                                                                   currentComponent->GetAddressWidth()));
+    addressProp->SetAttribute(wxPG_ATTR_MIN, MemoryImage::MIN_ADDRESS_WIDTH);
+    addressProp->SetAttribute(wxPG_ATTR_MAX, MemoryImage::MAX_ADDRESS_WIDTH);
+
+    wxPGProperty* widthProp = propGrid->Append(new wxIntProperty("Data Width", "data_width",
+                                                                 currentComponent->GetDataWidth()));
+    widthProp->SetAttribute(wxPG_ATTR_MIN, BusComponent::MIN_WIDTH);
+    widthProp->SetAttribute(wxPG_ATTR_MAX, BusComponent::MAX_WIDTH);
+
+    // Same restriction as for the bus components, and a resize clears the contents
+    const auto& pins = currentComponent->GetPins();
+    bool connected = std::any_of(pins.begin(), pins.end(), [](const Pin& pin) { return pin.isConnected; });
+    if (connected) {
+        propGrid->SetPropertyReadOnly("address_width");
+        propGrid->SetPropertyReadOnly("data_width");
+        propGrid->SetPropertyHelpString("address_width", "Disconnect all wires to change the size");
+        propGrid->SetPropertyHelpString("data_width", "Disconnect all wires to change the size");
+    }
+
+    wxString wildcard = "Hex images (*.hex;*.txt)|*.hex;*.txt|Binary images (*.bin)|*.bin|All files (*.*)|*.*";
+    wxPGProperty* contentsProp = propGrid->Append(new wxFileProperty("Contents File", "contents_file",
+                                                                     memory->GetSourcePath()));
+    contentsProp->SetAttribute(wxPG_FILE_WILDCARD, wildcard);
+    propGrid->SetPropertyHelpString("contents_file", memory->IsMapped() ? "Mapped from the file"
+                                                                        : "Hex words or raw binary, by extension");
+
+    wxPGProperty* dumpProp = propGrid->Append(new wxFileProperty("Dump Contents To", "dump_file", wxEmptyString));
+    dumpProp->SetAttribute(wxPG_FILE_WILDCARD, wildcard);
+    dumpProp->SetAttribute(wxPG_FILE_DIALOG_STYLE, wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+}
+
+void PropertiesPanel::PopulateTimingProperties() {
+    // Sources, sinks and wires switch instantly
+    PropagationDelay typeDelay = CircuitComponent::GetDefaultDelay(currentComponent->GetType());
+    if (typeDelay.rise == 0 && typeDelay.fall == 0 && !currentComponent->HasCustomDelay()) return;
+
+    propGrid->Append(new wxPropertyCategory("Timing"));
+
+    PropagationDelay delay = currentComponent->GetDelay();
+    wxPGProperty* riseProp = propGrid->Append(new wxIntProperty("Rise Delay", "rise_delay", delay.rise));
+    riseProp->SetAttribute(wxPG_ATTR_MIN, 0);
+    wxPGProperty* fallProp = propGrid->Append(new wxIntProperty("Fall Delay", "fall_delay", delay.fall));
+    fallProp->SetAttribute(wxPG_ATTR_MIN, 0);
+    propGrid->Append(new wxBoolProperty("Type Default Delay", "default_delay", !currentComponent->HasCustomDelay()));
+    propGrid->SetPropertyAttribute("default_delay", wxPG_BOOL_USE_CHECKBOX, true);
+
+    wxString help = wxString::Format("Time units in timed simulation, the type default is %u/%u",
+                                     typeDelay.rise, typeDelay.fall);
+    propGrid->SetPropertyHelpString("rise_delay", help);
+    propGrid->SetPropertyHelpString("fall_delay", help);
+}
+
 void PropertiesPanel::PopulateDefaultProperties() {
     // Default properties for other components with requested attributes
 
@@ -1028,7 +1138,7 @@ void PropertiesPanel::SetupComponentProperties() {
             propGrid->SetPropertyReadOnly("logic_function");
 
             if (type != ComponentType::NOT_GATE) {
-                propGrid->Append(new wxIntProperty("Input Count", "input_count", 2));
+                propGrid->Append(new wxIntProperty("Input Count", "input_count", currentComponent->GetInputCount()));
                 propGrid->SetPropertyReadOnly("input_count");
             }
             break;
@@ -1081,6 +1191,96 @@ void PropertiesPanel::OnPropertyChanged(wxPropertyGridEvent& event) {
         GetParent()->Refresh();
     }
 
+    // Handle label changes for named inputs and outputs
+    if (name == "label") {
+        wxString label = propGrid->GetPropertyValue("label").GetString();
+        if (auto inputSwitch = dynamic_cast<InputSwitch*>(currentComponent)) {
+            inputSwitch->SetLabel(label);
+        } else if (auto outputLED = dynamic_cast<OutputLED*>(currentComponent)) {
+            outputLED->SetLabel(label);
+        }
+        GetParent()->Refresh();
+    }
+
+    // Handle bus width changes; the pins are recreated so the circuit must be recompiled
+    if (name == "data_width") {
+        NotifyComponentChanging();
+        currentComponent->SetDataWidth(propGrid->GetPropertyValue("data_width").GetLong());
+
+        wxCommandEvent changedEvent(wxEVT_COMPONENT_CHANGED, GetId());
+        changedEvent.SetEventObject(this);
+        changedEvent.SetClientData(currentComponent);
+        ProcessEvent(changedEvent);
+
+        PopulateProperties();
+        GetParent()->Refresh();
+    }
+
+    // Handle gate input count changes; the pins are recreated as for bus widths
+    if (name == "input_count") {
+        NotifyComponentChanging();
+        currentComponent->SetInputCount(propGrid->GetPropertyValue("input_count").GetLong());
+
+        wxCommandEvent changedEvent(wxEVT_COMPONENT_CHANGED, GetId());
+        changedEvent.SetEventObject(this);
+        changedEvent.SetClientData(currentComponent);
+        ProcessEvent(changedEvent);
+
+        PopulateProperties();
+        GetParent()->Refresh();
+    }
+
+    // Handle memory size and contents changes
+    if (name == "address_width" || name == "contents_file") {
+        NotifyComponentChanging();
+        if (name == "address_width") {
+            currentComponent->SetAddressWidth(propGrid->GetPropertyValue("address_width").GetLong());
+        } else {
+            MemoryImage* memory = currentComponent->GetMemory();
+            wxString path = propGrid->GetPropertyValue("contents_file").GetString();
+            if (path.empty()) {
+                memory->Clear();
+            } else if (!memory->LoadFromFile(path)) {
+                wxMessageBox(memory->GetLastError(), "Load Memory Contents", wxOK | wxICON_ERROR, this);
+            }
+        }
+
+        wxCommandEvent changedEvent(wxEVT_COMPONENT_CHANGED, GetId());
+        changedEvent.SetEventObject(this);
+        changedEvent.SetClientData(currentComponent);
+        ProcessEvent(changedEvent);
+
+        PopulateProperties();
+        GetParent()->Refresh();
+    }
+
+    // Handle delay changes; nodes copy their delay when the circuit is compiled
+    if (name == "rise_delay" || name == "fall_delay" || name == "default_delay") {
+        if (name == "default_delay" && propGrid->GetPropertyValue("default_delay").GetBool()) {
+            currentComponent->ResetDelay();
+        } else {
+            long rise = std::max(0L, propGrid->GetPropertyValue("rise_delay").GetLong());
+            long fall = std::max(0L, propGrid->GetPropertyValue("fall_delay").GetLong());
+            currentComponent->SetDelay(PropagationDelay{ static_cast<uint32_t>(rise), static_cast<uint32_t>(fall) });
+        }
+
+        wxCommandEvent changedEvent(wxEVT_COMPONENT_CHANGED, GetId());
+        changedEvent.SetEventObject(this);
+        changedEvent.SetClientData(currentComponent);
+        ProcessEvent(changedEvent);
+
+        PopulateProperties();
+    }
+
+    if (name == "dump_file") {
+        MemoryImage* memory = currentComponent->GetMemory();
+        wxString path = propGrid->GetPropertyValue("dump_file").GetString();
+        if (!path.empty() && !memory->SaveToFile(path)) {
+            wxMessageBox(memory->GetLastError(), "Dump Memory Contents", wxOK | wxICON_ERROR, this);
+        }
+        propGrid->SetPropertyValue("dump_file", wxEmptyString);
+    }
+
     // Handle other property changes as needed
     // This can be extended for more interactive properties
 }
@@ -1121,6 +1321,26 @@ wxString PropertiesPanel::GetComponentName() const {
         case ComponentType::DECODER_3TO8: return "3:8 Decoder";
         case ComponentType::BCD_TO_7SEGMENT: return "BCD to 7-Segment";
         case ComponentType::PRIORITY_ENCODER: return "Priority Encoder";
+        case ComponentType::BUS_SPLITTER: return "Bus Splitter";
+        case ComponentType::BUS_JOINER: return "Bus Joiner";
+        case ComponentType::BUS_ADDER: return "N-bit Adder";
+        case ComponentType::BUS_MULTIPLEXER_4TO1: return "N-bit 4:1 MUX";
+        case ComponentType::BUS_REGISTER: return "N-bit Register";
+        case ComponentType::BUS_COMPARATOR: return "N-bit Comparator";
+        case ComponentType::BUS_SUBTRACTOR: return "N-bit Subtractor";
+        case ComponentType::BUS_MULTIPLIER: return "N-bit Multiplier";
+        case ComponentType::BUS_SHIFTER: return "N-bit Shifter";
+        case ComponentType::BUS_ALU: return "N-bit ALU";
+        case ComponentType::RAM: return "RAM";
+        case ComponentType::ROM: return "ROM";
         default: return "Component";
     }
-}
\ No newline at end of file
+}
+
+void PropertiesPanel::NotifyComponentChanging() {
+    // Lets the owner pause a running simulation before the pins go away
+    wxCommandEvent changingEvent(wxEVT_COMPONENT_CHANGING, GetId());
+    changingEvent.SetEventObject(this);
+    changingEvent.SetClientData(currentComponent);
+    ProcessEvent(changingEvent);
+}
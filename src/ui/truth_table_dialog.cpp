@@ -0,0 +1,58 @@
+#include "../../include/ui/truth_table_dialog.h"
+
+TruthTableListCtrl::TruthTableListCtrl(wxWindow* parent, const TruthTable& truthTable)
+    : wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxSize(480, 360),
+                 wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL),
+      table(truthTable) {
+
+    for (size_t c = 0; c < table.GetColumnCount(); ++c) {
+        InsertColumn(static_cast<long>(c), table.GetColumnName(c), wxLIST_FORMAT_LEFT, 60);
+    }
+    SetItemCount(static_cast<long>(table.GetRowCount()));
+}
+
+wxString TruthTableListCtrl::OnGetItemText(long item, long column) const {
+    return table.GetCellText(static_cast<size_t>(item), static_cast<size_t>(column));
+}
+
+wxBEGIN_EVENT_TABLE(TruthTableDialog, wxDialog)
+    EVT_BUTTON(ID_TRUTH_TABLE_SAVE_CSV, TruthTableDialog::OnSaveCSV)
+wxEND_EVENT_TABLE()
+
+TruthTableDialog::TruthTableDialog(wxWindow* parent, const TruthTable& truthTable)
+    : wxDialog(parent, wxID_ANY, "Truth Table", wxDefaultPosition, wxDefaultSize,
+               wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      table(truthTable) {
+
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    wxStaticText* summary = new wxStaticText(this, wxID_ANY,
+        wxString::Format("%zu input(s), %zu output(s), %zu row(s)",
+                         table.GetInputCount(), table.GetOutputCount(), table.GetRowCount()));
+    summary->SetFont(wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    sizer->Add(summary, 0, wxALL, 5);
+
+    sizer->Add(new TruthTableListCtrl(this, table), 1, wxLEFT | wxRIGHT | wxEXPAND, 5);
+
+    wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
+    buttonSizer->Add(new wxButton(this, ID_TRUTH_TABLE_SAVE_CSV, "Save CSV..."), 0, wxALL, 5);
+    buttonSizer->AddStretchSpacer();
+    buttonSizer->Add(new wxButton(this, wxID_OK, "Close"), 0, wxALL, 5);
+    sizer->Add(buttonSizer, 0, wxEXPAND);
+
+    SetSizerAndFit(sizer);
+}
+
+void TruthTableDialog::OnSaveCSV(wxCommandEvent& event) {
+    wxFileDialog saveDialog(this, "Save Truth Table", "", "truth_table.csv",
+                            "CSV files (*.csv)|*.csv|All files (*.*)|*.*",
+                            wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+    if (saveDialog.ShowModal() != wxID_OK) {
+        return;
+    }
+
+    wxBusyCursor busy;
+    if (!table.SaveCSV(saveDialog.GetPath())) {
+        wxMessageBox("Failed to write " + saveDialog.GetPath(), "Error", wxOK | wxICON_ERROR);
+    }
+}
@@ -0,0 +1,399 @@
+#include "../../include/ui/waveform_panel.h"
+#include <wx/dcbuffer.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace {
+    // Most zoomed-in view: 32 pixels per cycle
+    const double MIN_CYCLES_PER_PIXEL = 1.0 / 32.0;
+    const double ZOOM_STEP = 1.5;
+}
+
+wxBEGIN_EVENT_TABLE(WaveformPanel, wxPanel)
+    EVT_BUTTON(ID_WAVE_ZOOM_IN, WaveformPanel::OnZoomInButton)
+    EVT_BUTTON(ID_WAVE_ZOOM_OUT, WaveformPanel::OnZoomOutButton)
+    EVT_BUTTON(ID_WAVE_ZOOM_FIT, WaveformPanel::OnZoomFitButton)
+    EVT_BUTTON(ID_WAVE_CLEAR, WaveformPanel::OnClearButton)
+    EVT_COMMAND_SCROLL(ID_WAVE_SCROLL, WaveformPanel::OnScroll)
+wxEND_EVENT_TABLE()
+
+WaveformPanel::WaveformPanel(wxWindow* parent)
+    : wxPanel(parent, wxID_ANY),
+      recorder(nullptr),
+      viewStart(0.0),
+      cyclesPerPixel(0.1),
+      followLatest(true),
+      scrollUnit(1),
+      lastRevision(0),
+      isPanning(false),
+      lastPanX(0) {
+
+    // Set background color
+    SetBackgroundColour(wxColour(245, 245, 245));
+
+    // Create sizer
+    wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
+
+    // Title and view buttons
+    wxBoxSizer* headerSizer = new wxBoxSizer(wxHORIZONTAL);
+    titleLabel = new wxStaticText(this, wxID_ANY, "Waveform");
+    titleLabel->SetFont(wxFont(10, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    headerSizer->Add(titleLabel, 1, wxALIGN_CENTER_VERTICAL | wxALL, 5);
+    headerSizer->Add(new wxButton(this, ID_WAVE_ZOOM_IN, "+", wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT), 0, wxALL, 2);
+    headerSizer->Add(new wxButton(this, ID_WAVE_ZOOM_OUT, "-", wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT), 0, wxALL, 2);
+    headerSizer->Add(new wxButton(this, ID_WAVE_ZOOM_FIT, "Fit", wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT), 0, wxALL, 2);
+    headerSizer->Add(new wxButton(this, ID_WAVE_CLEAR, "Clear", wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT), 0, wxALL, 2);
+    sizer->Add(headerSizer, 0, wxEXPAND);
+
+    // Trace drawing area
+    traceArea = new wxWindow(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxFULL_REPAINT_ON_RESIZE);
+    traceArea->SetBackgroundStyle(wxBG_STYLE_PAINT);
+    traceArea->Bind(wxEVT_PAINT, &WaveformPanel::OnPaintTraces, this);
+    traceArea->Bind(wxEVT_SIZE, &WaveformPanel::OnTraceSize, this);
+    traceArea->Bind(wxEVT_MOUSEWHEEL, &WaveformPanel::OnTraceMouseWheel, this);
+    traceArea->Bind(wxEVT_LEFT_DOWN, &WaveformPanel::OnTraceLeftDown, this);
+    traceArea->Bind(wxEVT_LEFT_UP, &WaveformPanel::OnTraceLeftUp, this);
+    traceArea->Bind(wxEVT_MOTION, &WaveformPanel::OnTraceMouseMove, this);
+    traceArea->Bind(wxEVT_RIGHT_DOWN, &WaveformPanel::OnTraceRightDown, this);
+    sizer->Add(traceArea, 1, wxLEFT | wxRIGHT | wxEXPAND, 5);
+
+    // Time axis scrollbar
+    timeScrollBar = new wxScrollBar(this, ID_WAVE_SCROLL, wxDefaultPosition, wxDefaultSize, wxSB_HORIZONTAL);
+    sizer->Add(timeScrollBar, 0, wxALL | wxEXPAND, 5);
+
+    SetSizer(sizer);
+    UpdateScrollBar();
+}
+
+void WaveformPanel::SetRecorder(WaveformRecorder* rec) {
+    recorder = rec;
+    lastRevision = 0;
+    RefreshTraces();
+}
+
+void WaveformPanel::RefreshTraces() {
+    if (!recorder || recorder->GetRevision() == lastRevision) return;
+    lastRevision = recorder->GetRevision();
+
+    // Keep the newest samples on screen unless the user scrolled away
+    if (followLatest) {
+        double endTime = static_cast<double>(recorder->GetEndTime());
+        viewStart = std::max(0.0, endTime - GetVisibleCycles());
+    }
+
+    ClampView();
+    UpdateScrollBar();
+    traceArea->Refresh(false);
+}
+
+// View control methods
+void WaveformPanel::ZoomIn() {
+    ZoomAround(1.0 / ZOOM_STEP, GetPlotWidth() / 2);
+}
+
+void WaveformPanel::ZoomOut() {
+    ZoomAround(ZOOM_STEP, GetPlotWidth() / 2);
+}
+
+void WaveformPanel::ZoomToFit() {
+    uint64_t endTime = recorder ? recorder->GetEndTime() : 0;
+    int plotWidth = std::max(1, GetPlotWidth());
+
+    cyclesPerPixel = std::max(MIN_CYCLES_PER_PIXEL, static_cast<double>(endTime) / plotWidth);
+    viewStart = 0.0;
+    followLatest = true;
+
+    UpdateScrollBar();
+    traceArea->Refresh(false);
+}
+
+// Event handlers
+void WaveformPanel::OnPaintTraces(wxPaintEvent& event) {
+    wxAutoBufferedPaintDC dc(traceArea);
+
+    dc.SetBackground(wxBrush(wxColour(255, 255, 255)));
+    dc.Clear();
+
+    int width = traceArea->GetClientSize().x;
+    int height = traceArea->GetClientSize().y;
+
+    // Name column background
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(wxColour(245, 245, 245)));
+    dc.DrawRectangle(0, 0, NAME_COLUMN_WIDTH, height);
+
+    dc.SetFont(wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+
+    // A running simulation appends to the traces from its worker
+    std::unique_lock<std::mutex> lock;
+    if (recorder) lock = std::unique_lock<std::mutex>(recorder->GetMutex());
+
+    if (!recorder || recorder->GetTraces().empty()) {
+        dc.SetTextForeground(wxColour(128, 128, 128));
+        dc.DrawText("Select a component and use Simulation > Add to Waveform",
+                    NAME_COLUMN_WIDTH + 10, AXIS_HEIGHT + 10);
+        return;
+    }
+
+    DrawTimeAxis(dc, width);
+
+    // Only rows inside the client area are drawn
+    const auto& traces = recorder->GetTraces();
+    for (size_t i = 0; i < traces.size(); ++i) {
+        int top = AXIS_HEIGHT + static_cast<int>(i) * ROW_HEIGHT;
+        if (top >= height) break;
+        DrawTrace(dc, traces[i], top, width);
+    }
+}
+
+void WaveformPanel::OnTraceSize(wxSizeEvent& event) {
+    ClampView();
+    UpdateScrollBar();
+    event.Skip();
+}
+
+void WaveformPanel::OnTraceMouseWheel(wxMouseEvent& event) {
+    int plotX = std::max(0, event.GetPosition().x - NAME_COLUMN_WIDTH);
+
+    if (event.GetWheelRotation() > 0) {
+        ZoomAround(1.0 / ZOOM_STEP, plotX);
+    } else {
+        ZoomAround(ZOOM_STEP, plotX);
+    }
+}
+
+void WaveformPanel::OnTraceLeftDown(wxMouseEvent& event) {
+    isPanning = true;
+    lastPanX = event.GetPosition().x;
+    traceArea->CaptureMouse();
+    traceArea->SetCursor(wxCursor(wxCURSOR_SIZEWE));
+}
+
+void WaveformPanel::OnTraceLeftUp(wxMouseEvent& event) {
+    if (traceArea->HasCapture()) {
+        traceArea->ReleaseMouse();
+    }
+    isPanning = false;
+    traceArea->SetCursor(wxCursor(wxCURSOR_DEFAULT));
+}
+
+void WaveformPanel::OnTraceMouseMove(wxMouseEvent& event) {
+    if (!isPanning) return;
+
+    int x = event.GetPosition().x;
+    viewStart -= (x - lastPanX) * cyclesPerPixel;
+    lastPanX = x;
+
+    ClampView();
+    UpdateScrollBar();
+    traceArea->Refresh(false);
+}
+
+void WaveformPanel::OnTraceRightDown(wxMouseEvent& event) {
+    // Right-click on a trace name removes that probe
+    wxPoint pos = event.GetPosition();
+    if (!recorder || pos.x >= NAME_COLUMN_WIDTH || pos.y < AXIS_HEIGHT) return;
+
+    // RemoveProbe ignores rows past the end
+    size_t row = static_cast<size_t>((pos.y - AXIS_HEIGHT) / ROW_HEIGHT);
+    recorder->RemoveProbe(row);
+    RefreshTraces();
+}
+
+void WaveformPanel::OnScroll(wxScrollEvent& event) {
+    viewStart = static_cast<double>(static_cast<uint64_t>(event.GetPosition()) * scrollUnit);
+    ClampView();
+    traceArea->Refresh(false);
+}
+
+void WaveformPanel::OnZoomInButton(wxCommandEvent& event) {
+    ZoomIn();
+}
+
+void WaveformPanel::OnZoomOutButton(wxCommandEvent& event) {
+    ZoomOut();
+}
+
+void WaveformPanel::OnZoomFitButton(wxCommandEvent& event) {
+    ZoomToFit();
+}
+
+void WaveformPanel::OnClearButton(wxCommandEvent& event) {
+    if (recorder) {
+        recorder->ClearSamples();
+        viewStart = 0.0;
+        followLatest = true;
+        RefreshTraces();
+    }
+}
+
+// Drawing helper methods
+void WaveformPanel::DrawTimeAxis(wxDC& dc, int width) {
+    dc.SetPen(wxPen(wxColour(180, 180, 180), 1));
+    dc.DrawLine(0, AXIS_HEIGHT - 1, width, AXIS_HEIGHT - 1);
+
+    // Pick a 1/2/5 tick spacing of roughly 100 pixels
+    double target = std::max(1.0, 100.0 * cyclesPerPixel);
+    double magnitude = std::pow(10.0, std::floor(std::log10(target)));
+    double step = magnitude * 10.0;
+    for (double multiple : {1.0, 2.0, 5.0}) {
+        if (multiple * magnitude >= target) {
+            step = multiple * magnitude;
+            break;
+        }
+    }
+
+    dc.SetTextForeground(wxColour(100, 100, 100));
+    uint64_t tickStep = static_cast<uint64_t>(step);
+    uint64_t tick = static_cast<uint64_t>(std::ceil(viewStart / step)) * tickStep;
+
+    for (;; tick += tickStep) {
+        int x = NAME_COLUMN_WIDTH + static_cast<int>((tick - viewStart) / cyclesPerPixel);
+        if (x >= width) break;
+
+        dc.DrawLine(x, AXIS_HEIGHT - 5, x, AXIS_HEIGHT - 1);
+        dc.DrawText(wxString::Format("%llu", static_cast<unsigned long long>(tick)), x + 2, 2);
+    }
+}
+
+void WaveformPanel::DrawTrace(wxDC& dc, const WaveformTrace& trace, int top, int width) {
+    int plotLeft = NAME_COLUMN_WIDTH;
+    int plotWidth = width - plotLeft;
+
+    // Trace name and row separator
+    dc.SetTextForeground(*wxBLACK);
+    dc.DrawText(trace.name, 5, top + 7);
+    dc.SetPen(wxPen(wxColour(230, 230, 230), 1));
+    dc.DrawLine(0, top + ROW_HEIGHT - 1, width, top + ROW_HEIGHT - 1);
+
+    if (plotWidth <= 0 || trace.times.empty()) return;
+
+    int yHigh = top + 5;
+    int yLow = top + ROW_HEIGHT - 6;
+    int yMid = (yHigh + yLow) / 2;
+    bool isBus = trace.width > 1;
+    auto levelY = [=](const BusValue& value) {
+        return (value.undefined & 1) ? yMid : (value.bits & 1) ? yHigh : yLow;
+    };
+
+    wxPen levelPen(wxColour(0, 140, 0), 2);
+    wxPen undefinedPen(wxColour(200, 0, 0), 2);
+    wxPen busyPen(wxColour(0, 140, 0), 1);
+
+    // A single line is drawn at its level; a bus as a band labelled with
+    // its value in hex where the segment is wide enough, or as a red line
+    // while any of its lines is undefined
+    auto drawSegment = [&](int x0, int x1, const BusValue& value) {
+        if (!isBus) {
+            dc.SetPen((value.undefined & 1) ? undefinedPen : levelPen);
+            dc.DrawLine(x0, levelY(value), x1, levelY(value));
+            return;
+        }
+        if (value.undefined & BusMask(trace.width)) {
+            dc.SetPen(undefinedPen);
+            dc.DrawLine(x0, yMid, x1, yMid);
+            return;
+        }
+        dc.SetPen(busyPen);
+        dc.DrawLine(x0, yHigh, x1, yHigh);
+        dc.DrawLine(x0, yLow, x1, yLow);
+        if (x1 - x0 > 12) {
+            wxString text = wxString::Format("%llX", static_cast<unsigned long long>(value.bits));
+            wxSize extent = dc.GetTextExtent(text);
+            if (extent.x < x1 - x0 - 4) {
+                dc.SetTextForeground(wxColour(0, 100, 0));
+                dc.DrawText(text, x0 + 3, yMid - extent.y / 2);
+            }
+        }
+    };
+
+    uint64_t endTime = recorder->GetEndTime();
+    uint64_t firstCycle = ColumnBoundary(0);
+    BusValue current = { 0, BusMask(trace.width) };
+    if (firstCycle > 0) current = trace.ValueAt(firstCycle - 1);
+    size_t index = trace.LowerBound(firstCycle);
+    int segmentStart = plotLeft;
+
+    // Each column is reduced to "no change", one edge, or a busy bar
+    for (int column = 0; column < plotWidth && ColumnBoundary(column) < endTime; ++column) {
+        size_t next = trace.LowerBound(ColumnBoundary(column + 1), index);
+        if (next == index) continue;
+
+        int x = plotLeft + column;
+        BusValue newValue = trace.values[next - 1];
+
+        // Close the steady segment that ends here
+        drawSegment(segmentStart, x, current);
+
+        if (next - index == 1 && !isBus) {
+            dc.SetPen(levelPen);
+            dc.DrawLine(x, levelY(current), x, levelY(newValue));
+        } else {
+            // A bus changing value, or several transitions in this pixel column
+            dc.SetPen(busyPen);
+            dc.DrawLine(x, yHigh, x, yLow + 1);
+        }
+
+        current = newValue;
+        segmentStart = x;
+        index = next;
+    }
+
+    // Final steady segment up to the last recorded cycle
+    double endOffset = (static_cast<double>(endTime) - viewStart) / cyclesPerPixel;
+    int endX = plotLeft + static_cast<int>(std::min(static_cast<double>(plotWidth), endOffset));
+    if (endX > segmentStart) {
+        drawSegment(segmentStart, endX, current);
+    }
+}
+
+// View helper methods
+void WaveformPanel::ZoomAround(double factor, int plotX) {
+    double anchorCycle = viewStart + plotX * cyclesPerPixel;
+
+    uint64_t endTime = recorder ? recorder->GetEndTime() : 0;
+    double maxCyclesPerPixel = std::max(1.0, static_cast<double>(endTime) / std::max(1, GetPlotWidth()));
+    cyclesPerPixel = std::max(MIN_CYCLES_PER_PIXEL, std::min(maxCyclesPerPixel, cyclesPerPixel * factor));
+
+    // Keep the cycle under the cursor in place
+    viewStart = anchorCycle - plotX * cyclesPerPixel;
+
+    ClampView();
+    UpdateScrollBar();
+    traceArea->Refresh(false);
+}
+
+void WaveformPanel::ClampView() {
+    double endTime = recorder ? static_cast<double>(recorder->GetEndTime()) : 0.0;
+    double maxStart = std::max(0.0, endTime - GetVisibleCycles());
+
+    viewStart = std::max(0.0, std::min(maxStart, viewStart));
+    followLatest = viewStart >= maxStart;
+}
+
+void WaveformPanel::UpdateScrollBar() {
+    uint64_t endTime = recorder ? recorder->GetEndTime() : 0;
+    uint64_t visible = static_cast<uint64_t>(GetVisibleCycles());
+    uint64_t total = std::max(endTime, visible);
+
+    // Scrollbars take int positions, so very long runs scroll in coarser units
+    scrollUnit = std::max<uint64_t>(1, total / 1000000);
+
+    int range = static_cast<int>(total / scrollUnit) + 1;
+    int thumb = std::max(1, static_cast<int>(visible / scrollUnit));
+    int position = static_cast<int>(static_cast<uint64_t>(viewStart) / scrollUnit);
+    timeScrollBar->SetScrollbar(position, thumb, range, thumb);
+}
+
+int WaveformPanel::GetPlotWidth() const {
+    return std::max(0, traceArea->GetClientSize().x - NAME_COLUMN_WIDTH);
+}
+
+double WaveformPanel::GetVisibleCycles() const {
+    return GetPlotWidth() * cyclesPerPixel;
+}
+
+uint64_t WaveformPanel::ColumnBoundary(int column) const {
+    return static_cast<uint64_t>(std::ceil(viewStart + column * cyclesPerPixel));
+}